@@ -0,0 +1,21 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+// 把 body 重复 iterations 次，打印每次的平均耗时。
+// body 的返回值累加后打印出来，防止编译器把整个循环优化掉。
+template <typename Body>
+double RunBench(const char* name, uint64_t iterations, Body&& body)
+{
+    uint64_t sink = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; i++) {
+        sink += static_cast<uint64_t>(body(i));
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double nanoseconds = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    std::printf("%-48s %10.1f ns/op  (%llu ops, sink %llu)\n",
+        name, nanoseconds, static_cast<unsigned long long>(iterations), static_cast<unsigned long long>(sink));
+    return nanoseconds;
+}
@@ -0,0 +1,68 @@
+// ParallelCommandRecorderBench.cpp
+#include "ParallelCommandRecorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include "FakeD3D12.h"
+#include "MockGpuTimeline.h"
+
+namespace {
+const size_t DRAW_COUNT = 100000;
+const size_t MIN_DRAWS_PER_CHUNK = 256;
+const uint32_t FRAMES = 50;
+
+// 和 Renderer 的每个绘制一样：两个根常量（绘制数据下标）+ 一次 DrawInstanced
+void RecordDraws(ID3D12GraphicsCommandList* list, size_t first, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        const uint32_t rootConstants[2] = { 0, static_cast<uint32_t>(first + i) };
+        list->SetGraphicsRoot32BitConstants(1, 2, rootConstants, 0);
+        list->DrawInstanced(3, 1, 0, 0);
+    }
+}
+
+// 录制吞吐量随线程数的变化。模拟命令列表只把命令写进内存，测的是分块、池化和线程调度的开销，
+// 加上和真实驱动同数量级的每个绘制的写入量；GPU 永远跟得上，分配器归还后马上可以复用
+void BenchRecording(unsigned workerThreads)
+{
+    Microsoft::WRL::ComPtr<ID3D12Device> device;
+    device.Attach(new FakeDevice());
+    MockGpuTimeline timeline(true);
+    CommandListPool pool(device.Get());
+    pool.SetTimeline(D3D12_COMMAND_LIST_TYPE_DIRECT, &timeline);
+    WorkerPool workers(workerThreads);
+    ParallelCommandRecorder recorder(pool, workers);
+
+    const auto recordFrame = [&]() {
+        std::pmr::vector<CommandContext> contexts = recorder.Record(
+            DRAW_COUNT, MIN_DRAWS_PER_CHUNK, nullptr,
+            [](ID3D12GraphicsCommandList* list, size_t, size_t first, size_t count) { RecordDraws(list, first, count); });
+        const uint64_t fenceValue = timeline.Signal();
+        for (CommandContext& context : contexts) {
+            pool.Release(context, fenceValue);
+        }
+    };
+
+    // 第一帧创建命令列表和分配器，不计时
+    recordFrame();
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < FRAMES; frame++) {
+        recordFrame();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%2u worker(s) + caller, %2zu chunks %16s %10.2f M draws/s  (%.2f ms/frame)\n",
+        workers.GetThreadCount(), recorder.GetLastChunkCount(), "",
+        DRAW_COUNT * FRAMES / seconds / 1e6, seconds * 1e3 / FRAMES);
+}
+}
+
+int main()
+{
+    const unsigned hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("%zu draws per frame, %u hardware threads\n", DRAW_COUNT, hardwareThreads);
+    for (unsigned workerThreads = 1; workerThreads <= hardwareThreads; workerThreads++) {
+        BenchRecording(workerThreads);
+    }
+    return 0;
+}
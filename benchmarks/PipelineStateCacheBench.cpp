@@ -0,0 +1,126 @@
+// PipelineStateCacheBench.cpp
+#include "PipelineStateCache.h"
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "BenchCommon.h"
+#include "FakeD3D12.h"
+
+namespace {
+// 测的是缓存本身的开销，不含驱动编译 PSO 的时间
+class FakePipelineStateCreator : public IPipelineStateCreator {
+public:
+    HRESULT CreateGraphicsPipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC&, ID3D12PipelineState** pipeline) override
+    {
+        *pipeline = new FakePipelineState();
+        return S_OK;
+    }
+};
+
+const uint32_t DESC_COUNT = 256;
+
+// 和三角形的 PSO 差不多大小的描述，光栅化的深度偏移不同，互不相同
+struct DescSet {
+    std::vector<uint8_t> vertexShader = std::vector<uint8_t>(3000);
+    std::vector<uint8_t> pixelShader = std::vector<uint8_t>(1500);
+    D3D12_INPUT_ELEMENT_DESC layout[2] = {
+        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+    };
+    std::vector<D3D12_GRAPHICS_PIPELINE_STATE_DESC> descs;
+
+    explicit DescSet(bool dxbcDigest)
+    {
+        for (size_t i = 0; i < vertexShader.size(); i++) {
+            vertexShader[i] = static_cast<uint8_t>(i * 7);
+        }
+        for (size_t i = 0; i < pixelShader.size(); i++) {
+            pixelShader[i] = static_cast<uint8_t>(i * 13);
+        }
+        // 带摘要的 DXBC 容器头；不带时缓存要哈希整段字节码
+        if (dxbcDigest) {
+            std::memcpy(vertexShader.data(), "DXBC", 4);
+            std::memcpy(pixelShader.data(), "DXBC", 4);
+        }
+
+        descs.resize(DESC_COUNT);
+        for (uint32_t i = 0; i < DESC_COUNT; i++) {
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = {};
+            desc.InputLayout = { layout, 2 };
+            desc.VS = { vertexShader.data(), vertexShader.size() };
+            desc.PS = { pixelShader.data(), pixelShader.size() };
+            desc.SampleMask = UINT_MAX;
+            desc.RasterizerState.DepthBias = static_cast<INT>(i);
+            desc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+            desc.NumRenderTargets = 1;
+            desc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+            desc.SampleDesc.Count = 1;
+            descs[i] = desc;
+        }
+    }
+};
+
+void BenchKey(const char* name, const DescSet& set)
+{
+    std::vector<uint8_t> key;
+    RunBench(name, 200000, [&](uint64_t i) {
+        PipelineStateCache::BuildKey(set.descs[i % DESC_COUNT], key);
+        return PipelineStateCache::HashKey(key);
+    });
+}
+
+void BenchMissAndHit(const DescSet& set)
+{
+    FakePipelineStateCreator creator;
+    // 每轮用一个新缓存，所有查找都未命中（包括扩容）
+    std::vector<std::unique_ptr<PipelineStateCache>> caches;
+    const uint64_t rounds = 200;
+    for (uint64_t i = 0; i < rounds; i++) {
+        caches.push_back(std::make_unique<PipelineStateCache>(creator));
+    }
+    RunBench("miss (fake creator)", rounds * DESC_COUNT, [&](uint64_t i) {
+        return reinterpret_cast<uintptr_t>(caches[i / DESC_COUNT]->GetOrCreate(set.descs[i % DESC_COUNT]));
+    });
+
+    PipelineStateCache& cache = *caches.front();
+    RunBench("hit, 1 thread", 1000000, [&](uint64_t i) {
+        return reinterpret_cast<uintptr_t>(cache.GetOrCreate(set.descs[i % DESC_COUNT]));
+    });
+
+    // 多个线程同时命中：查找不加锁，吞吐量应该随线程数增长
+    const uint32_t lookupsPerThread = 200000;
+    for (uint32_t threadCount : { 1u, 2u, 4u, 8u }) {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < threadCount; t++) {
+            threads.emplace_back([&, t]() {
+                for (uint32_t i = 0; i < lookupsPerThread; i++) {
+                    cache.GetOrCreate(set.descs[(i + t) % DESC_COUNT]);
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("hit, %u threads%-32s %10.2f M lookups/s\n", threadCount, "", threadCount * lookupsPerThread / seconds / 1e6);
+    }
+
+    const PipelineStateCache::Stats stats = cache.GetStats();
+    std::printf("  lookups %llu, hits %llu, creations %llu\n", static_cast<unsigned long long>(stats.lookups),
+        static_cast<unsigned long long>(stats.hits), static_cast<unsigned long long>(stats.creations));
+}
+}
+
+int main()
+{
+    const DescSet digestShaders(true);
+    const DescSet rawShaders(false);
+    BenchKey("key + hash, DXBC digest", digestShaders);
+    BenchKey("key + hash, full bytecode hash", rawShaders);
+    BenchMissAndHit(digestShaders);
+    return 0;
+}
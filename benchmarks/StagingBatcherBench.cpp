@@ -0,0 +1,127 @@
+// StagingBatcherBench.cpp
+#include "StagingBatcher.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+const uint64_t STAGING_PAGE_SIZE = 4 * 1024 * 1024; // 和 UploadEngine 的暂存页一样大
+const uint64_t PAYLOAD_SIZE = 64;
+const size_t UPLOAD_COUNTS[] = { 1000, 10000, 100000, 1000000 };
+const size_t UPLOADS_PER_SIZE = 4000000; // 每个批大小大约做这么多次上传，小批多跑几轮
+
+// 暂存页在 CPU 内存里，按顺序分配，页放不下时换下一页；页跨批次复用
+class PageAllocator : public IStagingAllocator {
+public:
+    StagingSpan Allocate(uint64_t size) override
+    {
+        if (m_page == NO_PAGE || m_offset + size > STAGING_PAGE_SIZE) {
+            if (++m_page >= m_pages.size()) {
+                m_pages.emplace_back(STAGING_PAGE_SIZE);
+            }
+            m_offset = 0;
+        }
+        StagingSpan span;
+        span.page = static_cast<uint32_t>(m_page);
+        span.offset = m_offset;
+        span.cpuAddress = m_pages[m_page].data() + m_offset;
+        m_offset += size;
+        return span;
+    }
+
+    void Reset()
+    {
+        m_page = NO_PAGE;
+        m_offset = 0;
+    }
+
+private:
+    static const size_t NO_PAGE = static_cast<size_t>(-1);
+
+    std::vector<std::vector<uint8_t>> m_pages;
+    size_t m_page = NO_PAGE;
+    uint64_t m_offset = 0;
+};
+
+struct Uploads {
+    std::vector<uint64_t> destinations;
+    std::vector<uint64_t> offsets;
+};
+
+// 完整的打包路径：Add 把数据复制进 CPU 内存，Build 排序、写进暂存页并合并，然后 Clear
+void BenchBatch(const char* name, const Uploads& uploads)
+{
+    const size_t count = uploads.destinations.size();
+    const size_t rounds = std::max<size_t>(1, UPLOADS_PER_SIZE / count);
+    std::vector<uint8_t> payloads(count * PAYLOAD_SIZE);
+    for (size_t i = 0; i < payloads.size(); i++) {
+        payloads[i] = static_cast<uint8_t>(i);
+    }
+
+    StagingBatcher batcher;
+    PageAllocator allocator;
+    size_t copies = 0;
+    const auto runBatch = [&]() {
+        allocator.Reset();
+        for (size_t i = 0; i < count; i++) {
+            batcher.Add(uploads.destinations[i], uploads.offsets[i], payloads.data() + i * PAYLOAD_SIZE, PAYLOAD_SIZE);
+        }
+        copies = batcher.Build(allocator).size();
+        batcher.Clear();
+    };
+
+    // 第一轮分配暂存页和 CPU 缓冲区，不计时
+    runBatch();
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; round++) {
+        runBatch();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("  %-40s %8zu uploads -> %7zu copies  %8.2f M uploads/s\n",
+        name, count, copies, count * rounds / seconds / 1e6);
+}
+}
+
+int main()
+{
+    std::mt19937 random(7);
+    std::printf("%llu-byte payloads, %llu MB staging pages\n",
+        static_cast<unsigned long long>(PAYLOAD_SIZE), static_cast<unsigned long long>(STAGING_PAGE_SIZE >> 20));
+    for (size_t count : UPLOAD_COUNTS) {
+        Uploads uploads;
+        uploads.destinations.resize(count);
+        uploads.offsets.resize(count);
+
+        // 几何池追加：一个缓冲区里首尾相接的写入
+        for (size_t i = 0; i < count; i++) {
+            uploads.destinations[i] = 1;
+            uploads.offsets[i] = i * PAYLOAD_SIZE;
+        }
+        BenchBatch("appended, one buffer", uploads);
+
+        // 4 个缓冲区交替提交：排序后每个缓冲区连续写进暂存页
+        for (size_t i = 0; i < count; i++) {
+            uploads.destinations[i] = 1 + i % 4;
+            uploads.offsets[i] = (i / 4) * PAYLOAD_SIZE;
+        }
+        BenchBatch("interleaved, 4 buffers", uploads);
+
+        // 同一个缓冲区里乱序提交
+        for (size_t i = 0; i < count; i++) {
+            uploads.destinations[i] = 1;
+            uploads.offsets[i] = i * PAYLOAD_SIZE;
+        }
+        std::shuffle(uploads.offsets.begin(), uploads.offsets.end(), random);
+        BenchBatch("shuffled, one buffer", uploads);
+
+        // 同一段内存反复写：有重叠，按提交顺序逐个发出
+        for (size_t i = 0; i < count; i++) {
+            uploads.destinations[i] = 1 + random() % 16;
+            uploads.offsets[i] = (random() % 64) * (PAYLOAD_SIZE / 2);
+        }
+        BenchBatch("overlapping, 16 buffers", uploads);
+    }
+    return 0;
+}
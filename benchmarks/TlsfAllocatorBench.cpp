@@ -0,0 +1,80 @@
+// TlsfAllocatorBench.cpp
+#include "TlsfAllocator.h"
+#include <random>
+#include <vector>
+#include "BenchCommon.h"
+
+namespace {
+const uint64_t KB = 1024;
+const uint64_t MB = 1024 * KB;
+
+void BenchAllocateFreePair()
+{
+    TlsfAllocator allocator(64 * MB);
+    RunBench("allocate + free, 256B", 10000000, [&](uint64_t) {
+        TlsfAllocator::Allocation allocation = allocator.Allocate(256);
+        allocator.Free(allocation);
+        return allocation.offset;
+    });
+    RunBench("allocate + free, 64KB aligned", 10000000, [&](uint64_t) {
+        TlsfAllocator::Allocation allocation = allocator.Allocate(64 * KB, 64 * KB);
+        allocator.Free(allocation);
+        return allocation.offset;
+    });
+}
+
+void BenchAlignedFill()
+{
+    // 一个 64MB 的堆填满 64KB 对齐的缓冲区再全部释放
+    TlsfAllocator allocator(64 * MB);
+    std::vector<TlsfAllocator::Allocation> allocations(1024);
+    RunBench("fill 64MB with 64KB aligned buffers", 2000, [&](uint64_t) {
+        uint64_t count = 0;
+        for (TlsfAllocator::Allocation& allocation : allocations) {
+            allocation = allocator.Allocate(64 * KB, 64 * KB);
+            count += allocation.IsValid() ? 1 : 0;
+        }
+        for (const TlsfAllocator::Allocation& allocation : allocations) {
+            allocator.Free(allocation);
+        }
+        return count;
+    });
+}
+
+void BenchRandomMix()
+{
+    // 大小和对齐随机的分配/释放混合，保持大约 2000 个存活分配
+    TlsfAllocator allocator(256 * MB);
+    std::mt19937 random(42);
+    std::vector<TlsfAllocator::Allocation> live;
+    live.reserve(4096);
+    RunBench("random mix, 2000 live, 16B-256KB", 10000000, [&](uint64_t) {
+        if (live.size() < 2000 || random() % 2 == 0) {
+            const uint64_t size = 16 + random() % (256 * KB);
+            const uint64_t alignment = 1ull << (random() % 17);
+            TlsfAllocator::Allocation allocation = allocator.Allocate(size, alignment);
+            if (allocation.IsValid()) {
+                live.push_back(allocation);
+            }
+            return allocation.offset;
+        }
+        const size_t index = random() % live.size();
+        allocator.Free(live[index]);
+        live[index] = live.back();
+        live.pop_back();
+        return static_cast<uint64_t>(index);
+    });
+
+    const TlsfAllocator::Stats stats = allocator.GetStats();
+    std::printf("  live %u, used %.1f MB, fragmentation %.3f\n",
+        stats.allocationCount, stats.usedBytes / static_cast<double>(MB), stats.fragmentation);
+}
+}
+
+int main()
+{
+    BenchAllocateFreePair();
+    BenchAlignedFill();
+    BenchRandomMix();
+    return 0;
+}
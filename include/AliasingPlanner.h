@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// 根据生命周期把临时资源打包进堆内存。
+// 生命周期不重叠的资源可以共用同一段地址；结果里的偏移都满足各自的对齐要求。
+// heapGroup 不同的资源放在不同的堆里（比如资源堆层级 1 上缓冲区、渲染目标和其他纹理要分开），
+// 每组单独打包，偏移是在各自组的堆里的偏移。
+struct AliasingRequest {
+    uint64_t size = 0;
+    uint64_t alignment = 1;
+    uint32_t firstUse = 0; // 第一次使用的位置（含）
+    uint32_t lastUse = 0;  // 最后一次使用的位置（含）
+    uint32_t heapGroup = 0;
+};
+
+struct AliasingPlan {
+    static constexpr uint32_t NO_PREDECESSOR = 0xffffffffu;
+
+    std::vector<uint64_t> offsets;      // 与请求一一对应
+    // 与请求一一对应：这一帧里在它之前最后占用它整个地址范围的请求，没有时为 NO_PREDECESSOR
+    std::vector<uint32_t> predecessors;
+    std::vector<uint64_t> groupSizes;   // 每组打包后需要的堆大小
+    uint64_t heapSize = 0;              // 各组堆大小之和
+    uint64_t unaliasedSize = 0;         // 不做别名时各自分配的总大小
+    uint64_t peakLiveSize = 0;          // 各组同时存活的资源大小之和的最大值相加，是 heapSize 的下界
+};
+
+AliasingPlan PlanAliasing(const std::vector<AliasingRequest>& requests);
+
+inline uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    return alignment <= 1 ? value : (value + alignment - 1) / alignment * alignment;
+}
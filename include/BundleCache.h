@@ -0,0 +1,74 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <deque>
+#include <initializer_list>
+#include <unordered_map>
+#include <vector>
+#include "CommandStream.h"
+#include "GpuTimeline.h"
+
+// 静态绘制序列的 bundle 缓存。
+// 同样内容的命令流只录制一次到 D3D12_COMMAND_LIST_TYPE_BUNDLE 列表，以后用 ExecuteBundle 回放；
+// 键是命令流内容和初始 PSO 的哈希。bundle 依赖的 PSO 或缓冲区被替换时调用 Invalidate，
+// 连续 maxIdleFrames 帧没有用到的 bundle 被淘汰；两种情况下 bundle 都在 GPU 用完之后释放。
+class BundleCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t invalidations = 0;
+        uint64_t evictions = 0;
+    };
+
+    static const uint32_t DEFAULT_MAX_IDLE_FRAMES = 120;
+
+    BundleCache(ID3D12Device* device, IGpuTimeline& timeline, uint32_t maxIdleFrames = DEFAULT_MAX_IDLE_FRAMES);
+
+    // 返回与 stream 内容对应的 bundle，没有就录制一个。
+    // stream 只能包含 bundle 允许的命令（管线、根签名、拓扑、顶点/索引缓冲区、绘制）；
+    // dependencies 是 bundle 引用的对象，其中任何一个失效时 bundle 作废
+    ID3D12GraphicsCommandList* GetOrRecord(
+        const CommandStream& stream,
+        ID3D12PipelineState* initialState,
+        std::initializer_list<const void*> dependencies
+    );
+
+    // object（PSO、缓冲区……）将被替换或释放，作废所有依赖它的 bundle
+    void Invalidate(const void* object);
+
+    // 每帧开始时调用一次：淘汰太久没用的 bundle，释放 GPU 已经用完的作废 bundle
+    void BeginFrame();
+
+    size_t GetBundleCount() const { return m_entries.size(); }
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    struct Entry {
+        std::vector<uint8_t> commands; // 用于哈希冲突时比对内容
+        std::vector<const void*> dependencies;
+        Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator;
+        ID3D12PipelineState* initialState = nullptr; // 键里也有，哈希冲突时一起比对
+        uint64_t lastUsedFrame = 0;
+        Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> bundle;
+    };
+
+    struct RetiredEntry {
+        uint64_t fenceValue;
+        Entry entry;
+    };
+
+    static void ValidateBundleStream(const CommandStream& stream);
+    Entry Record(const CommandStream& stream, ID3D12PipelineState* initialState);
+    // 把条目从缓存和依赖索引里移除，retireValue 完成后释放
+    void Retire(std::unordered_multimap<uint64_t, Entry>::iterator it, uint64_t retireValue);
+
+    Microsoft::WRL::ComPtr<ID3D12Device> m_device;
+    IGpuTimeline& m_timeline;
+    uint32_t m_maxIdleFrames;
+    uint64_t m_frame = 0;
+    std::unordered_multimap<uint64_t, Entry> m_entries;
+    std::unordered_multimap<const void*, uint64_t> m_dependents; // 对象 -> 依赖它的 bundle 键
+    std::deque<RetiredEntry> m_retired;
+    Stats m_stats;
+};
@@ -0,0 +1,61 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "CompletionTracker.h"
+#include "RingQueue.h"
+
+// 一对正在录制的命令分配器和命令列表
+struct CommandContext {
+    D3D12_COMMAND_LIST_TYPE type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+    Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator;
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> list;
+};
+
+// 按命令列表类型池化的 (分配器, 命令列表) 回收器。
+// 提交后带着 fence 值归还，命令列表可以立即复用，分配器要等对应的 fence 值完成才会被重置复用；
+// 完成值由时间线的 OnCompleted 回调推进，不轮询 fence。
+// 可以在多个线程上同时 Acquire/Release。
+class CommandListPool {
+public:
+    explicit CommandListPool(ID3D12Device* device);
+
+    // 指定某种类型的命令列表提交到哪条时间线（每个队列一条）
+    void SetTimeline(D3D12_COMMAND_LIST_TYPE type, IGpuTimeline* timeline);
+
+    // 取出一个已经 Reset、可以直接录制的上下文
+    CommandContext Acquire(D3D12_COMMAND_LIST_TYPE type, ID3D12PipelineState* initialState = nullptr);
+
+    // 归还上下文；fenceValue 是包含这次提交的信号值，没有提交过的上下文传 0
+    void Release(CommandContext& context, uint64_t fenceValue);
+
+    size_t GetAllocatorCount() const;
+    size_t GetCommandListCount() const;
+
+private:
+    static const int TYPE_COUNT = 4; // DIRECT / BUNDLE / COMPUTE / COPY
+
+    struct PendingAllocator {
+        uint64_t fenceValue;
+        Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator;
+    };
+
+    struct TypePool {
+        IGpuTimeline* timeline = nullptr;
+        std::unique_ptr<CompletionTracker> completion; // 跟踪 pendingAllocators 的 fence 值
+        RingQueue<PendingAllocator> pendingAllocators; // 按 fence 值递增排列
+        std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> freeAllocators;
+        std::vector<Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>> freeLists;
+        size_t allocatorCount = 0;
+        size_t listCount = 0;
+    };
+
+    TypePool& GetPool(D3D12_COMMAND_LIST_TYPE type);
+    Microsoft::WRL::ComPtr<ID3D12CommandAllocator> AcquireAllocator(TypePool& pool, D3D12_COMMAND_LIST_TYPE type);
+
+    Microsoft::WRL::ComPtr<ID3D12Device> m_device;
+    mutable std::mutex m_mutex;
+    TypePool m_pools[TYPE_COUNT];
+};
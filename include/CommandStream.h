@@ -0,0 +1,245 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// 与图形 API 无关的紧凑二进制命令流。
+// 每条命令是一个 POD 包（CommandHeader + 参数），按 8 字节对齐线性写入同一块内存；
+// Reset 只回绕写指针、保留容量，稳定后录制不再分配内存。
+// 对象句柄（管线、根签名、资源、描述符）都以不透明的整数保存，
+// 录制端不依赖 d3d12.h，可以在无 GPU 的环境下回放到任意后端。
+
+enum class CommandOp : uint16_t {
+    SetPipeline,
+    SetRootSignature,
+    SetDescriptorHeaps,
+    SetRootDescriptorTable,
+    SetRootConstants,
+    SetPrimitiveTopology,
+    SetVertexBuffer,
+    SetIndexBuffer,
+    SetViewport,
+    SetScissor,
+    SetRenderTarget,
+    ClearRenderTarget,
+    Barrier,
+    Draw,
+    DrawIndexed,
+};
+
+struct CommandHeader {
+    CommandOp op;
+    uint16_t size; // 整个包的字节数，包含头部
+    uint32_t reserved;
+};
+
+struct CmdSetPipeline        { CommandHeader header; uint64_t pipeline; };
+struct CmdSetRootSignature   { CommandHeader header; uint64_t rootSignature; };
+struct CmdSetDescriptorHeaps { CommandHeader header; uint64_t resourceHeap; uint64_t samplerHeap; }; // 0 表示没有
+struct CmdSetRootDescriptorTable { CommandHeader header; uint64_t gpuHandle; uint32_t rootIndex; uint32_t pad; };
+struct CmdSetRootConstants   { CommandHeader header; uint32_t rootIndex; uint32_t destOffset; uint32_t count; uint32_t pad; uint32_t values[4]; };
+struct CmdSetPrimitiveTopology { CommandHeader header; uint32_t topology; uint32_t pad; };
+struct CmdSetVertexBuffer    { CommandHeader header; uint64_t gpuAddress; uint32_t sizeInBytes; uint32_t stride; uint32_t slot; uint32_t pad; };
+struct CmdSetIndexBuffer     { CommandHeader header; uint64_t gpuAddress; uint32_t sizeInBytes; uint32_t format; };
+struct CmdSetViewport        { CommandHeader header; float x, y, width, height, minDepth, maxDepth; };
+struct CmdSetScissor         { CommandHeader header; int32_t left, top, right, bottom; };
+struct CmdSetRenderTarget    { CommandHeader header; uint64_t rtv; uint64_t dsv; }; // 0 表示没有
+struct CmdClearRenderTarget  { CommandHeader header; uint64_t rtv; float color[4]; };
+struct CmdBarrier            { CommandHeader header; uint64_t resource; uint32_t subresource; uint32_t stateBefore; uint32_t stateAfter; uint32_t pad; };
+struct CmdDraw               { CommandHeader header; uint32_t vertexCount, instanceCount, startVertex, startInstance; };
+struct CmdDrawIndexed        { CommandHeader header; uint32_t indexCount, instanceCount, startIndex; int32_t baseVertex; uint32_t startInstance; uint32_t pad; };
+
+class CommandStream {
+public:
+    static const size_t ALIGNMENT = 8;
+    static const uint32_t MAX_ROOT_CONSTANTS = 4;
+
+    explicit CommandStream(size_t initialCapacity = 4096) { m_buffer.resize(initialCapacity); }
+
+    // 回绕写指针，保留已分配的内存
+    void Reset() { m_size = 0; m_commandCount = 0; }
+
+    size_t GetSize() const { return m_size; }
+    size_t GetCommandCount() const { return m_commandCount; }
+    const uint8_t* GetData() const { return m_buffer.data(); }
+
+    void SetPipeline(uint64_t pipeline) { Emplace<CmdSetPipeline>(CommandOp::SetPipeline).pipeline = pipeline; }
+    void SetRootSignature(uint64_t rootSignature) { Emplace<CmdSetRootSignature>(CommandOp::SetRootSignature).rootSignature = rootSignature; }
+    void SetPrimitiveTopology(uint32_t topology) { Emplace<CmdSetPrimitiveTopology>(CommandOp::SetPrimitiveTopology).topology = topology; }
+
+    void SetDescriptorHeaps(uint64_t resourceHeap, uint64_t samplerHeap = 0)
+    {
+        CmdSetDescriptorHeaps& cmd = Emplace<CmdSetDescriptorHeaps>(CommandOp::SetDescriptorHeaps);
+        cmd.resourceHeap = resourceHeap;
+        cmd.samplerHeap = samplerHeap;
+    }
+
+    void SetRootDescriptorTable(uint32_t rootIndex, uint64_t gpuHandle)
+    {
+        CmdSetRootDescriptorTable& cmd = Emplace<CmdSetRootDescriptorTable>(CommandOp::SetRootDescriptorTable);
+        cmd.gpuHandle = gpuHandle;
+        cmd.rootIndex = rootIndex;
+    }
+
+    // 每次最多 MAX_ROOT_CONSTANTS 个 32 位常量（bindless 下一次绘制只需要几个下标）
+    void SetRootConstants(uint32_t rootIndex, uint32_t count, const void* values, uint32_t destOffset = 0)
+    {
+        if (count > MAX_ROOT_CONSTANTS) {
+            throw std::invalid_argument("Too many root constants in one command");
+        }
+        CmdSetRootConstants& cmd = Emplace<CmdSetRootConstants>(CommandOp::SetRootConstants);
+        cmd.rootIndex = rootIndex;
+        cmd.destOffset = destOffset;
+        cmd.count = count;
+        std::memcpy(cmd.values, values, count * sizeof(uint32_t));
+    }
+
+    void SetVertexBuffer(uint32_t slot, uint64_t gpuAddress, uint32_t sizeInBytes, uint32_t stride)
+    {
+        CmdSetVertexBuffer& cmd = Emplace<CmdSetVertexBuffer>(CommandOp::SetVertexBuffer);
+        cmd.gpuAddress = gpuAddress;
+        cmd.sizeInBytes = sizeInBytes;
+        cmd.stride = stride;
+        cmd.slot = slot;
+    }
+
+    void SetIndexBuffer(uint64_t gpuAddress, uint32_t sizeInBytes, uint32_t format)
+    {
+        CmdSetIndexBuffer& cmd = Emplace<CmdSetIndexBuffer>(CommandOp::SetIndexBuffer);
+        cmd.gpuAddress = gpuAddress;
+        cmd.sizeInBytes = sizeInBytes;
+        cmd.format = format;
+    }
+
+    void SetViewport(float x, float y, float width, float height, float minDepth = 0.0f, float maxDepth = 1.0f)
+    {
+        CmdSetViewport& cmd = Emplace<CmdSetViewport>(CommandOp::SetViewport);
+        cmd.x = x;
+        cmd.y = y;
+        cmd.width = width;
+        cmd.height = height;
+        cmd.minDepth = minDepth;
+        cmd.maxDepth = maxDepth;
+    }
+
+    void SetScissor(int32_t left, int32_t top, int32_t right, int32_t bottom)
+    {
+        CmdSetScissor& cmd = Emplace<CmdSetScissor>(CommandOp::SetScissor);
+        cmd.left = left;
+        cmd.top = top;
+        cmd.right = right;
+        cmd.bottom = bottom;
+    }
+
+    void SetRenderTarget(uint64_t rtv, uint64_t dsv = 0)
+    {
+        CmdSetRenderTarget& cmd = Emplace<CmdSetRenderTarget>(CommandOp::SetRenderTarget);
+        cmd.rtv = rtv;
+        cmd.dsv = dsv;
+    }
+
+    void ClearRenderTarget(uint64_t rtv, const float color[4])
+    {
+        CmdClearRenderTarget& cmd = Emplace<CmdClearRenderTarget>(CommandOp::ClearRenderTarget);
+        cmd.rtv = rtv;
+        std::memcpy(cmd.color, color, sizeof(cmd.color));
+    }
+
+    void Barrier(uint64_t resource, uint32_t stateBefore, uint32_t stateAfter, uint32_t subresource = 0xffffffff)
+    {
+        CmdBarrier& cmd = Emplace<CmdBarrier>(CommandOp::Barrier);
+        cmd.resource = resource;
+        cmd.subresource = subresource;
+        cmd.stateBefore = stateBefore;
+        cmd.stateAfter = stateAfter;
+    }
+
+    void Draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t startVertex = 0, uint32_t startInstance = 0)
+    {
+        CmdDraw& cmd = Emplace<CmdDraw>(CommandOp::Draw);
+        cmd.vertexCount = vertexCount;
+        cmd.instanceCount = instanceCount;
+        cmd.startVertex = startVertex;
+        cmd.startInstance = startInstance;
+    }
+
+    void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t startIndex = 0, int32_t baseVertex = 0, uint32_t startInstance = 0)
+    {
+        CmdDrawIndexed& cmd = Emplace<CmdDrawIndexed>(CommandOp::DrawIndexed);
+        cmd.indexCount = indexCount;
+        cmd.instanceCount = instanceCount;
+        cmd.startIndex = startIndex;
+        cmd.baseVertex = baseVertex;
+        cmd.startInstance = startInstance;
+    }
+
+private:
+    template <typename T>
+    T& Emplace(CommandOp op)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Command packets must be POD");
+        static_assert(sizeof(T) % ALIGNMENT == 0, "Command packets must keep 8-byte alignment");
+
+        if (m_size + sizeof(T) > m_buffer.size()) {
+            m_buffer.resize((m_buffer.size() + sizeof(T)) * 2);
+        }
+        // 整个包先清零：填充字段和没用到的参数不会留下上一次录制的字节，
+        // 相同的命令总是得到相同的字节（BundleCache 按字节哈希和比较）
+        T* cmd = reinterpret_cast<T*>(m_buffer.data() + m_size);
+        std::memset(cmd, 0, sizeof(T));
+        cmd->header.op = op;
+        cmd->header.size = static_cast<uint16_t>(sizeof(T));
+        m_size += sizeof(T);
+        m_commandCount++;
+        return *cmd;
+    }
+
+    std::vector<uint8_t> m_buffer;
+    size_t m_size = 0;
+    size_t m_commandCount = 0;
+};
+
+// 按顺序把命令流分发给后端。Backend 需要为每种命令包提供一个 Execute 重载。
+template <typename Backend>
+void ReplayCommandStream(const CommandStream& stream, Backend& backend)
+{
+    const uint8_t* cursor = stream.GetData();
+    const uint8_t* end = cursor + stream.GetSize();
+    while (cursor < end) {
+        const CommandHeader* header = reinterpret_cast<const CommandHeader*>(cursor);
+        switch (header->op) {
+        case CommandOp::SetPipeline:          backend.Execute(*reinterpret_cast<const CmdSetPipeline*>(cursor)); break;
+        case CommandOp::SetRootSignature:     backend.Execute(*reinterpret_cast<const CmdSetRootSignature*>(cursor)); break;
+        case CommandOp::SetDescriptorHeaps:   backend.Execute(*reinterpret_cast<const CmdSetDescriptorHeaps*>(cursor)); break;
+        case CommandOp::SetRootDescriptorTable: backend.Execute(*reinterpret_cast<const CmdSetRootDescriptorTable*>(cursor)); break;
+        case CommandOp::SetRootConstants:     backend.Execute(*reinterpret_cast<const CmdSetRootConstants*>(cursor)); break;
+        case CommandOp::SetPrimitiveTopology: backend.Execute(*reinterpret_cast<const CmdSetPrimitiveTopology*>(cursor)); break;
+        case CommandOp::SetVertexBuffer:      backend.Execute(*reinterpret_cast<const CmdSetVertexBuffer*>(cursor)); break;
+        case CommandOp::SetIndexBuffer:       backend.Execute(*reinterpret_cast<const CmdSetIndexBuffer*>(cursor)); break;
+        case CommandOp::SetViewport:          backend.Execute(*reinterpret_cast<const CmdSetViewport*>(cursor)); break;
+        case CommandOp::SetScissor:           backend.Execute(*reinterpret_cast<const CmdSetScissor*>(cursor)); break;
+        case CommandOp::SetRenderTarget:      backend.Execute(*reinterpret_cast<const CmdSetRenderTarget*>(cursor)); break;
+        case CommandOp::ClearRenderTarget:    backend.Execute(*reinterpret_cast<const CmdClearRenderTarget*>(cursor)); break;
+        case CommandOp::Barrier:              backend.Execute(*reinterpret_cast<const CmdBarrier*>(cursor)); break;
+        case CommandOp::Draw:                 backend.Execute(*reinterpret_cast<const CmdDraw*>(cursor)); break;
+        case CommandOp::DrawIndexed:          backend.Execute(*reinterpret_cast<const CmdDrawIndexed*>(cursor)); break;
+        default:
+            throw std::runtime_error("Failed to replay command stream: unknown command op");
+        }
+        cursor += header->size;
+    }
+}
+
+// 无 GPU 的后端：只统计命令，用于测试和基准
+struct NullCommandBackend {
+    size_t commandCount = 0;
+    size_t drawCount = 0;
+
+    template <typename T>
+    void Execute(const T&) { commandCount++; }
+    void Execute(const CmdDraw&) { commandCount++; drawCount++; }
+    void Execute(const CmdDrawIndexed&) { commandCount++; drawCount++; }
+};
@@ -0,0 +1,41 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include "GpuTimeline.h"
+
+// 一条时间线上由 OnCompleted 回调推进的完成值，按 fence 值回收的队列用它代替轮询 GetCompletedValue。
+// Request 声明要知道某个值什么时候完成，每个递增的请求值挂一个回调；还没发信号的值等发出之后再挂。
+// 挂着的值都已经发过信号、回调总会执行，析构时等 GPU 执行到最大的挂起值、回调全部执行完再返回。
+// 回调只捕获 this 和值，std::function 放得下，不分配内存。可以在多个线程上使用。
+class CompletionTracker {
+public:
+    explicit CompletionTracker(IGpuTimeline& timeline);
+    ~CompletionTracker();
+
+    CompletionTracker(const CompletionTracker&) = delete;
+    CompletionTracker& operator=(const CompletionTracker&) = delete;
+
+    // value 完成后推进 GetCompletedValue
+    void Request(uint64_t value);
+
+    // 已知完成的最大值。请求时还没发信号的值这时发了信号的话顺便挂上回调
+    uint64_t GetCompletedValue();
+
+    IGpuTimeline& GetTimeline() const { return m_timeline; }
+
+private:
+    // 在锁内取出可以挂的值，返回 0 表示没有
+    uint64_t TakeArmableLocked();
+    void Arm(uint64_t target);
+    void OnTargetCompleted(uint64_t value);
+
+    IGpuTimeline& m_timeline;
+    std::mutex m_mutex;
+    std::condition_variable m_idle;
+    uint64_t m_requested = 0;  // 请求过的最大值
+    uint64_t m_armed = 0;      // 挂过回调的最大值
+    uint64_t m_completed = 0;
+    uint32_t m_pendingCount = 0; // 挂在时间线上、还没执行的回调
+    bool m_stopping = false;
+};
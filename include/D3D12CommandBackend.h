@@ -0,0 +1,124 @@
+#pragma once
+#include <d3d12.h>
+#include "CommandStream.h"
+#include "StateFilteredCommandList.h"
+
+// 把命令流翻译成 ID3D12GraphicsCommandList 调用的后端。
+// 状态设置经过 StateFilteredCommandList，同一个列表内的冗余设置会被丢弃。
+class D3D12CommandBackend {
+public:
+    explicit D3D12CommandBackend(ID3D12GraphicsCommandList* commandList) : m_commandList(commandList), m_state(commandList) {}
+
+    const StateFilteredCommandList::Stats& GetStateStats() const { return m_state.GetStats(); }
+
+    // 在同一个列表上直接执行了会修改状态的调用（例如 ExecuteBundle）之后调用
+    void InvalidateState() { m_state.Invalidate(); }
+
+    // 录制端使用的句柄转换
+    static uint64_t ToHandle(const void* object) { return reinterpret_cast<uint64_t>(object); }
+    static uint64_t ToHandle(D3D12_CPU_DESCRIPTOR_HANDLE descriptor) { return static_cast<uint64_t>(descriptor.ptr); }
+    static uint64_t ToHandle(D3D12_GPU_DESCRIPTOR_HANDLE descriptor) { return static_cast<uint64_t>(descriptor.ptr); }
+
+    void Execute(const CmdSetPipeline& cmd)
+    {
+        m_state.SetPipelineState(reinterpret_cast<ID3D12PipelineState*>(cmd.pipeline));
+    }
+
+    void Execute(const CmdSetRootSignature& cmd)
+    {
+        m_state.SetGraphicsRootSignature(reinterpret_cast<ID3D12RootSignature*>(cmd.rootSignature));
+    }
+
+    void Execute(const CmdSetDescriptorHeaps& cmd)
+    {
+        ID3D12DescriptorHeap* heaps[2] = {};
+        UINT count = 0;
+        if (cmd.resourceHeap) {
+            heaps[count++] = reinterpret_cast<ID3D12DescriptorHeap*>(cmd.resourceHeap);
+        }
+        if (cmd.samplerHeap) {
+            heaps[count++] = reinterpret_cast<ID3D12DescriptorHeap*>(cmd.samplerHeap);
+        }
+        m_state.SetDescriptorHeaps(count, heaps);
+    }
+
+    void Execute(const CmdSetRootDescriptorTable& cmd)
+    {
+        D3D12_GPU_DESCRIPTOR_HANDLE table = { cmd.gpuHandle };
+        m_state.SetGraphicsRootDescriptorTable(cmd.rootIndex, table);
+    }
+
+    // 根常量每次绘制都不同，不经过状态过滤
+    void Execute(const CmdSetRootConstants& cmd)
+    {
+        m_commandList->SetGraphicsRoot32BitConstants(cmd.rootIndex, cmd.count, cmd.values, cmd.destOffset);
+    }
+
+    void Execute(const CmdSetPrimitiveTopology& cmd)
+    {
+        m_state.IASetPrimitiveTopology(static_cast<D3D_PRIMITIVE_TOPOLOGY>(cmd.topology));
+    }
+
+    void Execute(const CmdSetVertexBuffer& cmd)
+    {
+        D3D12_VERTEX_BUFFER_VIEW view = { cmd.gpuAddress, cmd.sizeInBytes, cmd.stride };
+        m_state.IASetVertexBuffers(cmd.slot, 1, &view);
+    }
+
+    void Execute(const CmdSetIndexBuffer& cmd)
+    {
+        D3D12_INDEX_BUFFER_VIEW view = { cmd.gpuAddress, cmd.sizeInBytes, static_cast<DXGI_FORMAT>(cmd.format) };
+        m_state.IASetIndexBuffer(&view);
+    }
+
+    void Execute(const CmdSetViewport& cmd)
+    {
+        D3D12_VIEWPORT viewport = { cmd.x, cmd.y, cmd.width, cmd.height, cmd.minDepth, cmd.maxDepth };
+        m_state.RSSetViewports(1, &viewport);
+    }
+
+    void Execute(const CmdSetScissor& cmd)
+    {
+        D3D12_RECT rect = { cmd.left, cmd.top, cmd.right, cmd.bottom };
+        m_state.RSSetScissorRects(1, &rect);
+    }
+
+    void Execute(const CmdSetRenderTarget& cmd)
+    {
+        D3D12_CPU_DESCRIPTOR_HANDLE rtv = { static_cast<SIZE_T>(cmd.rtv) };
+        D3D12_CPU_DESCRIPTOR_HANDLE dsv = { static_cast<SIZE_T>(cmd.dsv) };
+        m_state.OMSetRenderTargets(cmd.rtv ? 1 : 0, cmd.rtv ? &rtv : nullptr, cmd.dsv ? &dsv : nullptr);
+    }
+
+    void Execute(const CmdClearRenderTarget& cmd)
+    {
+        D3D12_CPU_DESCRIPTOR_HANDLE rtv = { static_cast<SIZE_T>(cmd.rtv) };
+        m_commandList->ClearRenderTargetView(rtv, cmd.color, 0, nullptr);
+    }
+
+    void Execute(const CmdBarrier& cmd)
+    {
+        D3D12_RESOURCE_BARRIER barrier = {};
+        barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+        barrier.Transition.pResource = reinterpret_cast<ID3D12Resource*>(cmd.resource);
+        barrier.Transition.Subresource = cmd.subresource;
+        barrier.Transition.StateBefore = static_cast<D3D12_RESOURCE_STATES>(cmd.stateBefore);
+        barrier.Transition.StateAfter = static_cast<D3D12_RESOURCE_STATES>(cmd.stateAfter);
+        m_commandList->ResourceBarrier(1, &barrier);
+    }
+
+    void Execute(const CmdDraw& cmd)
+    {
+        m_commandList->DrawInstanced(cmd.vertexCount, cmd.instanceCount, cmd.startVertex, cmd.startInstance);
+    }
+
+    void Execute(const CmdDrawIndexed& cmd)
+    {
+        m_commandList->DrawIndexedInstanced(cmd.indexCount, cmd.instanceCount, cmd.startIndex, cmd.baseVertex, cmd.startInstance);
+    }
+
+private:
+    ID3D12GraphicsCommandList* m_commandList;
+    StateFilteredCommandList m_state;
+};
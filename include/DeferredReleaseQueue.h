@@ -0,0 +1,54 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "CompletionTracker.h"
+
+// GPU 可能还在使用的对象先停在这里，带着 fence 值，等值完成后再释放。
+// 替换或丢弃缓冲区、暂存内存、堆时不用为了让对象活到 GPU 用完而阻塞 CPU。
+// 每条时间线一条按 fence 值递增的队列；完成值由时间线的 OnCompleted 回调推进，
+// Collect 在调用线程上释放已经完成的部分。可以在多个线程上使用。
+class DeferredReleaseQueue {
+public:
+    DeferredReleaseQueue() = default;
+    ~DeferredReleaseQueue();
+
+    DeferredReleaseQueue(const DeferredReleaseQueue&) = delete;
+    DeferredReleaseQueue& operator=(const DeferredReleaseQueue&) = delete;
+
+    // timeline 上的 fenceValue 完成后释放 object
+    void Release(Microsoft::WRL::ComPtr<IUnknown> object, IGpuTimeline& timeline, uint64_t fenceValue);
+    // 已经录制、但还没发信号的工作也可能引用 object，所以等下一次信号（最后信号值 + 1）
+    void Release(Microsoft::WRL::ComPtr<IUnknown> object, IGpuTimeline& timeline);
+
+    // timeline 上的 fenceValue 完成后执行 callback（比如把堆区间还给分配器）
+    void Defer(std::function<void()> callback, IGpuTimeline& timeline, uint64_t fenceValue);
+    void Defer(std::function<void()> callback, IGpuTimeline& timeline);
+
+    // 释放所有已经完成的对象，返回释放的个数
+    size_t Collect();
+
+    size_t GetPendingCount() const;
+
+private:
+    struct Entry {
+        uint64_t fenceValue;
+        Microsoft::WRL::ComPtr<IUnknown> object;
+        std::function<void()> callback;
+    };
+
+    struct Lane {
+        IGpuTimeline* timeline;
+        std::unique_ptr<CompletionTracker> completion;
+        std::deque<Entry> entries; // 按 fence 值递增
+    };
+
+    void Push(IGpuTimeline& timeline, Entry&& entry);
+
+    mutable std::mutex m_mutex;
+    std::vector<Lane> m_lanes;
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <mutex>
+#include <vector>
+#include "DescriptorFreeList.h"
+
+// CPU 描述符堆里的一个描述符
+struct DescriptorHandle {
+    D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle = {};
+    uint32_t index = DescriptorFreeList::INVALID_INDEX;
+
+    bool IsValid() const { return index != DescriptorFreeList::INVALID_INDEX; }
+};
+
+// 一种描述符堆类型（RTV / DSV / CBV_SRV_UAV / SAMPLER）的 CPU 描述符分配器。
+// 由不可着色器访问的描述符堆分页组成，页满了再加一页，已有的句柄不会失效；
+// 槽位由 DescriptorFreeList 管理，分配和释放都是 O(1)。
+// 可以在多个线程上同时使用（比如加载线程创建视图）。
+// CPU 描述符在录制（OMSetRenderTargets）或复制到着色器可见堆时就已经被读取，
+// 不再被引用之后可以立即释放，不需要等 GPU。
+class DescriptorAllocator {
+public:
+    DescriptorAllocator(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t descriptorsPerPage = DEFAULT_PAGE_SIZE);
+
+    DescriptorAllocator(const DescriptorAllocator&) = delete;
+    DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+    DescriptorHandle Allocate();
+    void Free(DescriptorHandle& handle);
+
+    D3D12_DESCRIPTOR_HEAP_TYPE GetType() const { return m_type; }
+    UINT GetDescriptorSize() const { return m_descriptorSize; }
+    DescriptorFreeList::Stats GetStats() const;
+
+    static const uint32_t DEFAULT_PAGE_SIZE = 256;
+
+private:
+    Microsoft::WRL::ComPtr<ID3D12Device> m_device;
+    D3D12_DESCRIPTOR_HEAP_TYPE m_type;
+    UINT m_descriptorSize;
+
+    mutable std::mutex m_mutex;
+    DescriptorFreeList m_freeList;
+    std::vector<Microsoft::WRL::ComPtr<ID3D12DescriptorHeap>> m_pages;
+    std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> m_pageStarts;
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// 分页的描述符槽位管理，只管下标，不依赖 D3D12。
+// 每页 pageSize 个槽位，全局下标 = 页号 * pageSize + 页内位置；
+// 所有页的空闲槽位串成一条单链表，分配和释放都是 O(1)。
+// 没有空闲槽位时 Allocate 返回 INVALID_INDEX，由使用方 AddPage 之后再分配。
+// 不是线程安全的，由使用方加锁。
+class DescriptorFreeList {
+public:
+    static const uint32_t INVALID_INDEX = 0xffffffffu;
+
+    struct Stats {
+        uint32_t pageCount = 0;
+        uint32_t capacity = 0;
+        uint32_t allocated = 0;
+        uint32_t peakAllocated = 0;
+    };
+
+    explicit DescriptorFreeList(uint32_t pageSize);
+
+    // 加一页空闲槽位，返回页号
+    uint32_t AddPage();
+
+    uint32_t Allocate();
+    void Free(uint32_t index);
+
+    uint32_t GetPageSize() const { return m_pageSize; }
+    uint32_t GetPage(uint32_t index) const { return index / m_pageSize; }
+    uint32_t GetSlot(uint32_t index) const { return index % m_pageSize; }
+    bool IsAllocated(uint32_t index) const { return index < m_next.size() && m_next[index] == ALLOCATED; }
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    static const uint32_t ALLOCATED = 0xfffffffeu; // 已分配槽位在 m_next 里的标记，用来发现重复释放
+
+    uint32_t m_pageSize;
+    std::vector<uint32_t> m_next; // 空闲槽位指向下一个空闲槽位
+    uint32_t m_head = INVALID_INDEX;
+    Stats m_stats;
+};
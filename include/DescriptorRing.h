@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include "RingQueue.h"
+
+// 着色器可见描述符堆的环形区间分配，只管下标，不依赖 D3D12。
+// Allocate 在环上切出连续的一段，放不下环尾时跳过尾部从头开始；
+// EndFrame 把这一帧切出的所有区间记到 fence 值上，Reclaim 在 fence 完成后整帧回收。
+// 不是线程安全的，由使用方加锁。
+class DescriptorRing {
+public:
+    static const uint32_t INVALID_OFFSET = 0xffffffffu;
+
+    explicit DescriptorRing(uint32_t capacity);
+
+    // 空间不够时返回 INVALID_OFFSET
+    uint32_t Allocate(uint32_t count);
+
+    void EndFrame(uint64_t fenceValue);
+    void Reclaim(uint64_t completedValue);
+
+    // 还没回收的最早一帧的 fence 值，没有时返回 0
+    uint64_t GetOldestFenceValue() const { return m_frames.empty() ? 0 : m_frames.front().fenceValue; }
+    uint32_t GetCapacity() const { return m_capacity; }
+    uint32_t GetUsed() const { return static_cast<uint32_t>(m_allocated - m_reclaimed); } // 包括跳过的环尾
+
+private:
+    struct Frame {
+        uint64_t fenceValue;
+        uint32_t head;      // 这一帧结束时的写位置，回收后成为新的尾
+        uint64_t allocated; // 这一帧结束时累计切出的数量
+    };
+
+    uint32_t m_capacity;
+    uint32_t m_head = 0;
+    uint32_t m_tail = 0;
+    uint64_t m_allocated = 0;
+    uint64_t m_reclaimed = 0;
+    RingQueue<Frame> m_frames;
+};
@@ -0,0 +1,103 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "DescriptorAllocator.h"
+#include "DynamicDescriptorHeap.h"
+
+// 缓存里的一个视图：CPU 描述符和它在 bindless 全局表里的下标
+struct CachedView {
+    D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle = {};
+    uint32_t index = DescriptorFreeList::INVALID_INDEX; // 着色器里用的下标
+    uint64_t key = 0;
+
+    bool IsValid() const { return index != DescriptorFreeList::INVALID_INDEX; }
+};
+
+// SRV / CBV 的去重缓存。键由资源和视图描述里按视图维度实际用到的字段组成，命中时逐字比较；
+// 相同的视图只创建一次、只占一个 CPU 描述符和一个常驻的着色器可见描述符，用引用计数共享，
+// 最后一个引用释放时归还。第一次给某个资源建视图时在它上面挂一个私有数据接口，
+// 资源销毁时记下来，下一次调用缓存（或 CollectReleased）时把它的视图全部逐出，
+// 地址被新资源复用也不会命中旧视图。可以在多个线程上同时使用。
+class DescriptorViewCache {
+public:
+    struct Stats {
+        uint64_t lookups = 0;
+        uint64_t hits = 0;
+        uint64_t evictions = 0; // 因资源销毁而逐出的视图
+        uint32_t views = 0;     // 当前缓存的视图数，也就是占用的描述符数
+
+        double GetHitRate() const { return lookups ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0; }
+    };
+
+    DescriptorViewCache(ID3D12Device* device, DescriptorAllocator& cpuDescriptors, DynamicDescriptorHeap& shaderVisible);
+    ~DescriptorViewCache();
+
+    DescriptorViewCache(const DescriptorViewCache&) = delete;
+    DescriptorViewCache& operator=(const DescriptorViewCache&) = delete;
+
+    // desc 为空时是资源的默认视图
+    CachedView AcquireShaderResourceView(ID3D12Resource* resource, const D3D12_SHADER_RESOURCE_VIEW_DESC* desc);
+    // desc.BufferLocation 要落在 resource 里
+    CachedView AcquireConstantBufferView(ID3D12Resource* resource, const D3D12_CONSTANT_BUFFER_VIEW_DESC& desc);
+    void Release(CachedView& view);
+
+    // 逐出已经销毁的资源的视图
+    void CollectReleased();
+
+    Stats GetStats() const;
+
+private:
+    enum class ViewType : uint32_t { ShaderResource, ConstantBuffer };
+
+    union ViewDesc {
+        D3D12_SHADER_RESOURCE_VIEW_DESC srv;
+        D3D12_CONSTANT_BUFFER_VIEW_DESC cbv;
+    };
+
+    // 视图描述里当前视图维度用到的字段，按 32 位逐个写入；联合体里其他成员和填充字节不参与比较
+    struct ViewKey {
+        static const uint32_t MAX_WORDS = 12;
+        uint32_t words[MAX_WORDS] = {};
+        uint32_t count = 0;
+
+        void Put(uint32_t value) { words[count++] = value; }
+        void Put(uint64_t value);
+        void Put(float value);
+        bool operator==(const ViewKey& other) const;
+    };
+
+    struct Entry {
+        ID3D12Resource* resource;
+        ViewKey key;
+        DescriptorHandle descriptor;
+        uint32_t index;
+        uint32_t refCount;
+    };
+
+    // 资源销毁时令牌把资源地址放进这里。缓存和所有存活的令牌共享，缓存先销毁时令牌仍然可以安全地写入
+    struct ReleasedResources {
+        std::mutex mutex;
+        std::vector<ID3D12Resource*> resources;
+    };
+
+    CachedView Acquire(ID3D12Resource* resource, ViewType type, const ViewDesc& desc, bool defaultView);
+    void CollectReleasedLocked();
+    void DestroyEntry(const Entry& entry);
+    static ViewKey BuildKey(ViewType type, const ViewDesc& desc, bool defaultView);
+    static uint64_t HashView(ID3D12Resource* resource, const ViewKey& key);
+
+    Microsoft::WRL::ComPtr<ID3D12Device> m_device;
+    DescriptorAllocator& m_cpuDescriptors;
+    DynamicDescriptorHeap& m_shaderVisible;
+
+    mutable std::mutex m_mutex;
+    std::unordered_multimap<uint64_t, Entry> m_entries;
+    std::unordered_map<ID3D12Resource*, std::vector<uint64_t>> m_resourceViews; // 挂了令牌的资源 -> 它的视图的键
+    std::shared_ptr<ReleasedResources> m_released;
+    std::vector<ID3D12Resource*> m_collecting; // CollectReleasedLocked 复用
+    Stats m_stats;
+};
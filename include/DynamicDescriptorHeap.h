@@ -0,0 +1,93 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "DescriptorFreeList.h"
+#include "DescriptorRing.h"
+#include "GpuTimeline.h"
+
+// 一个大的着色器可见 CBV_SRV_UAV 描述符堆，也是 bindless 的全局描述符数组。
+// 前 persistentCapacity 个描述符是常驻区，按槽位分配（纹理、静态缓冲区的视图），释放在当帧 fence 完成后生效；
+// 后面的部分按 fence 回收的环形使用（DescriptorRing），放只用一帧的描述符。
+// 两部分都从 CPU 描述符用 CopyDescriptorsSimple 复制进来，返回在整个堆里的下标，
+// 着色器用这个下标索引从堆起点开始的全局表；同一帧里来源完全相同的环上分配只复制一次。
+// 整个渲染器只有这一个堆，命令列表开头设置一次，帧内不再切换。
+// 复用按来源句柄判断：一帧之内已经复制过的 CPU 描述符不能再改写。可以在多个线程上同时使用。
+class DynamicDescriptorHeap {
+public:
+    struct Stats {
+        uint64_t tables = 0;          // AllocateTable 的调用次数
+        uint64_t reusedTables = 0;    // 命中本帧已有的表、没有复制的次数
+        uint64_t copiedDescriptors = 0;
+        uint32_t peakDescriptors = 0; // 环上同时占用的描述符数的峰值
+        uint64_t waits = 0;           // 环满了等 GPU 的次数
+        uint32_t persistentDescriptors = 0; // 常驻区当前占用的描述符数
+    };
+
+    DynamicDescriptorHeap(ID3D12Device* device, IGpuTimeline& timeline, uint32_t persistentCapacity, uint32_t ringCapacity);
+
+    DynamicDescriptorHeap(const DynamicDescriptorHeap&) = delete;
+    DynamicDescriptorHeap& operator=(const DynamicDescriptorHeap&) = delete;
+
+    // 回收 GPU 已经用完的帧和常驻槽位，清空复用缓存
+    void BeginFrame();
+    // 这一帧分配的表和释放的常驻槽位在 fenceValue 完成后回收
+    void EndFrame(uint64_t fenceValue);
+
+    // sources 是 count 个同类型的 CPU 描述符，按顺序组成一张表；返回表的第一个描述符在堆里的下标
+    uint32_t AllocateTable(const D3D12_CPU_DESCRIPTOR_HANDLE* sources, uint32_t count);
+
+    // 常驻区：复制 source 并返回下标，常驻区满了抛异常
+    uint32_t AllocatePersistent(D3D12_CPU_DESCRIPTOR_HANDLE source);
+    // 下标可能还被飞行中的帧引用，这一帧结束并且 GPU 完成后才会重新分配
+    void FreePersistent(uint32_t index);
+
+    D3D12_GPU_DESCRIPTOR_HANDLE GetGpuHandle(uint32_t index) const;
+    // 全局表的起点，也就是堆的起点
+    D3D12_GPU_DESCRIPTOR_HANDLE GetGlobalTable() const { return m_gpuStart; }
+    ID3D12DescriptorHeap* GetHeap() const { return m_heap.Get(); }
+    Stats GetStats() const;
+
+private:
+    struct CachedTable {
+        uint64_t hash;
+        uint32_t frame;       // 不是当前帧的槽位视为空
+        uint32_t sourceStart; // 在 m_cachedSources 里的起点
+        uint32_t count;
+        uint32_t offset;      // 在环上的位置
+    };
+
+    struct RetiredSlots {
+        uint64_t fenceValue;
+        std::vector<uint32_t> indices;
+    };
+
+    uint32_t AllocateRange(uint32_t count);
+    const CachedTable* FindTable(uint64_t hash, const D3D12_CPU_DESCRIPTOR_HANDLE* sources, uint32_t count) const;
+    void InsertTable(const CachedTable& table);
+    void CopyToHeap(uint32_t index, const D3D12_CPU_DESCRIPTOR_HANDLE* sources, uint32_t count);
+
+    Microsoft::WRL::ComPtr<ID3D12Device> m_device;
+    IGpuTimeline& m_timeline;
+    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_heap;
+    D3D12_CPU_DESCRIPTOR_HANDLE m_cpuStart = {};
+    D3D12_GPU_DESCRIPTOR_HANDLE m_gpuStart = {};
+    UINT m_descriptorSize;
+
+    mutable std::mutex m_mutex;
+    uint32_t m_persistentCapacity;
+    DescriptorFreeList m_persistentSlots;
+    std::vector<uint32_t> m_freedThisFrame;
+    std::deque<RetiredSlots> m_retiredSlots; // 等 GPU 用完再放回 m_persistentSlots
+    DescriptorRing m_ring;                   // 偏移加上 m_persistentCapacity 才是堆里的下标
+
+    // 本帧复用缓存：开放寻址，槽位按帧号失效，跨帧不清空也不释放内存
+    std::vector<CachedTable> m_tableCache;
+    std::vector<SIZE_T> m_cachedSources;
+    uint32_t m_cachedCount = 0;
+    uint32_t m_frame = 1;
+
+    Stats m_stats;
+};
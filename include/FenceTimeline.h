@@ -0,0 +1,63 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "GpuTimeline.h"
+
+// 基于 ID3D12Fence 的时间线，绑定到一个命令队列。
+// 除了阻塞等待，还可以注册“某个值完成后执行”的回调（资源释放、回读、上传完成等），
+// 所有回调由同一个等待线程处理，事件句柄创建后反复使用。
+class FenceTimeline : public IGpuTimeline {
+public:
+    FenceTimeline(ID3D12Device* device, ID3D12CommandQueue* queue, uint64_t initialValue = 0);
+    ~FenceTimeline();
+
+    FenceTimeline(const FenceTimeline&) = delete;
+    FenceTimeline& operator=(const FenceTimeline&) = delete;
+
+    uint64_t Signal() override;
+    uint64_t GetCompletedValue() override;
+    void WaitForValue(uint64_t value) override;
+
+    // value 完成后在等待线程上执行 callback；已经完成的值也会异步执行，不会在调用线程上执行。
+    // 析构时先等 GPU 执行完最后一次信号，再在析构的线程上执行已经发过信号的值的回调；
+    // value 从来没有发过信号的回调不执行，直接丢弃
+    void OnCompleted(uint64_t value, std::function<void()> callback) override;
+
+    size_t GetPendingCallbackCount() const;
+    uint64_t GetLastSignaledValue() const override { return m_lastSignaled.load(); }
+    ID3D12Fence* GetFence() const { return m_fence.Get(); }
+    ID3D12CommandQueue* GetQueue() const { return m_queue.Get(); }
+
+private:
+    HANDLE AcquireWaitEvent();
+    void ReleaseWaitEvent(HANDLE event);
+    void WaiterThreadMain();
+    // 执行值不超过 completed 的回调
+    void DispatchCompleted(uint64_t completed);
+
+    Microsoft::WRL::ComPtr<ID3D12CommandQueue> m_queue;
+    Microsoft::WRL::ComPtr<ID3D12Fence> m_fence;
+    std::atomic<uint64_t> m_lastSignaled;
+    std::mutex m_signalMutex;
+
+    // WaitForValue 用的事件池：每个等待者取一个自己的事件，等完放回，多个线程可以同时等不同的值
+    std::vector<HANDLE> m_freeWaitEvents;
+    std::mutex m_waitMutex;
+
+    // 等待线程：m_fenceEvent 等最早的回调值，m_wakeEvent 在有新回调或退出时唤醒
+    HANDLE m_fenceEvent = nullptr;
+    HANDLE m_wakeEvent = nullptr;
+    mutable std::mutex m_callbackMutex;
+    std::pmr::unsynchronized_pool_resource m_callbackMemory; // 回调节点的池，只在 m_callbackMutex 下使用，稳定后不再分配
+    std::pmr::multimap<uint64_t, std::function<void()>> m_callbacks{ &m_callbackMemory };
+    std::vector<std::function<void()>> m_readyCallbacks; // 只在等待线程上使用，跨次复用
+    bool m_stopping = false;
+    std::thread m_waiterThread;
+};
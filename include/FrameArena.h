@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+// 按帧槽分区的 CPU 线性分配器，给只活一帧的渲染数据（绘制列表、命令列表数组、剔除结果……）用。
+// 分配只是在当前分区里移动一次指针，释放什么也不做，回到这个帧槽时整个分区一次清空。
+// 分区放不下时向上游申请单独的内存块，随分区一起释放并计入溢出统计；
+// 下次回到这个分区时把它扩大到上次的用量，所以稳定之后不再产生堆分配。
+// 实现了 std::pmr::memory_resource，可以直接给 std::pmr 容器用。只能在渲染线程上使用。
+class FrameArena : public std::pmr::memory_resource {
+public:
+    struct Stats {
+        uint64_t peakBytes = 0;     // 单帧用量的峰值（含溢出）
+        uint64_t overflowCount = 0; // 分区放不下、向上游申请的次数
+        uint64_t overflowBytes = 0;
+        uint64_t growCount = 0;     // 分区按峰值扩大的次数
+    };
+
+    FrameArena(size_t bytesPerFrame, uint32_t frameCount, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~FrameArena() override;
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // 切换到下一个分区并清空它；调用方要保证上次用这个分区的帧已经不再需要这些数据
+    void BeginFrame();
+
+    size_t GetFrameUsage() const { return m_partitions[m_current].demand; }
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    // 溢出块的头部，块之间串成单链表
+    struct OverflowBlock {
+        OverflowBlock* next;
+        size_t size;
+    };
+
+    struct Partition {
+        std::byte* base = nullptr;
+        size_t capacity = 0;
+        size_t offset = 0;
+        size_t demand = 0; // 本帧请求的总字节数，包括溢出部分
+        OverflowBlock* overflow = nullptr;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    void* AllocateOverflow(Partition& partition, size_t bytes, size_t alignment);
+    void ReleaseOverflow(Partition& partition);
+
+    std::pmr::memory_resource* m_upstream;
+    std::vector<Partition> m_partitions;
+    uint32_t m_current = 0;
+    Stats m_stats;
+};
+
+// 分配在帧分配器上的容器，只在当前帧内有效
+template <typename T>
+using FrameVector = std::pmr::vector<T>;
@@ -0,0 +1,158 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "AliasingPlanner.h"
+
+using FrameGraphResource = uint32_t;
+
+// 每帧重建的渲染图。Pass 在 setup 里声明读写哪些资源、需要什么状态，
+// Compile 从输出（导入资源和有副作用的 Pass）往回剔除没有用到的 Pass，
+// 计算临时资源的生命周期并让不重叠的资源共用堆内存，再算出每个 Pass 之前要做的状态转换
+// （中间隔着别的 Pass 时拆成 Begin/End 两半）。
+// 图本身不依赖 D3D12：状态是不透明的 uint32（D3D12_RESOURCE_STATES 的值），
+// 物理资源也只是一个 uint64，由使用方解释。Reset 之后容器容量保留，跨帧复用。
+class FrameGraph {
+public:
+    static const uint32_t STATE_UNDEFINED = 0xffffffffu; // 临时资源第一次使用前的状态
+    static const FrameGraphResource INVALID_RESOURCE = 0xffffffffu;
+
+    // 资源上次使用和这次使用之间隔着别的 Pass 时，转换拆成两半：
+    // Begin 放在空隙里的第一个 Pass 之前，End 放在真正需要的 Pass 之前，GPU 可以在空隙里完成转换
+    enum class Split : uint32_t {
+        None,
+        Begin,
+        End,
+    };
+
+    struct Transition {
+        FrameGraphResource resource;
+        uint32_t before;
+        uint32_t after;
+        Split split;
+    };
+
+    class PassBuilder {
+    public:
+        void Read(FrameGraphResource resource, uint32_t state);
+        void Write(FrameGraphResource resource, uint32_t state);
+        void SetSideEffect(); // 即使没有被读取也不能剔除
+
+    private:
+        friend class FrameGraph;
+        PassBuilder(FrameGraph& graph, uint32_t pass) : m_graph(graph), m_pass(pass) {}
+
+        FrameGraph& m_graph;
+        uint32_t m_pass;
+    };
+
+    using SetupFn = std::function<void(PassBuilder&)>;
+    using ExecuteFn = std::function<void()>;
+    // 在每个 Pass 执行之前调用，传入这个 Pass 需要的状态转换
+    using BeforePassFn = std::function<void(uint32_t pass, const Transition* transitions, size_t count)>;
+
+    void Reset();
+
+    // 导入外部资源（比如后台缓冲区），写它的 Pass 一律保留
+    FrameGraphResource Import(const char* name, uint32_t initialState, uint64_t physical);
+    // 声明临时资源，size/alignment 用于别名规划；只有 heapGroup 相同的资源才会共用内存
+    FrameGraphResource CreateTransient(const char* name, uint64_t size, uint64_t alignment, uint64_t userData = 0, uint32_t heapGroup = 0);
+
+    uint32_t AddPass(const char* name, const SetupFn& setup, ExecuteFn execute);
+
+    void Compile();
+    void Execute(const BeforePassFn& beforePass);
+
+    // 编译结果
+    bool IsPassCulled(uint32_t pass) const { return m_passes[pass].culled; }
+    const char* GetPassName(uint32_t pass) const { return m_passes[pass].name; }
+    uint32_t GetPassCount() const { return static_cast<uint32_t>(m_passes.size()); }
+    const std::vector<uint32_t>& GetExecutionOrder() const { return m_order; }
+    const Transition* GetPassTransitions(uint32_t pass, size_t& count) const;
+
+    uint32_t GetResourceCount() const { return static_cast<uint32_t>(m_resources.size()); }
+    bool IsTransient(FrameGraphResource resource) const { return !m_resources[resource].imported; }
+    bool IsResourceUsed(FrameGraphResource resource) const { return m_resources[resource].firstUse != UNUSED; }
+    uint32_t GetFirstUse(FrameGraphResource resource) const { return m_resources[resource].firstUse; } // 执行顺序中的位置
+    uint32_t GetLastUse(FrameGraphResource resource) const { return m_resources[resource].lastUse; }
+    uint64_t GetHeapOffset(FrameGraphResource resource) const { return m_resources[resource].heapOffset; } // 在所在组的堆里的偏移
+    uint32_t GetHeapGroup(FrameGraphResource resource) const { return m_resources[resource].heapGroup; }
+    // 这一帧里在它之前最后占用它整个地址范围的临时资源，没有时为 INVALID_RESOURCE
+    FrameGraphResource GetAliasPredecessor(FrameGraphResource resource) const { return m_resources[resource].aliasPredecessor; }
+    uint64_t GetUserData(FrameGraphResource resource) const { return m_resources[resource].userData; }
+    uint64_t GetTransientHeapSize() const { return m_aliasing.heapSize; } // 所有组之和
+    uint64_t GetTransientHeapSize(uint32_t heapGroup) const
+    {
+        return heapGroup < m_aliasing.groupSizes.size() ? m_aliasing.groupSizes[heapGroup] : 0;
+    }
+    uint64_t GetUnaliasedTransientSize() const { return m_aliasing.unaliasedSize; }
+    uint64_t GetPeakLiveTransientSize() const { return m_aliasing.peakLiveSize; } // 打包结果的下界
+
+    // 临时资源在堆里实例化之后由使用方回填
+    void SetPhysical(FrameGraphResource resource, uint64_t physical) { m_resources[resource].physical = physical; }
+    uint64_t GetPhysical(FrameGraphResource resource) const { return m_resources[resource].physical; }
+
+private:
+    static const uint32_t UNUSED = 0xffffffffu;
+
+    struct Access {
+        uint32_t pass;
+        FrameGraphResource resource;
+        uint32_t state;
+        bool write;
+    };
+
+    struct Resource {
+        const char* name;
+        bool imported;
+        uint32_t initialState;
+        uint64_t size;
+        uint64_t alignment;
+        uint64_t userData;
+        uint64_t physical;
+        uint32_t readers;   // 编译时的引用计数
+        uint32_t firstUse;
+        uint32_t lastUse;
+        uint64_t heapOffset;
+        uint32_t heapGroup;
+        FrameGraphResource aliasPredecessor;
+    };
+
+    struct Pass {
+        const char* name;
+        ExecuteFn execute;
+        bool sideEffect;
+        bool culled;
+        uint32_t writes;    // 编译时的引用计数
+        uint32_t position;  // 在执行顺序中的位置
+        size_t firstAccess;
+        size_t accessCount;
+        size_t firstTransition;
+        size_t transitionCount;
+    };
+
+    void AddAccess(uint32_t pass, FrameGraphResource resource, uint32_t state, bool write);
+    void CullPasses();
+    void ComputeLifetimes();
+    void ComputeTransitions();
+
+    // 编译时按执行位置排序的转换；同一位置上 Begin 排在这个 Pass 自己的转换前面
+    struct PlacedTransition {
+        uint32_t position;
+        Transition transition;
+    };
+
+    std::vector<Resource> m_resources;
+    std::vector<Pass> m_passes;
+    std::vector<Access> m_accesses; // 按 Pass 声明顺序排列
+    std::vector<uint32_t> m_order;
+    std::vector<Transition> m_transitions;
+    std::vector<FrameGraphResource> m_cullStack;
+    std::vector<AliasingRequest> m_aliasingRequests;
+    std::vector<FrameGraphResource> m_aliasedResources;
+    std::vector<uint32_t> m_currentStates;
+    std::vector<uint32_t> m_lastUsePositions;
+    std::vector<PlacedTransition> m_placedTransitions;
+    AliasingPlan m_aliasing;
+    bool m_compiled = false;
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "GpuTimeline.h"
+
+// N 帧并行（frames in flight）的帧槽环。
+// 每个帧槽记录最后一次提交的 fence 值，CPU 只有在回到一个 GPU 仍在使用的帧槽时才等待，
+// 这样 CPU 录制第 N+1 帧可以和 GPU 执行第 N 帧重叠。
+class FrameRing {
+public:
+    FrameRing(IGpuTimeline& timeline, uint32_t frameCount);
+
+    // 开始一帧：必要时等待当前帧槽的 GPU 工作完成，返回帧槽索引
+    uint32_t BeginFrame();
+
+    // 结束一帧：发信号并把 fence 值记到当前帧槽上，然后前进到下一个帧槽
+    uint64_t EndFrame();
+
+    // 等待所有帧槽完成（关闭或重建资源前调用）
+    void WaitForIdle();
+
+    uint32_t GetFrameCount() const { return static_cast<uint32_t>(m_slotFenceValues.size()); }
+    uint32_t GetCurrentSlot() const { return m_currentSlot; }
+    uint64_t GetFrameNumber() const { return m_frameNumber; }
+
+    // BeginFrame 中真正阻塞等待的次数
+    uint64_t GetStallCount() const { return m_stallCount; }
+
+private:
+    IGpuTimeline& m_timeline;
+    std::vector<uint64_t> m_slotFenceValues;
+    uint32_t m_currentSlot = 0;
+    uint64_t m_frameNumber = 0;
+    uint64_t m_stallCount = 0;
+};
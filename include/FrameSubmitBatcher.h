@@ -0,0 +1,46 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <memory_resource>
+#include <vector>
+#include "CommandListPool.h"
+#include "QueueScheduler.h"
+
+// 收集一帧内产生的所有命令列表（清屏、绘制、呈现屏障……），
+// 在 Present 之前按加入顺序一次 ExecuteCommandLists 提交。
+// 提交经过 QueueScheduler，这一帧声明过的跨队列依赖会在提交之前插入等待。
+class FrameSubmitBatcher {
+public:
+    struct Stats {
+        uint32_t submissions = 0;  // ExecuteCommandLists 调用次数
+        uint32_t commandLists = 0; // 提交的命令列表数
+    };
+
+    FrameSubmitBatcher(QueueScheduler& scheduler, GpuQueue queue);
+
+    // 加入一个已经关闭的命令列表
+    void Add(CommandContext&& context);
+    void Add(std::pmr::vector<CommandContext>&& contexts);
+
+    // 把还没提交的命令列表一次提交，返回完成点（没有可提交的列表时返回上一次的）
+    GpuSyncPoint Flush();
+
+    // 帧结束：把本帧所有命令列表带着 fence 值还给池，并滚动统计
+    void EndFrame(CommandListPool& pool, uint64_t fenceValue);
+
+    const Stats& GetFrameStats() const { return m_frameStats; }         // 当前帧
+    const Stats& GetLastFrameStats() const { return m_lastFrameStats; } // 上一帧
+    uint64_t GetTotalSubmissions() const { return m_totalSubmissions; }
+
+private:
+    QueueScheduler& m_scheduler;
+    GpuQueue m_queue;
+    GpuSyncPoint m_lastSubmission;
+    std::vector<CommandContext> m_contexts;  // 本帧所有命令列表
+    size_t m_firstUnsubmitted = 0;
+    std::vector<ID3D12CommandList*> m_submitScratch;
+
+    Stats m_frameStats;
+    Stats m_lastFrameStats;
+    uint64_t m_totalSubmissions = 0;
+};
@@ -0,0 +1,29 @@
+#pragma once
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// 不持有可调用对象的函数引用：只存对象地址和一个调用跳板，构造和调用都不分配内存。
+// std::function 在捕获超过实现的内联缓冲（libstdc++ 是 16 字节）时会堆分配，每帧都构造的回调用它代替。
+// 被引用的对象必须活得比 FunctionRef 久；作为参数直接传 lambda 时临时对象活到调用结束，正好满足。
+template <typename Signature>
+class FunctionRef;
+
+template <typename R, typename... Args>
+class FunctionRef<R(Args...)> {
+public:
+    template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, FunctionRef>>>
+    FunctionRef(F&& fn)
+        : m_object(const_cast<void*>(static_cast<const void*>(std::addressof(fn))))
+        , m_invoke([](void* object, Args... args) -> R {
+            return (*static_cast<std::remove_reference_t<F>*>(object))(std::forward<Args>(args)...);
+        })
+    {
+    }
+
+    R operator()(Args... args) const { return m_invoke(m_object, std::forward<Args>(args)...); }
+
+private:
+    void* m_object;
+    R (*m_invoke)(void*, Args...);
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <functional>
+#include <mutex>
+#include "CommandStream.h"
+#include "DeferredReleaseQueue.h"
+#include "HeapManager.h"
+#include "TlsfAllocator.h"
+#include "UploadEngine.h"
+
+// 网格在几何池里的位置。绘制只需要 DrawIndexed(indexCount, 1, startIndex, baseVertex)
+struct MeshHandle {
+    uint32_t baseVertex = 0;
+    uint32_t vertexCount = 0;
+    uint32_t startIndex = 0;
+    uint32_t indexCount = 0;
+    TlsfAllocator::Allocation vertexRange; // 以顶点为单位
+    TlsfAllocator::Allocation indexRange;  // 以索引为单位
+
+    bool IsValid() const { return vertexRange.IsValid(); }
+};
+
+// 静态几何的大缓冲区：一个顶点缓冲区、一个 32 位索引缓冲区，都在默认堆上。
+// 网格用 TLSF 在里面分配区间（以顶点/索引为单位，所以不需要额外对齐），数据经复制队列上传。
+// 整个池每个命令列表只绑定一次，网格之间只差 baseVertex / startIndex，也方便以后做间接绘制。
+// 两个缓冲区不交给状态跟踪器：缓冲区在图形队列上从 COMMON 隐式提升为只读状态，
+// 提交结束后退回 COMMON，所以复制队列可以随时往没在使用的区间里写新网格。
+class GeometryPool {
+public:
+    struct Stats {
+        uint32_t meshCount = 0;
+        uint64_t verticesUsed = 0;
+        uint64_t indicesUsed = 0;
+        double vertexFragmentation = 0.0;
+        double indexFragmentation = 0.0;
+    };
+
+    GeometryPool(
+        HeapManager& heapManager,
+        UploadEngine& uploadEngine,
+        DeferredReleaseQueue& releaseQueue,
+        IGpuTimeline& graphicsTimeline,
+        uint32_t vertexStride,
+        uint32_t maxVertices,
+        uint32_t maxIndices
+    );
+    ~GeometryPool();
+
+    GeometryPool(const GeometryPool&) = delete;
+    GeometryPool& operator=(const GeometryPool&) = delete;
+
+    // 分配区间并异步上传；池满时抛出异常
+    MeshHandle AddMesh(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount);
+
+    // 区间在图形队列用完之后才回到分配器
+    void RemoveMesh(MeshHandle& mesh);
+
+    // 录制整个池的顶点和索引缓冲区绑定
+    void Bind(CommandStream& stream) const;
+
+    // 池析构、两个缓冲区释放之前对每个缓冲区调用 callback（比如作废引用它们的 bundle）
+    void SetReleaseCallback(std::function<void(ID3D12Resource*)> callback) { m_releaseCallback = std::move(callback); }
+
+    // consumer 队列这一帧要从池里绘制：还有没完成的上传时让它等复制队列
+    void PrepareForDraw(GpuQueue consumer);
+
+    ID3D12Resource* GetVertexBuffer() const { return m_vertexBuffer.resource.Get(); }
+    ID3D12Resource* GetIndexBuffer() const { return m_indexBuffer.resource.Get(); }
+    D3D12_VERTEX_BUFFER_VIEW GetVertexBufferView() const;
+    D3D12_INDEX_BUFFER_VIEW GetIndexBufferView() const;
+    Stats GetStats() const;
+
+private:
+    HeapManager& m_heapManager;
+    UploadEngine& m_uploadEngine;
+    DeferredReleaseQueue& m_releaseQueue;
+    IGpuTimeline& m_graphicsTimeline;
+    uint32_t m_vertexStride;
+    uint32_t m_maxVertices;
+    uint32_t m_maxIndices;
+
+    HeapAllocation m_vertexBuffer;
+    HeapAllocation m_indexBuffer;
+    std::function<void(ID3D12Resource*)> m_releaseCallback;
+
+    mutable std::mutex m_mutex;
+    TlsfAllocator m_vertexAllocator;
+    TlsfAllocator m_indexAllocator;
+    uint32_t m_meshCount = 0;
+};
@@ -0,0 +1,101 @@
+#pragma once
+#include <d3d12.h>
+#include <dxgi1_6.h>
+#include <wrl.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+// 显存分配的用途，用于分类统计
+enum class GpuMemoryCategory {
+    Vertex,
+    Index,
+    Buffer,       // 其他默认堆缓冲区
+    Texture,
+    RenderTarget, // 渲染目标和深度模板
+    Upload,
+    Readback,
+    Heap,         // 给放置资源预留的 ID3D12Heap
+    Count
+};
+
+const char* GetGpuMemoryCategoryName(GpuMemoryCategory category);
+
+// 进程的本地显存预算（IDXGIAdapter3::QueryVideoMemoryInfo）
+struct GpuMemoryBudget {
+    uint64_t budget = 0;       // 操作系统给这个进程的预算，0 表示拿不到
+    uint64_t currentUsage = 0; // 进程当前实际占用
+    uint64_t trackedBytes = 0; // 经过跟踪器创建、还活着的堆和提交资源
+
+    uint64_t GetAvailable() const { return budget > currentUsage ? budget - currentUsage : 0; }
+};
+
+// 显存分配的记账层。所有 CreateCommittedResource / CreatePlacedResource / CreateHeap 都经过它，
+// 按用途统计存活字节数、峰值和分配次数。创建出来的对象上挂一个私有数据接口
+// （SetPrivateDataInterface），对象销毁时运行时释放它，记账随之扣除，调用方不需要报告释放。
+// 放置资源计入自己的类别，但不计入总量：它的内存已经算在所在的堆里。
+// 预算查询让引擎在显存耗尽之前主动降级（少加载几级 mip、缩小缓存……）。可以在多个线程上同时使用。
+class GpuMemoryTracker {
+public:
+    struct CategoryStats {
+        uint64_t liveBytes = 0;
+        uint64_t peakBytes = 0;
+        uint32_t liveCount = 0;
+        uint64_t allocations = 0; // 累计分配次数
+    };
+
+    // adapter 为空时拿不到预算，CanAllocate 总是返回 true
+    GpuMemoryTracker(ID3D12Device* device, IDXGIAdapter3* adapter);
+
+    GpuMemoryTracker(const GpuMemoryTracker&) = delete;
+    GpuMemoryTracker& operator=(const GpuMemoryTracker&) = delete;
+
+    // 和 ID3D12Device 的同名方法一样，多一个用途参数
+    HRESULT CreateCommittedResource(
+        GpuMemoryCategory category,
+        const D3D12_HEAP_PROPERTIES* heapProperties,
+        D3D12_HEAP_FLAGS heapFlags,
+        const D3D12_RESOURCE_DESC* desc,
+        D3D12_RESOURCE_STATES initialState,
+        const D3D12_CLEAR_VALUE* clearValue,
+        REFIID riid,
+        void** resource
+    );
+    HRESULT CreatePlacedResource(
+        GpuMemoryCategory category,
+        ID3D12Heap* heap,
+        UINT64 heapOffset,
+        const D3D12_RESOURCE_DESC* desc,
+        D3D12_RESOURCE_STATES initialState,
+        const D3D12_CLEAR_VALUE* clearValue,
+        REFIID riid,
+        void** resource
+    );
+    HRESULT CreateHeap(const D3D12_HEAP_DESC* desc, REFIID riid, void** heap);
+
+    CategoryStats GetStats(GpuMemoryCategory category) const;
+    uint64_t GetTrackedBytes() const;     // 堆和提交资源的总量
+    uint64_t GetPeakTrackedBytes() const;
+
+    GpuMemoryBudget QueryBudget() const;
+    // 再分配 bytes 之后是否还在预算内
+    bool CanAllocate(uint64_t bytes) const;
+
+private:
+    // 记账数据由跟踪器和所有存活的私有数据令牌共享，跟踪器先销毁时令牌仍然可以安全地扣除
+    struct Ledger {
+        std::mutex mutex;
+        CategoryStats categories[static_cast<size_t>(GpuMemoryCategory::Count)];
+        uint64_t trackedBytes = 0;
+        uint64_t peakTrackedBytes = 0;
+
+        void Add(GpuMemoryCategory category, uint64_t bytes, bool placed);
+        void Remove(GpuMemoryCategory category, uint64_t bytes, bool placed);
+    };
+
+    HRESULT Track(HRESULT hr, void** object, GpuMemoryCategory category, uint64_t bytes, bool placed);
+
+    Microsoft::WRL::ComPtr<ID3D12Device> m_device;
+    Microsoft::WRL::ComPtr<IDXGIAdapter3> m_adapter;
+    std::shared_ptr<Ledger> m_ledger;
+};
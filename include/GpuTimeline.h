@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+
+// GPU 时间线的抽象：队列尾部发信号 + 查询已完成的值。
+// 帧环、命令列表池等只依赖这个接口，无 GPU 时可以用模拟实现替换。
+class IGpuTimeline {
+public:
+    virtual ~IGpuTimeline() = default;
+
+    // 在队列尾部发信号，返回本次信号的值
+    virtual uint64_t Signal() = 0;
+
+    // 最近一次 Signal 的值
+    virtual uint64_t GetLastSignaledValue() const = 0;
+
+    // GPU 已经完成的最大值
+    virtual uint64_t GetCompletedValue() = 0;
+
+    // CPU 阻塞，直到 value 完成
+    virtual void WaitForValue(uint64_t value) = 0;
+
+    // value 完成后执行 callback，不在调用线程上同步执行
+    virtual void OnCompleted(uint64_t value, std::function<void()> callback) = 0;
+
+    bool IsComplete(uint64_t value) { return GetCompletedValue() >= value; }
+};
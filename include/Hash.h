@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// FNV-1a 64 位哈希，结果与平台和运行次数无关，可以作为缓存键
+const uint64_t HASH_SEED = 14695981039346656037ull;
+
+inline uint64_t HashBytes(const void* data, size_t size, uint64_t seed = HASH_SEED)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// 对 POD 值求哈希
+template <typename T>
+inline uint64_t HashValue(const T& value, uint64_t seed = HASH_SEED)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "HashValue needs a POD type");
+    return HashBytes(&value, sizeof(T), seed);
+}
+
+inline uint64_t HashCombine(uint64_t seed, uint64_t value)
+{
+    return HashValue(value, seed);
+}
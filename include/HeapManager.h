@@ -0,0 +1,81 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "TlsfAllocator.h"
+#include "GpuMemoryTracker.h"
+
+// 放置资源和它在堆里占用的区间
+struct HeapAllocation {
+    Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+    uint32_t heapIndex = 0xffffffffu;
+    TlsfAllocator::Allocation range;
+
+    bool IsValid() const { return range.IsValid(); }
+};
+
+// 按堆类型和资源类别预留大块 ID3D12Heap，用 TLSF 在里面放置资源，
+// 代替每个资源一次 CreateCommittedResource 带来的隐式堆。
+// 缓冲区、渲染目标/深度纹理、其他纹理分开放（兼容资源堆 Tier 1），
+// 对齐取 GetResourceAllocationInfo 的结果（64KB，多重采样纹理 4MB）。
+// 超过块大小的资源单独占一个堆。可以在多个线程上同时使用。
+class HeapManager {
+public:
+    struct Stats {
+        uint32_t heapCount = 0;
+        uint64_t reservedBytes = 0;  // 所有堆的大小
+        uint64_t usedBytes = 0;
+        uint32_t allocationCount = 0;
+        double fragmentation = 0.0;  // 各堆碎片率按堆大小加权
+    };
+
+    HeapManager(ID3D12Device* device, GpuMemoryTracker& memoryTracker, uint64_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    HeapManager(const HeapManager&) = delete;
+    HeapManager& operator=(const HeapManager&) = delete;
+
+    // category 只用于显存统计
+    HeapAllocation CreateResource(
+        GpuMemoryCategory category,
+        D3D12_HEAP_TYPE heapType,
+        const D3D12_RESOURCE_DESC& desc,
+        D3D12_RESOURCE_STATES initialState,
+        const D3D12_CLEAR_VALUE* clearValue = nullptr
+    );
+
+    // 释放资源并归还区间；调用方要保证 GPU 已经不再使用它
+    void Free(HeapAllocation& allocation);
+
+    // 释放已经完全空闲的堆（保留每个类别的第一个）
+    void Trim();
+
+    Stats GetStats() const;
+
+    static const uint64_t DEFAULT_BLOCK_SIZE = 64ull * 1024 * 1024;
+
+private:
+    enum class ResourceClass {
+        Buffer,
+        RenderTargetTexture,
+        OtherTexture
+    };
+
+    struct HeapBlock {
+        Microsoft::WRL::ComPtr<ID3D12Heap> heap;
+        D3D12_HEAP_TYPE heapType;
+        ResourceClass resourceClass;
+        uint64_t alignment;
+        std::unique_ptr<TlsfAllocator> allocator;
+    };
+
+    static ResourceClass Classify(const D3D12_RESOURCE_DESC& desc);
+    uint32_t CreateHeapBlock(D3D12_HEAP_TYPE heapType, ResourceClass resourceClass, uint64_t size, uint64_t alignment);
+
+    Microsoft::WRL::ComPtr<ID3D12Device> m_device;
+    GpuMemoryTracker& m_memoryTracker;
+    uint64_t m_blockSize;
+    mutable std::mutex m_mutex;
+    std::vector<HeapBlock> m_heaps; // 释放掉的堆留下空位，下标保持不变
+};
@@ -0,0 +1,38 @@
+#pragma once
+#include <d3d12.h>
+#include <memory_resource>
+#include <vector>
+#include "CommandListPool.h"
+#include "FunctionRef.h"
+#include "WorkerPool.h"
+
+// 把一帧的绘制列表切成若干块，每块在工作线程上录制到自己的池化命令列表里，
+// 按块的顺序返回，由调用方（FrameSubmitBatcher）和这一帧的其他命令列表一起提交。
+class ParallelCommandRecorder {
+public:
+    // 录制第 chunk 块，即 [first, first + count) 这段绘制；每个命令列表的状态是独立的，
+    // 回调需要自己设置根签名、渲染目标、视口等状态。只引用调用方的 lambda，每帧构造也不分配
+    using RecordChunkFn = FunctionRef<void(ID3D12GraphicsCommandList* list, size_t chunk, size_t first, size_t count)>;
+
+    // 给定绘制数量时会切成多少块，调用方可以据此预先准备每块的录制内存
+    size_t GetChunkCount(size_t drawCount, size_t minDrawsPerChunk) const;
+
+    ParallelCommandRecorder(CommandListPool& pool, WorkerPool& workers);
+
+    // 每块至少 minDrawsPerChunk 个绘制，块数不超过线程数（含调用线程）。
+    // 返回按块顺序排列、已经关闭的命令列表，数组从 memory 分配（通常是帧分配器）
+    std::pmr::vector<CommandContext> Record(
+        size_t drawCount,
+        size_t minDrawsPerChunk,
+        ID3D12PipelineState* initialState,
+        RecordChunkFn recordChunk,
+        std::pmr::memory_resource* memory = std::pmr::get_default_resource()
+    );
+
+    size_t GetLastChunkCount() const { return m_lastChunkCount; }
+
+private:
+    CommandListPool& m_pool;
+    WorkerPool& m_workers;
+    size_t m_lastChunkCount = 0;
+};
@@ -0,0 +1,97 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// 真正创建 PSO 的一方。无 GPU 时可以用模拟实现替换（测试、基准）
+class IPipelineStateCreator {
+public:
+    virtual ~IPipelineStateCreator() = default;
+
+    virtual HRESULT CreateGraphicsPipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, ID3D12PipelineState** pipeline) = 0;
+};
+
+// 直接调用 ID3D12Device::CreateGraphicsPipelineState
+class DevicePipelineStateCreator : public IPipelineStateCreator {
+public:
+    explicit DevicePipelineStateCreator(ID3D12Device* device) : m_device(device) {}
+
+    HRESULT CreateGraphicsPipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, ID3D12PipelineState** pipeline) override
+    {
+        return m_device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(pipeline));
+    }
+
+private:
+    Microsoft::WRL::ComPtr<ID3D12Device> m_device;
+};
+
+// 图形 PSO 的内存缓存。键是整个描述逐字段写出的规范字节串：着色器字节码取内容哈希，
+// 输入布局按语义名的内容，混合、光栅化、深度模板、渲染目标格式、采样描述等按值，
+// 没用到的部分（关闭独立混合时的其余渲染目标、NumRenderTargets 之后的格式、CachedPSO）不参与，
+// 所以不受结构体填充和指针地址影响；根签名按对象身份比较，条目持有它的引用，
+// 根签名重建时旧地址不会被新对象复用，也就不会命中为旧根签名创建的 PSO。
+// 相同的描述总是得到同一个 ID3D12PipelineState。命中时的查找不加锁：
+// 表的槽位是原子指针，条目发布后不再修改，扩容时发布新表、旧表保留到缓存销毁；
+// 只有未命中时才在锁里创建和插入。PSO 由缓存持有，直到缓存销毁。
+class PipelineStateCache {
+public:
+    struct Stats {
+        uint64_t lookups = 0;
+        uint64_t hits = 0;
+        uint64_t creations = 0; // 实际创建的 PSO 数
+    };
+
+    explicit PipelineStateCache(IPipelineStateCreator& creator);
+
+    PipelineStateCache(const PipelineStateCache&) = delete;
+    PipelineStateCache& operator=(const PipelineStateCache&) = delete;
+
+    // 创建失败时抛异常
+    ID3D12PipelineState* GetOrCreate(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+
+    size_t GetSize() const;
+    Stats GetStats() const;
+
+    // 描述的规范字节串和它的哈希，结果与运行次数无关（根签名地址除外）
+    static void BuildKey(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, std::vector<uint8_t>& key);
+    static uint64_t HashKey(const std::vector<uint8_t>& key);
+
+private:
+    static constexpr size_t INITIAL_CAPACITY = 64; // 2 的幂
+
+    struct Entry {
+        uint64_t hash;
+        std::vector<uint8_t> key;
+        Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature; // 键里只有地址，持有引用保证地址不被复用
+        Microsoft::WRL::ComPtr<ID3D12PipelineState> pipeline;
+    };
+
+    struct Table {
+        explicit Table(size_t capacity) : slots(new std::atomic<Entry*>[capacity]), mask(capacity - 1)
+        {
+            for (size_t i = 0; i < capacity; i++) {
+                slots[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        std::unique_ptr<std::atomic<Entry*>[]> slots;
+        size_t mask;
+    };
+
+    static Entry* Find(const Table& table, uint64_t hash, const std::vector<uint8_t>& key);
+    static void Insert(Table& table, Entry* entry);
+
+    IPipelineStateCreator& m_creator;
+    std::atomic<Table*> m_table{ nullptr };
+
+    std::mutex m_insertMutex;                   // 只有未命中时才用
+    std::vector<std::unique_ptr<Table>> m_tables; // 包括已经被替换的表，读者可能还在用
+    std::vector<std::unique_ptr<Entry>> m_entries;
+
+    std::atomic<uint64_t> m_lookups{ 0 };
+    std::atomic<uint64_t> m_hits{ 0 };
+    std::atomic<uint64_t> m_creations{ 0 };
+};
@@ -0,0 +1,24 @@
+#pragma once
+#include <d3d12.h>
+#include <atomic>
+#include <functional>
+
+// 挂在 D3D12 对象上的私有数据接口（SetPrivateDataInterface）。
+// 对象持有令牌的唯一引用，对象销毁时运行时释放它，令牌随之执行回调，
+// 这样不用接管对象的所有权也能知道它什么时候销毁。回调在最后释放对象的线程上执行，
+// 只应该碰和令牌共享的状态（shared_ptr），不能假设创建令牌的对象还活着。
+class PrivateDataToken final : public IUnknown {
+public:
+    // 把令牌挂到 object 上；挂不上时令牌在这里就释放，回调立即执行
+    static void Attach(ID3D12Object* object, REFGUID guid, std::function<void()> onRelease);
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) override;
+    ULONG STDMETHODCALLTYPE AddRef() override { return ++m_refCount; }
+    ULONG STDMETHODCALLTYPE Release() override;
+
+private:
+    explicit PrivateDataToken(std::function<void()> onRelease) : m_onRelease(std::move(onRelease)) {}
+
+    std::atomic<ULONG> m_refCount{ 1 };
+    std::function<void()> m_onRelease;
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include <d3d12.h>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include "FenceTimeline.h"
+
+enum class GpuQueue : uint32_t {
+    Graphics = 0,
+    Compute,
+    Copy,
+    Count
+};
+
+// 某个队列上的一次提交完成时的 fence 值
+struct GpuSyncPoint {
+    GpuQueue queue = GpuQueue::Graphics;
+    uint64_t value = 0; // 0 表示没有提交过
+
+    bool IsValid() const { return value != 0; }
+};
+
+// 管理多个命令队列的提交和队列之间的同步。
+// 每个队列有自己的 FenceTimeline；跨队列的 Wait 只在调用方声明了依赖时才插入，
+// 并且跳过同一队列（队列本身有序）、GPU 已经完成的值和之前已经等过的值。
+// 每次提交完成时通过 OnCompleted 回调累计队列的忙碌时间，用来观察队列之间的重叠。
+class QueueScheduler {
+public:
+    struct QueueStats {
+        uint64_t submissions = 0;
+        uint64_t commandLists = 0;
+        uint64_t waitsIssued = 0;   // 实际插入的跨队列 Wait
+        uint64_t waitsSkipped = 0;  // 因为已经满足而省略的 Wait
+        double busySeconds = 0.0;   // 提交到完成的时间（同一队列上的重叠部分只算一次）
+    };
+
+    // 队列的时间线要比调度器活得久：调度器析构之前不能有还没执行的完成回调
+    void RegisterQueue(GpuQueue queue, FenceTimeline& timeline);
+
+    // 下一次在 queue 上提交之前等待 point 完成
+    void AddDependency(GpuQueue queue, const GpuSyncPoint& point);
+
+    // 插入待处理的等待，提交命令列表并发信号，返回这次提交的完成点
+    GpuSyncPoint Submit(GpuQueue queue, ID3D12CommandList* const* commandLists, UINT count);
+
+    FenceTimeline& GetTimeline(GpuQueue queue) const;
+    GpuSyncPoint GetLastSubmission(GpuQueue queue) const;
+    QueueStats GetStats(GpuQueue queue) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static const size_t QUEUE_COUNT = static_cast<size_t>(GpuQueue::Count);
+
+    struct QueueState {
+        FenceTimeline* timeline = nullptr;
+        uint64_t pendingWaits[QUEUE_COUNT] = {}; // 下次提交前要等的各队列的值
+        uint64_t waitedValues[QUEUE_COUNT] = {}; // 已经在这个队列上等过的各队列的值
+        Clock::time_point lastCompletion;
+        QueueStats stats;
+    };
+
+    void OnSubmissionCompleted(GpuQueue queue, Clock::time_point submitTime);
+
+    QueueState& GetQueue(GpuQueue queue);
+    const QueueState& GetQueue(GpuQueue queue) const;
+
+    QueueState m_queues[QUEUE_COUNT];
+    mutable std::mutex m_mutex;
+};
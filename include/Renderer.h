@@ -12,12 +12,43 @@
 #include <iostream>
 #include <DirectXMath.h>
 #include <d3dcompiler.h>
+#include <memory>
+#include <functional>
+#include "FenceTimeline.h"
+#include "QueueScheduler.h"
+#include "UploadEngine.h"
+#include "UploadRing.h"
+#include "FrameArena.h"
+#include "GpuMemoryTracker.h"
+#include "HeapManager.h"
+#include "DescriptorAllocator.h"
+#include "DynamicDescriptorHeap.h"
+#include "DescriptorViewCache.h"
+#include "PipelineStateCache.h"
+#include "DeferredReleaseQueue.h"
+#include "GeometryPool.h"
+#include "FrameRing.h"
+#include "CommandListPool.h"
+#include "WorkerPool.h"
+#include "ParallelCommandRecorder.h"
+#include "FrameSubmitBatcher.h"
+#include "CommandStream.h"
+#include "BundleCache.h"
+#include "StateFilteredCommandList.h"
+#include "ResourceStateTracker.h"
+#include "FrameGraph.h"
+#include "TransientResourceHeap.h"
 
 class Renderer {
 public:
+    ~Renderer();
+
     void Initialize(HWND hwnd);
     void Render();
 
+    // 设置同时在 GPU 上飞行的帧数（1 ~ MAX_FRAMES_IN_FLIGHT），需在 Initialize 之前调用
+    void SetFramesInFlight(UINT count);
+
     // 使这些函数可以在外部调用
     void LoadShaders();
     void CreateDescriptorHeaps();
@@ -30,7 +61,64 @@ public:
     void CreateFence();
     std::wstring GetShaderPath(const std::wstring& shaderName) const;
 
+    // 上一帧的提交次数和命令列表数
+    const FrameSubmitBatcher::Stats& GetLastFrameSubmitStats() const;
+
+    // 上一帧状态设置的发出次数和被省略的冗余次数
+    const StateFilteredCommandList::Stats& GetLastFrameStateFilterStats() const;
+
+    // 在计算队列上录制并立即提交独立的计算工作（剔除、粒子、后处理……），返回完成点。
+    // 图形队列只有在用到结果时才需要 AddGraphicsDependency，否则两个队列并行执行
+    GpuSyncPoint SubmitAsyncCompute(const std::function<void(ID3D12GraphicsCommandList*)>& record);
+    void AddGraphicsDependency(const GpuSyncPoint& point); // 本帧图形提交前等待 point
+
+    // 队列的提交、等待次数和忙碌时间
+    QueueScheduler::QueueStats GetQueueStats(GpuQueue queue) const;
+
+    // 帧分配器的峰值用量和溢出次数
+    const FrameArena::Stats& GetFrameArenaStats() const;
+
+    // 渲染图临时资源的堆大小，以及和各自用提交资源分配相比节省的显存
+    const TransientResourceHeap::Stats& GetTransientHeapStats() const;
+
+    // 按用途的显存统计和进程的显存预算，预算紧张时可以据此降级（少加载 mip 等）
+    GpuMemoryTracker::CategoryStats GetGpuMemoryStats(GpuMemoryCategory category) const;
+    GpuMemoryBudget QueryGpuMemoryBudget() const;
+
+    // 某种类型的 CPU 描述符分配器，可以在加载线程上创建视图
+    DescriptorAllocator& GetDescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE type);
+
+    // 着色器可见的全局描述符表：长期存在的视图复制进常驻区，返回着色器里用的下标
+    uint32_t RegisterBindlessDescriptor(D3D12_CPU_DESCRIPTOR_HANDLE source);
+    void ReleaseBindlessDescriptor(uint32_t index); // 飞行中的帧用完之后才会复用
+
+    // 去重的 SRV / CBV：相同 (资源, 视图描述) 共用一个描述符，返回的视图已经在全局表里
+    DescriptorViewCache& GetDescriptorViewCache();
+    DescriptorViewCache::Stats GetDescriptorViewCacheStats() const;
+
+    // PSO 缓存的查找、命中和实际创建次数
+    PipelineStateCache::Stats GetPipelineStateCacheStats() const;
+
+    // 着色器可见描述符堆上表的复制、复用次数、环的占用峰值和常驻描述符数
+    DynamicDescriptorHeap::Stats GetDynamicDescriptorStats() const;
+
 private:
+    static const UINT FRAME_COUNT = 2; // 假设交换链有两个后台缓冲区
+    static const UINT MAX_FRAMES_IN_FLIGHT = 3;
+    static const UINT64 UPLOAD_RING_BYTES_PER_FRAME = 2 * 1024 * 1024;
+    static const size_t FRAME_ARENA_BYTES_PER_FRAME = 256 * 1024;
+    static const UINT GEOMETRY_POOL_MAX_VERTICES = 1 << 20;
+    static const UINT GEOMETRY_POOL_MAX_INDICES = 1 << 21;
+    static const UINT PERSISTENT_DESCRIPTOR_CAPACITY = 1 << 16;
+    static const UINT DYNAMIC_DESCRIPTOR_CAPACITY = 1 << 16;
+
+    // 根参数的位置
+    enum RootParameter : UINT {
+        ROOT_DRAW_CONSTANTS, // b0：每次绘制的根常量（全局表里的下标）
+        ROOT_BINDLESS_TABLE, // t0, space1：全局的无界 SRV 数组
+        ROOT_PARAMETER_COUNT
+    };
+
     UINT m_width = 800;  // 窗口宽度
     UINT m_height = 600; // 窗口高度
     UINT m_swapChainBufferCount = 2; // 默认使用双缓冲
@@ -46,27 +134,65 @@ private:
         Microsoft::WRL::ComPtr<ID3DBlob>& errorBlob
     );
 
+    D3D12_CPU_DESCRIPTOR_HANDLE GetCurrentRtv() const;
+    void RecordFrameTargets(CommandStream& stream) const; // 录制渲染目标、视口和裁剪矩形
+    void RecordClearPass();
+    void FlushPendingBarriers(); // 把状态跟踪器里积累的屏障放进单独的命令列表
+    void RecordPresentBarriers(ID3D12GraphicsCommandList* commandList); // Present Pass 的转换放进这一帧最后录制的列表
+
     void ReleaseResources(); // Clean up resources when no longer needed
 
     HRESULT hr;
 
     Microsoft::WRL::ComPtr<ID3D12Device> m_device;
+    std::unique_ptr<GpuMemoryTracker> m_memoryTracker; // 所有资源和堆的创建都经过它记账
     Microsoft::WRL::ComPtr<ID3D12CommandQueue> m_commandQueue;
+    Microsoft::WRL::ComPtr<ID3D12CommandQueue> m_computeQueue; // 异步计算队列
+    Microsoft::WRL::ComPtr<ID3D12CommandQueue> m_copyQueue;    // 异步上传用的复制队列
+    std::unique_ptr<QueueScheduler> m_queueScheduler; // 要比各队列的时间线后析构
     Microsoft::WRL::ComPtr<IDXGISwapChain4> m_swapChain;
+    std::unique_ptr<DevicePipelineStateCreator> m_pipelineCreator;
+    std::unique_ptr<PipelineStateCache> m_pipelineCache; // 按完整描述去重的 PSO 缓存，持有所有创建过的 PSO
     Microsoft::WRL::ComPtr<ID3D12PipelineState> m_pipelineState;
     Microsoft::WRL::ComPtr<ID3D12RootSignature> m_rootSignature;
-    Microsoft::WRL::ComPtr<ID3D12Resource> m_vertexBuffer;
-    Microsoft::WRL::ComPtr<ID3D12CommandAllocator> m_commandAllocator;
-    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_commandList;
+    std::unique_ptr<HeapManager> m_heapManager; // 放置资源用的大块堆
+    std::unique_ptr<GeometryPool> m_geometryPool; // 静态网格的大顶点/索引缓冲区，要比 m_deferredRelease 后析构
+    MeshHandle m_triangleMesh; // 三角形在几何池里的位置
+    std::unique_ptr<CommandListPool> m_commandListPool; // 按 fence 值回收的命令列表池
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_commandList; // 当前正在录制的命令列表
+    std::unique_ptr<WorkerPool> m_workerPool;
+    std::unique_ptr<ParallelCommandRecorder> m_parallelRecorder;
+    std::unique_ptr<FrameSubmitBatcher> m_submitBatcher; // 每帧一次提交
+    CommandStream m_frameStream;                // 清屏命令流
+    std::vector<CommandStream> m_chunkStreams;  // 每个并行录制块一条命令流，跨帧复用
+    CommandStream m_triangleStream;             // 三角形的静态绘制序列
+    std::unique_ptr<BundleCache> m_bundleCache;
+    std::vector<StateFilteredCommandList::Stats> m_chunkStateStats; // 每个并行录制块的状态过滤统计
+    StateFilteredCommandList::Stats m_frameStateStats;
+    StateFilteredCommandList::Stats m_lastFrameStateStats;
     Microsoft::WRL::ComPtr<ID3DBlob> m_vertexShader;
     Microsoft::WRL::ComPtr<ID3DBlob> m_pixelShader;
-    Microsoft::WRL::ComPtr<ID3D12Fence> m_fence;
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_dsvHeap;
-    uint64_t m_fenceValue = 1;
+    std::unique_ptr<FenceTimeline> m_timeline; // 直接队列的 fence 时间线
+    std::unique_ptr<FenceTimeline> m_computeTimeline; // 计算队列的 fence 时间线
+    std::unique_ptr<FenceTimeline> m_copyTimeline;    // 复制队列的 fence 时间线
+    std::unique_ptr<DeferredReleaseQueue> m_deferredRelease; // 按 fence 值延迟释放，要比时间线先析构、比 m_heapManager 先析构
+    std::unique_ptr<UploadEngine> m_uploadEngine;     // 复制队列上的批量上传
+    std::unique_ptr<UploadRing> m_uploadRing;         // 按帧槽分区的持久映射上传环
+    std::unique_ptr<FrameArena> m_frameArena;         // 按帧槽分区的 CPU 线性分配器，放只活一帧的数据
+    std::unique_ptr<FrameRing> m_frameRing;    // 帧槽环
 
-    static const UINT FRAME_COUNT = 2; // 假设交换链有两个后台缓冲区
+    UINT m_framesInFlight = FRAME_COUNT;
     Microsoft::WRL::ComPtr<ID3D12Resource> m_renderTargets[FRAME_COUNT]; // 后台缓冲区数组
-    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_rtvHeap; // RTV 堆
-    UINT m_rtvDescriptorSize = 0; // RTV 描述符大小
+    UINT m_backBufferIndex = 0; // 当前帧的后台缓冲区索引
+    ResourceStateTracker m_stateTracker; // 资源状态跟踪，按提交顺序生成屏障
+    FrameGraph m_frameGraph; // 每帧重建的渲染图
+    uint32_t m_presentPass = 0;
+    std::unique_ptr<TransientResourceHeap> m_transientHeap; // 渲染图临时资源的共享堆，析构时要用到 m_stateTracker
+    std::unique_ptr<DescriptorAllocator> m_descriptorAllocators[D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES]; // 每种类型一个 CPU 描述符分配器
+    DescriptorHandle m_renderTargetViews[FRAME_COUNT]; // 每个后台缓冲区的 RTV
+    DescriptorHandle m_drawDataView; // 每帧改写的绘制常量数组 SRV，复制进着色器可见堆后即可改写
+    std::unique_ptr<DynamicDescriptorHeap> m_dynamicDescriptors; // 唯一的着色器可见 CBV_SRV_UAV 堆
+    std::unique_ptr<DescriptorViewCache> m_viewCache; // 要比描述符分配器和 m_dynamicDescriptors 先析构
 };
 
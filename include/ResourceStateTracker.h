@@ -0,0 +1,73 @@
+#pragma once
+#include <d3d12.h>
+#include <unordered_map>
+#include <vector>
+
+// 按资源（以及子资源）跟踪当前状态，自动生成转换屏障。
+// 调用方只声明接下来需要的状态；同一个刷新点之前积累的屏障会被合并
+// （A->B 再 B->C 合成 A->C，A->B 再 B->A 直接抵消），在 Flush 时用一次 ResourceBarrier 发出。
+// BeginTransition 提前声明将来的状态：如果到真正需要之前中间隔着一次 Flush，
+// 就拆成 BEGIN_ONLY / END_ONLY 两半，让 GPU 在空隙里完成转换（渲染图的 Split::Begin 转换走这里）。
+// 跟踪器要按命令列表的提交顺序在同一个线程上使用。
+class ResourceStateTracker {
+public:
+    struct Stats {
+        uint64_t barriers = 0;       // 发出的屏障数
+        uint64_t barrierCalls = 0;   // ResourceBarrier 调用次数
+        uint64_t merged = 0;         // 被合并或抵消的转换数
+        uint64_t splitBarriers = 0;  // 拆分屏障的对数
+        uint64_t aliasingBarriers = 0; // 别名屏障数
+    };
+
+    // 开始跟踪一个资源；subresourceCount 为 0 时按缓冲区（一个子资源）处理
+    void Register(ID3D12Resource* resource, D3D12_RESOURCE_STATES initialState, UINT subresourceCount = 1);
+    void Unregister(ID3D12Resource* resource);
+
+    // 声明 resource 接下来需要处于 state
+    void Require(ID3D12Resource* resource, D3D12_RESOURCE_STATES state, UINT subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+
+    // 声明 resource 将来会需要 state，可以提前开始转换
+    void BeginTransition(ID3D12Resource* resource, D3D12_RESOURCE_STATES state, UINT subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+
+    // 放置资源开始使用共享的堆内存之前调用；before 为空表示任何与它重叠的资源
+    void Alias(ID3D12Resource* before, ID3D12Resource* after);
+
+    // 把积累的屏障一次发到命令列表上，返回屏障数。
+    // 拆分屏障不能跨命令列表，列表关闭前的最后一次 Flush 要传 closingList = true
+    UINT Flush(ID3D12GraphicsCommandList* commandList, bool closingList = false);
+
+    D3D12_RESOURCE_STATES GetState(ID3D12Resource* resource, UINT subresource = 0) const;
+    bool HasPendingBarriers() const { return !m_pending.empty(); }
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    struct TrackedResource {
+        D3D12_RESOURCE_STATES state = D3D12_RESOURCE_STATE_COMMON; // 所有子资源状态一致时有效
+        std::vector<D3D12_RESOURCE_STATES> subresourceStates;     // 不一致时按子资源保存
+        UINT subresourceCount = 1;
+    };
+
+    // 已经发出 BEGIN_ONLY、还没有结束的拆分转换
+    struct SplitTransition {
+        ID3D12Resource* resource;
+        UINT subresource;
+        D3D12_RESOURCE_STATES before;
+        D3D12_RESOURCE_STATES after;
+        bool begun; // BEGIN_ONLY 是否已经 Flush 出去
+    };
+
+    static bool IsReadOnlyState(D3D12_RESOURCE_STATES state);
+    static bool Satisfies(D3D12_RESOURCE_STATES current, D3D12_RESOURCE_STATES required);
+
+    TrackedResource& GetTracked(ID3D12Resource* resource);
+    // exact 为 true 时要求转换到完全相同的状态，不接受只读状态的组合
+    void TransitionSubresource(ID3D12Resource* resource, UINT subresource, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after, bool exact);
+    void AddTransition(ID3D12Resource* resource, UINT subresource, D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after, D3D12_RESOURCE_BARRIER_FLAGS flags);
+    bool FinishSplit(ID3D12Resource* resource, UINT subresource, D3D12_RESOURCE_STATES state, bool exact);
+    bool HasSplit(ID3D12Resource* resource) const;
+
+    std::unordered_map<ID3D12Resource*, TrackedResource> m_resources;
+    std::vector<D3D12_RESOURCE_BARRIER> m_pending;
+    std::vector<SplitTransition> m_splits;
+    Stats m_stats;
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// 先进先出队列，元素放在一块环形存储里。出队只移动读位置，存储只在放满时成倍扩大、从不缩小，
+// 所以每帧入队出队数量稳定之后不再分配内存（std::deque 每过一个块就要分配和释放一次）。
+// 用来放按 fence 值排队、等 GPU 完成后回收的条目。不是线程安全的。
+template <typename T>
+class RingQueue {
+public:
+    explicit RingQueue(size_t initialCapacity = 16) : m_slots(initialCapacity > 0 ? initialCapacity : 1) {}
+
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_slots.size(); }
+
+    T& front() { return m_slots[m_head]; }
+    const T& front() const { return m_slots[m_head]; }
+    T& back() { return m_slots[Index(m_size - 1)]; }
+    const T& back() const { return m_slots[Index(m_size - 1)]; }
+
+    void push_back(T value)
+    {
+        if (m_size == m_slots.size()) {
+            Grow();
+        }
+        m_slots[Index(m_size)] = std::move(value);
+        m_size++;
+    }
+
+    // 出队的槽位重置成默认值，释放它持有的对象（比如 ComPtr 的引用）
+    void pop_front()
+    {
+        m_slots[m_head] = T();
+        m_head = Index(1);
+        m_size--;
+    }
+
+    void clear()
+    {
+        while (!empty()) {
+            pop_front();
+        }
+        m_head = 0;
+    }
+
+private:
+    size_t Index(size_t offset) const { return (m_head + offset) % m_slots.size(); }
+
+    void Grow()
+    {
+        std::vector<T> slots(m_slots.size() * 2);
+        for (size_t i = 0; i < m_size; i++) {
+            slots[i] = std::move(m_slots[Index(i)]);
+        }
+        m_slots.swap(slots);
+        m_head = 0;
+    }
+
+    std::vector<T> m_slots;
+    size_t m_head = 0;
+    size_t m_size = 0;
+};
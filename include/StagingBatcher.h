@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 一次缓冲区复制：从暂存页 stagingPage 的 stagingOffset 复制 size 字节到 destination 的 destinationOffset。
+// destination 是不透明的句柄（比如 ID3D12Resource 指针），不依赖 D3D12
+struct StagingCopy {
+    uint64_t destination = 0;
+    uint64_t destinationOffset = 0;
+    uint32_t stagingPage = 0;
+    uint64_t stagingOffset = 0;
+    uint64_t size = 0;
+};
+
+// 一段暂存内存：页号、页内偏移和 CPU 地址
+struct StagingSpan {
+    uint32_t page = 0;
+    uint64_t offset = 0;
+    uint8_t* cpuAddress = nullptr;
+};
+
+// Build 按排好的顺序为每个写入要一段暂存内存。同一页里接着分配时，相邻两段应当首尾相接，
+// 这样目标连续的写入在暂存内存里也连续，可以合并成一次复制
+class IStagingAllocator {
+public:
+    virtual ~IStagingAllocator() = default;
+    virtual StagingSpan Allocate(uint64_t size) = 0;
+};
+
+// 把一批小的缓冲区上传整理成尽量少的复制命令。
+// Add 只把数据复制进 CPU 内存；Build 按目标和目标偏移排序，再按这个顺序把数据写进暂存内存，
+// 所以不管提交顺序如何，目标上每一段连续的区间都变成一次复制（暂存内存换页时断开）。
+// 同一目标上有重叠的写入时保持它们的提交顺序，保证后写的数据覆盖先写的。
+class StagingBatcher {
+public:
+    struct Stats {
+        uint64_t requested = 0; // Add 的次数
+        uint64_t emitted = 0;   // Build 输出的复制次数
+    };
+
+    // 把 size 字节的 data 记为写到 destination 的 destinationOffset 处
+    void Add(uint64_t destination, uint64_t destinationOffset, const void* data, uint64_t size);
+
+    // 排序，把数据按顺序写进从 allocator 分配的暂存内存，合并并返回复制列表，结果在下一次 Clear 之前有效
+    const std::vector<StagingCopy>& Build(IStagingAllocator& allocator);
+
+    // 清空待处理的写入和数据，保留容量
+    void Clear();
+
+    size_t GetPendingCount() const { return m_pending.size(); }
+    uint64_t GetPendingBytes() const { return m_data.size(); }
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    struct Pending {
+        uint64_t destination;
+        uint64_t destinationOffset;
+        uint64_t size;
+        uint64_t dataOffset; // 在 m_data 里的位置
+        uint64_t sequence;
+    };
+
+    void EmitGroup(size_t begin, size_t end, IStagingAllocator& allocator);
+
+    std::vector<Pending> m_pending;
+    std::vector<uint8_t> m_data; // 还没写进暂存内存的数据
+    std::vector<StagingCopy> m_copies;
+    Stats m_stats;
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include <d3d12.h>
+
+// ID3D12GraphicsCommandList 前面的状态缓存：同一个命令列表内重复设置相同的状态时直接丢弃，
+// 并统计实际发出和被省略的调用次数。
+// 命令列表 Reset 或者执行了可能修改状态的 bundle 之后要调用 Invalidate。
+class StateFilteredCommandList {
+public:
+    struct Stats {
+        uint64_t issued = 0; // 实际发给命令列表的状态设置
+        uint64_t elided = 0; // 冗余而被省略的状态设置
+
+        Stats& operator+=(const Stats& other)
+        {
+            issued += other.issued;
+            elided += other.elided;
+            return *this;
+        }
+    };
+
+    explicit StateFilteredCommandList(ID3D12GraphicsCommandList* commandList);
+
+    void Invalidate();
+
+    void SetPipelineState(ID3D12PipelineState* pipelineState);
+    void SetGraphicsRootSignature(ID3D12RootSignature* rootSignature);
+    void SetDescriptorHeaps(UINT numHeaps, ID3D12DescriptorHeap* const* heaps);
+    void SetGraphicsRootDescriptorTable(UINT rootIndex, D3D12_GPU_DESCRIPTOR_HANDLE table);
+    void IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY topology);
+    void IASetVertexBuffers(UINT startSlot, UINT numViews, const D3D12_VERTEX_BUFFER_VIEW* views);
+    void IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* view);
+    void RSSetViewports(UINT numViewports, const D3D12_VIEWPORT* viewports);
+    void RSSetScissorRects(UINT numRects, const D3D12_RECT* rects);
+    void OMSetRenderTargets(UINT numRenderTargets, const D3D12_CPU_DESCRIPTOR_HANDLE* rtvs, const D3D12_CPU_DESCRIPTOR_HANDLE* dsv);
+
+    ID3D12GraphicsCommandList* Get() const { return m_commandList; }
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    static const UINT MAX_VERTEX_BUFFERS = 16;
+    static const UINT MAX_VIEWPORTS = 16;
+    static const UINT MAX_RENDER_TARGETS = 8;
+    static const UINT MAX_DESCRIPTOR_HEAPS = 2;  // CBV_SRV_UAV 和 SAMPLER 各一个
+    static const UINT MAX_ROOT_TABLES = 32;
+
+    bool Elide(bool redundant);
+
+    ID3D12GraphicsCommandList* m_commandList;
+    Stats m_stats;
+
+    bool m_pipelineValid = false;
+    ID3D12PipelineState* m_pipelineState = nullptr;
+    bool m_rootSignatureValid = false;
+    ID3D12RootSignature* m_rootSignature = nullptr;
+    // 换根签名或描述符堆之后，之前设置的描述符表都要重新设置
+    UINT m_descriptorHeapCount = 0; // 0 表示未知
+    ID3D12DescriptorHeap* m_descriptorHeaps[MAX_DESCRIPTOR_HEAPS] = {};
+    UINT m_rootTableValidMask = 0;
+    D3D12_GPU_DESCRIPTOR_HANDLE m_rootTables[MAX_ROOT_TABLES] = {};
+    bool m_topologyValid = false;
+    D3D_PRIMITIVE_TOPOLOGY m_topology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+
+    UINT m_vertexBufferValidMask = 0;
+    D3D12_VERTEX_BUFFER_VIEW m_vertexBuffers[MAX_VERTEX_BUFFERS] = {};
+    bool m_indexBufferValid = false;
+    D3D12_INDEX_BUFFER_VIEW m_indexBuffer = {};
+
+    UINT m_viewportCount = 0; // 0 表示未知
+    D3D12_VIEWPORT m_viewports[MAX_VIEWPORTS] = {};
+    UINT m_scissorCount = 0;
+    D3D12_RECT m_scissors[MAX_VIEWPORTS] = {};
+
+    bool m_renderTargetsValid = false;
+    UINT m_renderTargetCount = 0;
+    D3D12_CPU_DESCRIPTOR_HANDLE m_renderTargets[MAX_RENDER_TARGETS] = {};
+    bool m_hasDepthStencil = false;
+    D3D12_CPU_DESCRIPTOR_HANDLE m_depthStencil = {};
+};
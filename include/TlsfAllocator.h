@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// 两级分离适配（TLSF）的区间分配器，只管理偏移，不碰真正的内存，不依赖 D3D12。
+// 第一级按大小的最高位分桶，第二级把每个桶再线性分成 SL_COUNT 份，
+// 两级都有位图，分配和释放都是 O(1)；释放时和物理相邻的空闲块合并。
+// 不是线程安全的，由使用方加锁。
+class TlsfAllocator {
+public:
+    static const uint32_t INVALID_BLOCK = 0xffffffffu;
+
+    struct Allocation {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        uint32_t block = INVALID_BLOCK;
+
+        bool IsValid() const { return block != INVALID_BLOCK; }
+    };
+
+    struct Stats {
+        uint64_t capacity = 0;
+        uint64_t usedBytes = 0;
+        uint64_t freeBytes = 0;
+        uint64_t largestFreeBlock = 0;
+        uint32_t allocationCount = 0;
+        uint32_t freeBlockCount = 0;
+        double fragmentation = 0.0;     // 1 - 最大空闲块 / 总空闲字节，0 表示空闲空间是连续的
+    };
+
+    explicit TlsfAllocator(uint64_t capacity);
+
+    // alignment 要是 2 的幂；空间不够时返回无效的 Allocation
+    Allocation Allocate(uint64_t size, uint64_t alignment = 1);
+    void Free(const Allocation& allocation);
+
+    uint64_t GetCapacity() const { return m_capacity; }
+    uint64_t GetUsedBytes() const { return m_usedBytes; }
+    bool IsEmpty() const { return m_allocationCount == 0; }
+    Stats GetStats() const;
+
+private:
+    static const uint32_t SL_LOG2 = 4;
+    static const uint32_t SL_COUNT = 1u << SL_LOG2;
+    static const uint32_t FL_COUNT = 64;
+
+    struct Block {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        uint32_t prevPhysical = INVALID_BLOCK;
+        uint32_t nextPhysical = INVALID_BLOCK;
+        uint32_t prevFree = INVALID_BLOCK;
+        uint32_t nextFree = INVALID_BLOCK;
+        bool free = false;
+    };
+
+    static void Mapping(uint64_t size, uint32_t& fl, uint32_t& sl);
+    static void MappingSearch(uint64_t size, uint32_t& fl, uint32_t& sl);
+
+    uint32_t NewBlock();
+    void DeleteBlock(uint32_t block);
+    uint32_t FindFreeBlock(uint64_t size);
+    // block 的起点按 alignment 对齐后是否还放得下 size 字节
+    bool Fits(uint32_t block, uint64_t size, uint64_t alignment) const;
+    void InsertFree(uint32_t block);
+    void RemoveFree(uint32_t block);
+    // 从 block 的 offset 开始切出 size 字节，剩下的部分作为新空闲块插到后面
+    void SplitTail(uint32_t block, uint64_t size);
+
+    uint64_t m_capacity;
+    std::vector<Block> m_blocks;
+    std::vector<uint32_t> m_unusedBlocks;
+    uint64_t m_flBitmap = 0;
+    uint32_t m_slBitmaps[FL_COUNT] = {};
+    uint32_t m_freeHeads[FL_COUNT][SL_COUNT];
+    uint64_t m_usedBytes = 0;
+    uint32_t m_allocationCount = 0;
+};
@@ -0,0 +1,97 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <unordered_map>
+#include <vector>
+#include "FrameGraph.h"
+#include "GpuTimeline.h"
+#include "ResourceStateTracker.h"
+#include "DeferredReleaseQueue.h"
+#include "GpuMemoryTracker.h"
+
+// 为渲染图的临时资源（深度预通道、后处理的乒乓目标、阴影贴图……）提供共享的堆内存。
+// CreateTexture / CreateBuffer 把资源描述登记进图里；Compile 之后 Realize 按图给出的偏移
+// 在对应的 ID3D12Heap 上创建放置资源并回填物理资源。资源堆层级 1 的硬件上缓冲区、
+// 渲染目标/深度模板纹理和其他纹理各用一个堆，层级 2 上共用一个堆。堆不够大时按倍数重建（至少翻倍，64KB 对齐）。
+// 同一偏移、同一描述的放置资源跨帧复用，连续 EVICT_AFTER_FRAMES 帧没用到的交给延迟释放队列。
+// 生命周期不重叠的资源共用同一段内存，第一次使用时由 Activate 发出别名屏障。
+class TransientResourceHeap {
+public:
+    struct Stats {
+        uint64_t heapBytes = 0;      // 已经创建的堆的总大小
+        uint64_t requiredBytes = 0;  // 上一帧打包后需要的堆大小
+        uint64_t lowerBoundBytes = 0; // 上一帧同时存活的资源大小之和的峰值，打包结果不可能比它小
+        uint64_t committedBytes = 0; // 上一帧的资源各自用提交资源分配时的总大小
+        uint64_t savedBytes = 0;     // committedBytes - requiredBytes
+        uint32_t resourceCount = 0;  // 上一帧实际用到的临时资源数
+        uint64_t evictedCount = 0;   // 因为长时间没用到而释放的放置资源总数
+    };
+
+    TransientResourceHeap(ID3D12Device* device, GpuMemoryTracker& memoryTracker, IGpuTimeline& timeline, ResourceStateTracker& tracker, DeferredReleaseQueue& releaseQueue);
+    ~TransientResourceHeap();
+
+    TransientResourceHeap(const TransientResourceHeap&) = delete;
+    TransientResourceHeap& operator=(const TransientResourceHeap&) = delete;
+
+    // 每帧重建渲染图之前调用，同时淘汰长时间没用到的放置资源
+    void BeginFrame();
+
+    FrameGraphResource CreateTexture(FrameGraph& graph, const char* name, const D3D12_RESOURCE_DESC& desc);
+    FrameGraphResource CreateBuffer(FrameGraph& graph, const char* name, uint64_t size, D3D12_RESOURCE_FLAGS flags = D3D12_RESOURCE_FLAG_NONE);
+
+    // 在 graph.Compile() 之后调用。某个堆不够大时重建，旧堆等 GPU 用完后释放
+    void Realize(FrameGraph& graph);
+
+    // 临时资源在这一帧第一次使用之前调用；知道之前占用这段内存的资源时只对它发出别名屏障
+    void Activate(const FrameGraph& graph, FrameGraphResource resource);
+
+    uint64_t GetHeapSize() const { return m_stats.heapBytes; }
+    size_t GetResourceCount() const { return m_resources.size(); }
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    enum HeapGroup : uint32_t {
+        HEAP_GROUP_BUFFERS,
+        HEAP_GROUP_RT_DS_TEXTURES,
+        HEAP_GROUP_OTHER_TEXTURES,
+        HEAP_GROUP_COUNT
+    };
+
+    struct Heap {
+        Microsoft::WRL::ComPtr<ID3D12Heap> heap;
+        uint64_t size = 0;
+    };
+
+    struct PlacedResource {
+        Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+        D3D12_RESOURCE_DESC desc;
+        uint64_t offset;
+        uint32_t heapGroup;
+        uint64_t lastUsedFrame;
+    };
+
+    // 放置资源连续这么多帧没用到就释放（不小于最大的帧并行数）
+    static const uint64_t EVICT_AFTER_FRAMES = 8;
+
+    // 逐字段比较和求哈希，不读结构体里的填充字节
+    static uint64_t HashDesc(const D3D12_RESOURCE_DESC& desc);
+    static bool IsSameDesc(const D3D12_RESOURCE_DESC& a, const D3D12_RESOURCE_DESC& b);
+
+    uint32_t GetHeapGroup(const D3D12_RESOURCE_DESC& desc) const;
+    FrameGraphResource Register(FrameGraph& graph, const char* name, const D3D12_RESOURCE_DESC& desc);
+    void GrowHeap(uint32_t heapGroup, uint64_t requiredSize);
+    void ReleaseResources(uint32_t heapGroup);
+    void EvictUnused();
+
+    ID3D12Device* m_device;
+    GpuMemoryTracker& m_memoryTracker;
+    IGpuTimeline& m_timeline;
+    ResourceStateTracker& m_tracker;
+    DeferredReleaseQueue& m_releaseQueue;
+    bool m_sharedHeap = false; // 资源堆层级 2：所有资源放在同一个堆里
+    Heap m_heaps[HEAP_GROUP_COUNT];
+    std::vector<D3D12_RESOURCE_DESC> m_descs; // 这一帧登记的描述，graph 的 userData 是下标
+    std::unordered_multimap<uint64_t, PlacedResource> m_resources; // 以（组，偏移，描述）的哈希为键，命中后再比较描述
+    uint64_t m_frameNumber = 0;
+    Stats m_stats;
+};
@@ -0,0 +1,124 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "CommandListPool.h"
+#include "CompletionTracker.h"
+#include "QueueScheduler.h"
+#include "DeferredReleaseQueue.h"
+#include "StagingBatcher.h"
+#include "GpuMemoryTracker.h"
+
+// 一次上传的凭据。所在批次提交之后就能拿到复制队列上的完成点
+struct UploadTicket {
+    uint64_t batch = 0; // 0 表示无效
+
+    bool IsValid() const { return batch != 0; }
+};
+
+// 复制队列上的异步上传。
+// Upload 只记下数据和要做的复制，不录制、不提交也不等待：缓冲区数据先留在 CPU 内存里，
+// 纹理数据直接写进持久映射的暂存页。Flush 把缓冲区写入按目标排序，按这个顺序写进暂存页，
+// 目标上每段连续的区间合并成一次复制（StagingBatcher），录制到一个命令列表里，
+// 用一次 ExecuteCommandLists 提交到复制队列。
+// 目标资源第一次被某个队列使用之前调用 UseResource，该队列才会等待复制队列的 fence；
+// 每个消费队列各等一次，复制完成之后的使用不再产生任何同步。可以在多个线程上同时调用。
+class UploadEngine {
+public:
+    struct Stats {
+        uint64_t uploads = 0;
+        uint64_t bytes = 0;
+        uint64_t batches = 0;     // 提交到复制队列的次数
+        uint64_t copies = 0;      // 实际录制的复制命令数（合并之后）
+        uint64_t queueWaits = 0;  // 因首次使用而声明的跨队列依赖
+    };
+
+    UploadEngine(ID3D12Device* device, GpuMemoryTracker& memoryTracker, CommandListPool& pool, QueueScheduler& scheduler, DeferredReleaseQueue& releaseQueue);
+    ~UploadEngine();
+
+    UploadEngine(const UploadEngine&) = delete;
+    UploadEngine& operator=(const UploadEngine&) = delete;
+
+    // 把 data 复制到 destination 的 destinationOffset 处；destination 要处于 COMMON 状态
+    // （缓冲区在复制队列上会隐式提升为 COPY_DEST，完成后退回 COMMON）
+    UploadTicket UploadBuffer(ID3D12Resource* destination, uint64_t destinationOffset, const void* data, uint64_t size);
+
+    // 上传纹理的一个子资源；rowPitch 是 data 里相邻两行的字节距离。纹理同样要处于 COMMON 状态
+    UploadTicket UploadTexture(ID3D12Resource* destination, UINT subresource, const void* data, uint64_t rowPitch);
+
+    // 提交所有还没提交的上传
+    void Flush();
+
+    // consumer 队列第一次使用 resource 之前调用：如果它还有没完成的上传，
+    // 让 consumer 在下一次提交前等待复制队列
+    void UseResource(GpuQueue consumer, ID3D12Resource* resource);
+
+    GpuSyncPoint GetSyncPoint(const UploadTicket& ticket) const; // 还没提交时无效
+    bool IsComplete(const UploadTicket& ticket);
+    void Wait(const UploadTicket& ticket); // CPU 阻塞等待，必要时先 Flush
+
+    Stats GetStats() const;
+
+private:
+    static const uint64_t STAGING_PAGE_SIZE = 4 * 1024 * 1024;
+
+    struct StagingPage {
+        Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+        uint8_t* cpuAddress = nullptr;
+        uint64_t size = 0;
+        uint64_t offset = 0;
+        uint64_t fenceValue = 0; // 用到这个页的最后一批上传的 fence 值
+    };
+
+    struct Batch {
+        uint64_t id;
+        uint64_t fenceValue;
+    };
+
+    struct TextureCopy {
+        ID3D12Resource* destination;
+        UINT subresource;
+        uint32_t stagingPage;
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint; // Offset 是在暂存页里的偏移
+    };
+
+    struct OpenPageAllocator;
+
+    void FlushLocked();
+    void RecyclePages();
+    // 返回暂存页在 m_openPages 里的下标
+    uint32_t AllocateStaging(uint64_t size, uint64_t alignment, uint64_t& offset);
+    UploadTicket TrackUpload(ID3D12Resource* destination, uint64_t size);
+    StagingPage CreatePage(uint64_t size);
+    uint64_t GetFenceValue(uint64_t batch) const;
+
+    ID3D12Device* m_device;
+    GpuMemoryTracker& m_memoryTracker;
+    CommandListPool& m_pool;
+    QueueScheduler& m_scheduler;
+    DeferredReleaseQueue& m_releaseQueue; // 超大上传的专用暂存页提交后交给它释放
+    FenceTimeline& m_timeline;
+    CompletionTracker m_completion; // 已提交批次的完成值由 OnCompleted 推进
+
+    mutable std::mutex m_mutex;
+    StagingBatcher m_bufferCopies;            // 这一批的缓冲区写入，数据在 Flush 之前留在 CPU 内存里
+    std::vector<TextureCopy> m_textureCopies; // 这一批的纹理复制
+    uint64_t m_currentBatch = 1;       // 下一次 Flush 会提交的批次
+    std::deque<Batch> m_submitted;     // 已经提交、还没完成的批次
+    uint64_t m_completedBatch = 0;     // 已知完成的最大批次
+    uint64_t m_completedFenceValue = 0;
+
+    std::vector<StagingPage> m_openPages;     // 当前批次正在写入的页
+    std::deque<StagingPage> m_retiredPages;   // 等 GPU 用完
+    std::vector<StagingPage> m_freePages;
+
+    struct PendingResource {
+        uint64_t batch = 0;        // 最后一次上传的批次
+        uint32_t waitedQueues = 0; // 已经为这个批次声明过等待的消费队列（按 GpuQueue 的位）
+    };
+    std::unordered_map<ID3D12Resource*, PendingResource> m_pendingResources; // 复制还没完成的资源
+    Stats m_stats;
+};
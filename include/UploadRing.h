@@ -0,0 +1,71 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "GpuTimeline.h"
+#include "GpuMemoryTracker.h"
+
+// 上传环上的一块子分配，本帧内有效
+struct UploadAllocation {
+    void* cpuAddress = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS gpuAddress = 0;
+    ID3D12Resource* resource = nullptr;
+    uint64_t offset = 0; // 在 resource 中的偏移，给 CopyBufferRegion 用
+};
+
+// 一个大的、一直保持映射的上传堆缓冲区，按帧槽分区。
+// 每帧的常量缓冲区、动态顶点等只需要在当前分区里移动一次指针（可以在多个线程上同时分配），
+// 分区在回到它时按上次记录的 fence 值回收。分区放不下时临时创建一个专用缓冲区，
+// 随同一个分区一起回收，并计入溢出统计。
+class UploadRing {
+public:
+    struct Stats {
+        uint64_t peakBytes = 0;     // 单帧分区用量的峰值
+        uint64_t overflowCount = 0; // 分区放不下、单独创建缓冲区的次数
+        uint64_t overflowBytes = 0;
+    };
+
+    UploadRing(GpuMemoryTracker& memoryTracker, IGpuTimeline& timeline, uint64_t bytesPerFrame, uint32_t frameCount);
+    ~UploadRing();
+
+    UploadRing(const UploadRing&) = delete;
+    UploadRing& operator=(const UploadRing&) = delete;
+
+    // 切换到下一个分区；GPU 还在使用它时等待
+    void BeginFrame();
+    // 记录当前分区最后一次使用的 fence 值
+    void EndFrame(uint64_t fenceValue);
+
+    // alignment 要是 2 的幂；常量缓冲区用 D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT
+    UploadAllocation Allocate(uint64_t size, uint64_t alignment = 16);
+    UploadAllocation AllocateAndCopy(const void* data, uint64_t size, uint64_t alignment = 16);
+
+    uint64_t GetFrameUsage() const { return m_offset.load(std::memory_order_relaxed); }
+    uint64_t GetBytesPerFrame() const { return m_bytesPerFrame; }
+    Stats GetStats() const;
+
+private:
+    struct Partition {
+        uint64_t fenceValue = 0;
+        std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> overflow; // 随分区一起回收
+    };
+
+    UploadAllocation AllocateOverflow(uint64_t size);
+
+    GpuMemoryTracker& m_memoryTracker;
+    IGpuTimeline& m_timeline;
+    Microsoft::WRL::ComPtr<ID3D12Resource> m_buffer;
+    uint8_t* m_cpuBase = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS m_gpuBase = 0;
+    uint64_t m_bytesPerFrame;
+
+    std::vector<Partition> m_partitions;
+    uint32_t m_current = 0;
+    uint64_t m_partitionBase = 0;        // 当前分区在缓冲区里的起始偏移
+    std::atomic<uint64_t> m_offset{ 0 }; // 当前分区内已经分配到的位置
+
+    mutable std::mutex m_overflowMutex;
+    Stats m_stats;
+};
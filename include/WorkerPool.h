@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "FunctionRef.h"
+
+// 固定数量的工作线程，用于并行录制命令列表等 CPU 工作。
+// ParallelFor 会阻塞调用线程，调用线程本身也参与执行。
+class WorkerPool {
+public:
+    // threadCount 为 0 时使用 (硬件线程数 - 1) 个工作线程
+    explicit WorkerPool(unsigned threadCount = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // 对 [0, count) 中的每个索引执行一次 fn，全部完成后返回；任务抛出的第一个异常会在这里重新抛出。
+    // fn 只被引用到返回为止，不拷贝也不分配
+    void ParallelFor(size_t count, FunctionRef<void(size_t)> fn);
+
+    // 工作线程数（不含调用线程）
+    unsigned GetThreadCount() const { return static_cast<unsigned>(m_threads.size()); }
+
+private:
+    void WorkerMain();
+    void RunJob();
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_submitMutex; // 同一时间只允许一个 ParallelFor
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    uint64_t m_generation = 0;
+    unsigned m_checkedIn = 0; // 已处理完当前任务的工作线程数
+    bool m_stopping = false;
+
+    const FunctionRef<void(size_t)>* m_job = nullptr;
+    size_t m_jobCount = 0;
+    std::atomic<size_t> m_nextIndex{ 0 };
+    std::exception_ptr m_error;
+};
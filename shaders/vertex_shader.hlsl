@@ -4,6 +4,20 @@ process the input data of each vertex (such as the vertex position and color) an
 */
 
 // vertex_shader.hlsl
+// 每次绘制的常量，存放在全局描述符表里的一个数组中
+struct DrawConstants {
+    float4 offset;
+};
+
+// 每次绘制唯一的绑定：绘制常量数组在全局表里的下标，以及自己在数组里的位置
+cbuffer DrawRootConstants : register(b0) {
+    uint drawDataIndex;
+    uint drawIndex;
+};
+
+// bindless 的全局描述符表（无界数组）
+StructuredBuffer<DrawConstants> g_drawData[] : register(t0, space1);
+
 struct VSInput {
     float3 position : POSITION;
     float4 color : COLOR;
@@ -16,7 +30,8 @@ struct PSInput {
 
 PSInput main(VSInput input) {
     PSInput output;
-    output.position = float4(input.position, 1.0f);
+    DrawConstants constants = g_drawData[drawDataIndex][drawIndex];
+    output.position = float4(input.position + constants.offset.xyz, 1.0f);
     output.color = input.color;
     return output;
 }
@@ -0,0 +1,123 @@
+// AliasingPlanner.cpp
+#include "AliasingPlanner.h"
+#include <algorithm>
+
+namespace {
+bool LifetimesOverlap(const AliasingRequest& a, const AliasingRequest& b)
+{
+    return a.firstUse <= b.lastUse && b.firstUse <= a.lastUse;
+}
+
+bool RangesOverlap(uint64_t aOffset, uint64_t aSize, uint64_t bOffset, uint64_t bSize)
+{
+    return aOffset < bOffset + bSize && bOffset < aOffset + aSize;
+}
+}
+
+AliasingPlan PlanAliasing(const std::vector<AliasingRequest>& requests)
+{
+    AliasingPlan plan;
+    plan.offsets.assign(requests.size(), 0);
+    plan.predecessors.assign(requests.size(), AliasingPlan::NO_PREDECESSOR);
+
+    uint32_t groupCount = 0;
+    for (const AliasingRequest& request : requests) {
+        groupCount = std::max(groupCount, request.heapGroup + 1);
+    }
+    plan.groupSizes.assign(groupCount, 0);
+
+    // 大的资源先放，减少碎片
+    std::vector<size_t> order(requests.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        if (requests[a].size != requests[b].size) {
+            return requests[a].size > requests[b].size;
+        }
+        return requests[a].firstUse < requests[b].firstUse;
+    });
+
+    struct Interval {
+        uint64_t begin;
+        uint64_t end;
+    };
+    std::vector<size_t> placed;
+    std::vector<Interval> busy;
+
+    for (size_t index : order) {
+        const AliasingRequest& request = requests[index];
+        plan.unaliasedSize += AlignUp(request.size, request.alignment);
+
+        // 收集同一组里生命周期重叠的已放置资源占用的地址区间
+        busy.clear();
+        for (size_t other : placed) {
+            const AliasingRequest& placedRequest = requests[other];
+            if (placedRequest.heapGroup == request.heapGroup && LifetimesOverlap(placedRequest, request)) {
+                busy.push_back({ plan.offsets[other], plan.offsets[other] + placedRequest.size });
+            }
+        }
+        std::sort(busy.begin(), busy.end(), [](const Interval& a, const Interval& b) { return a.begin < b.begin; });
+
+        // 找到最低的、放得下的对齐地址
+        uint64_t offset = 0;
+        for (const Interval& interval : busy) {
+            if (offset + request.size <= interval.begin) {
+                break;
+            }
+            offset = std::max(offset, AlignUp(interval.end, request.alignment));
+        }
+
+        plan.offsets[index] = offset;
+        uint64_t& groupSize = plan.groupSizes[request.heapGroup];
+        groupSize = std::max(groupSize, offset + request.size);
+        placed.push_back(index);
+    }
+    for (uint64_t groupSize : plan.groupSizes) {
+        plan.heapSize += groupSize;
+    }
+
+    // 别名屏障的 before：地址重叠、在它之前结束的资源里最后一个。它覆盖了整个地址范围时，
+    // 范围里的内存最后都属于它，一个屏障就够了；否则留给调用方用 before 为空的屏障
+    for (size_t i = 0; i < requests.size(); i++) {
+        const AliasingRequest& request = requests[i];
+        size_t latest = requests.size();
+        for (size_t other = 0; other < requests.size(); other++) {
+            const AliasingRequest& earlier = requests[other];
+            if (other == i || earlier.heapGroup != request.heapGroup || earlier.lastUse >= request.firstUse) {
+                continue;
+            }
+            if (!RangesOverlap(plan.offsets[other], earlier.size, plan.offsets[i], request.size)) {
+                continue;
+            }
+            if (latest == requests.size() || earlier.lastUse > requests[latest].lastUse) {
+                latest = other;
+            }
+        }
+        if (latest != requests.size() &&
+            plan.offsets[latest] <= plan.offsets[i] &&
+            plan.offsets[i] + request.size <= plan.offsets[latest] + requests[latest].size) {
+            plan.predecessors[i] = static_cast<uint32_t>(latest);
+        }
+    }
+
+    // 下界：每组在任一位置同时存活的资源大小之和的最大值
+    for (uint32_t group = 0; group < groupCount; group++) {
+        uint64_t peak = 0;
+        for (const AliasingRequest& request : requests) {
+            if (request.heapGroup != group) {
+                continue;
+            }
+            // 存活总量只会在某个资源开始的位置达到最大
+            uint64_t live = 0;
+            for (const AliasingRequest& other : requests) {
+                if (other.heapGroup == group && other.firstUse <= request.firstUse && request.firstUse <= other.lastUse) {
+                    live += other.size;
+                }
+            }
+            peak = std::max(peak, live);
+        }
+        plan.peakLiveSize += peak;
+    }
+    return plan;
+}
@@ -0,0 +1,174 @@
+// BundleCache.cpp
+#include "BundleCache.h"
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include "D3D12CommandBackend.h"
+#include "Hash.h"
+
+BundleCache::BundleCache(ID3D12Device* device, IGpuTimeline& timeline, uint32_t maxIdleFrames)
+    : m_device(device), m_timeline(timeline), m_maxIdleFrames(maxIdleFrames)
+{
+}
+
+void BundleCache::ValidateBundleStream(const CommandStream& stream)
+{
+    // bundle 里不能设置视口、裁剪矩形、渲染目标，也不能清屏或插入屏障
+    const uint8_t* cursor = stream.GetData();
+    const uint8_t* end = cursor + stream.GetSize();
+    while (cursor < end) {
+        const CommandHeader* header = reinterpret_cast<const CommandHeader*>(cursor);
+        switch (header->op) {
+        case CommandOp::SetViewport:
+        case CommandOp::SetScissor:
+        case CommandOp::SetRenderTarget:
+        case CommandOp::ClearRenderTarget:
+        case CommandOp::Barrier:
+            throw std::invalid_argument("Command stream contains commands that are not allowed in a bundle");
+        default:
+            break;
+        }
+        cursor += header->size;
+    }
+}
+
+BundleCache::Entry BundleCache::Record(const CommandStream& stream, ID3D12PipelineState* initialState)
+{
+    Entry entry;
+    HRESULT hr = m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_BUNDLE, IID_PPV_ARGS(&entry.allocator));
+    if (FAILED(hr)) {
+        throw std::runtime_error("Failed to create bundle allocator");
+    }
+
+    hr = m_device->CreateCommandList(
+        0, D3D12_COMMAND_LIST_TYPE_BUNDLE, entry.allocator.Get(), initialState, IID_PPV_ARGS(&entry.bundle)
+    );
+    if (FAILED(hr)) {
+        throw std::runtime_error("Failed to create bundle");
+    }
+
+    D3D12CommandBackend backend(entry.bundle.Get());
+    ReplayCommandStream(stream, backend);
+
+    hr = entry.bundle->Close();
+    if (FAILED(hr)) {
+        throw std::runtime_error("Failed to close bundle");
+    }
+
+    entry.commands.assign(stream.GetData(), stream.GetData() + stream.GetSize());
+    entry.initialState = initialState;
+    return entry;
+}
+
+ID3D12GraphicsCommandList* BundleCache::GetOrRecord(
+    const CommandStream& stream,
+    ID3D12PipelineState* initialState,
+    std::initializer_list<const void*> dependencies)
+{
+    uint64_t key = HashBytes(stream.GetData(), stream.GetSize());
+    key = HashCombine(key, reinterpret_cast<uint64_t>(initialState));
+
+    auto range = m_entries.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        Entry& cached = it->second;
+        if (cached.initialState == initialState && cached.commands.size() == stream.GetSize()
+            && std::memcmp(cached.commands.data(), stream.GetData(), cached.commands.size()) == 0) {
+            m_stats.hits++;
+            cached.lastUsedFrame = m_frame;
+            return cached.bundle.Get();
+        }
+    }
+
+    m_stats.misses++;
+    ValidateBundleStream(stream);
+
+    Entry entry = Record(stream, initialState);
+    entry.lastUsedFrame = m_frame;
+    entry.dependencies.assign(dependencies.begin(), dependencies.end());
+    if (initialState) {
+        entry.dependencies.push_back(initialState);
+    }
+    for (const void* dependency : entry.dependencies) {
+        m_dependents.emplace(dependency, key);
+    }
+
+    ID3D12GraphicsCommandList* bundle = entry.bundle.Get();
+    m_entries.emplace(key, std::move(entry));
+    return bundle;
+}
+
+void BundleCache::Invalidate(const void* object)
+{
+    auto range = m_dependents.equal_range(object);
+    if (range.first == range.second) {
+        return;
+    }
+
+    std::vector<uint64_t> keys;
+    for (auto it = range.first; it != range.second; ++it) {
+        keys.push_back(it->second);
+    }
+    m_dependents.erase(range.first, range.second);
+
+    // 当前帧可能已经引用了这些 bundle，要等下一次信号完成后才能释放
+    const uint64_t retireValue = m_timeline.GetLastSignaledValue() + 1;
+    for (uint64_t key : keys) {
+        auto entries = m_entries.equal_range(key);
+        for (auto it = entries.first; it != entries.second;) {
+            const std::vector<const void*>& deps = it->second.dependencies;
+            bool dependsOnObject = false;
+            for (const void* dependency : deps) {
+                dependsOnObject = dependsOnObject || dependency == object;
+            }
+            if (!dependsOnObject) {
+                ++it;
+                continue;
+            }
+
+            auto retired = it++;
+            Retire(retired, retireValue);
+            m_stats.invalidations++;
+        }
+    }
+}
+
+void BundleCache::Retire(std::unordered_multimap<uint64_t, Entry>::iterator it, uint64_t retireValue)
+{
+    // 从所有依赖对象的索引里移除这个键
+    const uint64_t key = it->first;
+    for (const void* dependency : it->second.dependencies) {
+        auto dependents = m_dependents.equal_range(dependency);
+        for (auto dep = dependents.first; dep != dependents.second;) {
+            dep = dep->second == key ? m_dependents.erase(dep) : std::next(dep);
+        }
+    }
+
+    m_retired.push_back({ retireValue, std::move(it->second) });
+    m_entries.erase(it);
+}
+
+void BundleCache::BeginFrame()
+{
+    m_frame++;
+
+    // 命令流不再出现的 bundle 没有对象会作废它，按最后使用的帧淘汰。
+    // 上一帧可能刚用过，和 Invalidate 一样等下一次信号完成后再释放
+    if (m_frame > m_maxIdleFrames) {
+        const uint64_t oldestKept = m_frame - m_maxIdleFrames;
+        const uint64_t retireValue = m_timeline.GetLastSignaledValue() + 1;
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (it->second.lastUsedFrame < oldestKept) {
+                auto retired = it++;
+                Retire(retired, retireValue);
+                m_stats.evictions++;
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    const uint64_t completed = m_timeline.GetCompletedValue();
+    while (!m_retired.empty() && m_retired.front().fenceValue <= completed) {
+        m_retired.pop_front();
+    }
+}
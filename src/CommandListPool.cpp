@@ -0,0 +1,133 @@
+// CommandListPool.cpp
+#include "CommandListPool.h"
+#include <stdexcept>
+
+using Microsoft::WRL::ComPtr;
+
+CommandListPool::CommandListPool(ID3D12Device* device)
+    : m_device(device)
+{
+}
+
+void CommandListPool::SetTimeline(D3D12_COMMAND_LIST_TYPE type, IGpuTimeline* timeline)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    TypePool& pool = GetPool(type);
+    pool.timeline = timeline;
+    pool.completion = timeline ? std::make_unique<CompletionTracker>(*timeline) : nullptr;
+}
+
+CommandListPool::TypePool& CommandListPool::GetPool(D3D12_COMMAND_LIST_TYPE type)
+{
+    const int index = static_cast<int>(type);
+    if (index < 0 || index >= TYPE_COUNT) {
+        throw std::invalid_argument("Unsupported command list type");
+    }
+    return m_pools[index];
+}
+
+ComPtr<ID3D12CommandAllocator> CommandListPool::AcquireAllocator(TypePool& pool, D3D12_COMMAND_LIST_TYPE type)
+{
+    // 回收 GPU 已经用完的分配器
+    if (!pool.pendingAllocators.empty()) {
+        const uint64_t completed = pool.completion->GetCompletedValue();
+        while (!pool.pendingAllocators.empty() && pool.pendingAllocators.front().fenceValue <= completed) {
+            pool.freeAllocators.push_back(std::move(pool.pendingAllocators.front().allocator));
+            pool.pendingAllocators.pop_front();
+        }
+    }
+
+    ComPtr<ID3D12CommandAllocator> allocator;
+    if (!pool.freeAllocators.empty()) {
+        allocator = std::move(pool.freeAllocators.back());
+        pool.freeAllocators.pop_back();
+
+        HRESULT hr = allocator->Reset();
+        if (FAILED(hr)) {
+            throw std::runtime_error("Failed to reset pooled command allocator");
+        }
+        return allocator;
+    }
+
+    HRESULT hr = m_device->CreateCommandAllocator(type, IID_PPV_ARGS(&allocator));
+    if (FAILED(hr)) {
+        throw std::runtime_error("Failed to create command allocator");
+    }
+    pool.allocatorCount++;
+    return allocator;
+}
+
+CommandContext CommandListPool::Acquire(D3D12_COMMAND_LIST_TYPE type, ID3D12PipelineState* initialState)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    TypePool& pool = GetPool(type);
+    if (!pool.timeline) {
+        throw std::logic_error("No timeline registered for this command list type");
+    }
+
+    CommandContext context;
+    context.type = type;
+    context.allocator = AcquireAllocator(pool, type);
+
+    if (!pool.freeLists.empty()) {
+        context.list = std::move(pool.freeLists.back());
+        pool.freeLists.pop_back();
+
+        HRESULT hr = context.list->Reset(context.allocator.Get(), initialState);
+        if (FAILED(hr)) {
+            throw std::runtime_error("Failed to reset pooled command list");
+        }
+        return context;
+    }
+
+    // 新建的命令列表处于录制状态，不需要 Reset
+    HRESULT hr = m_device->CreateCommandList(
+        0, type, context.allocator.Get(), initialState, IID_PPV_ARGS(&context.list)
+    );
+    if (FAILED(hr)) {
+        throw std::runtime_error("Failed to create command list");
+    }
+    pool.listCount++;
+    return context;
+}
+
+void CommandListPool::Release(CommandContext& context, uint64_t fenceValue)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    TypePool& pool = GetPool(context.type);
+
+    // 提交后的命令列表可以立即 Reset，只有分配器需要等 GPU
+    if (context.list) {
+        pool.freeLists.push_back(std::move(context.list));
+    }
+    if (context.allocator) {
+        if (!pool.pendingAllocators.empty() && fenceValue < pool.pendingAllocators.back().fenceValue) {
+            // 保持按 fence 值有序，乱序归还时按较大的值保守处理
+            fenceValue = pool.pendingAllocators.back().fenceValue;
+        }
+        pool.pendingAllocators.push_back({ fenceValue, std::move(context.allocator) });
+        if (pool.completion) {
+            pool.completion->Request(fenceValue);
+        }
+    }
+}
+
+size_t CommandListPool::GetAllocatorCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = 0;
+    for (const TypePool& pool : m_pools) {
+        count += pool.allocatorCount;
+    }
+    return count;
+}
+
+size_t CommandListPool::GetCommandListCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = 0;
+    for (const TypePool& pool : m_pools) {
+        count += pool.listCount;
+    }
+    return count;
+}
@@ -0,0 +1,79 @@
+// CompletionTracker.cpp
+#include "CompletionTracker.h"
+#include <algorithm>
+
+CompletionTracker::CompletionTracker(IGpuTimeline& timeline)
+    : m_timeline(timeline)
+{
+}
+
+CompletionTracker::~CompletionTracker()
+{
+    // 挂着的值都已经发过信号：先等 GPU 执行到最大的那个，再等回调执行完；之后不再挂新的
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_stopping = true;
+    if (m_pendingCount > 0) {
+        const uint64_t armed = m_armed;
+        lock.unlock();
+        m_timeline.WaitForValue(armed);
+        lock.lock();
+    }
+    m_idle.wait(lock, [this]() { return m_pendingCount == 0; });
+}
+
+uint64_t CompletionTracker::TakeArmableLocked()
+{
+    // 还没发信号的值可能永远不会完成，不挂回调，等发出之后再挂
+    if (m_stopping || m_requested <= m_armed || m_requested > m_timeline.GetLastSignaledValue()) {
+        return 0;
+    }
+    m_armed = m_requested;
+    m_pendingCount++;
+    return m_armed;
+}
+
+void CompletionTracker::Arm(uint64_t target)
+{
+    if (target != 0) {
+        m_timeline.OnCompleted(target, [this, target]() { OnTargetCompleted(target); });
+    }
+}
+
+void CompletionTracker::Request(uint64_t value)
+{
+    uint64_t target = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (value <= m_requested) {
+            return;
+        }
+        // 前一个请求还没发信号时被更大的值覆盖，它在更大的值完成时一起完成
+        m_requested = value;
+        target = TakeArmableLocked();
+    }
+    Arm(target);
+}
+
+uint64_t CompletionTracker::GetCompletedValue()
+{
+    uint64_t target = 0;
+    uint64_t completed = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        target = TakeArmableLocked();
+        completed = m_completed;
+    }
+    Arm(target);
+    return completed;
+}
+
+void CompletionTracker::OnTargetCompleted(uint64_t value)
+{
+    // 在时间线的等待线程上执行。在锁内通知：析构线程拿到锁时这里已经不再访问成员
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_completed = std::max(m_completed, value);
+    m_pendingCount--;
+    if (m_pendingCount == 0) {
+        m_idle.notify_all();
+    }
+}
@@ -0,0 +1,97 @@
+// DeferredReleaseQueue.cpp
+#include "DeferredReleaseQueue.h"
+#include <algorithm>
+
+DeferredReleaseQueue::~DeferredReleaseQueue()
+{
+    // 没有发出过的信号值永远等不到，只等已经发出的部分
+    for (Lane& lane : m_lanes) {
+        if (!lane.entries.empty()) {
+            const uint64_t value = std::min(lane.entries.back().fenceValue, lane.timeline->GetLastSignaledValue());
+            lane.timeline->WaitForValue(value);
+        }
+        for (Entry& entry : lane.entries) {
+            if (entry.callback) {
+                entry.callback();
+            }
+        }
+    }
+}
+
+void DeferredReleaseQueue::Push(IGpuTimeline& timeline, Entry&& entry)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = std::find_if(m_lanes.begin(), m_lanes.end(), [&](const Lane& lane) { return lane.timeline == &timeline; });
+    if (it == m_lanes.end()) {
+        m_lanes.push_back({ &timeline, std::make_unique<CompletionTracker>(timeline), {} });
+        it = m_lanes.end() - 1;
+    }
+
+    // 通常按递增顺序加入；乱序时插到合适的位置，保证队首总是最早完成的
+    std::deque<Entry>& entries = it->entries;
+    auto position = entries.end();
+    while (position != entries.begin() && (position - 1)->fenceValue > entry.fenceValue) {
+        --position;
+    }
+    it->completion->Request(entry.fenceValue);
+    entries.insert(position, std::move(entry));
+}
+
+void DeferredReleaseQueue::Release(Microsoft::WRL::ComPtr<IUnknown> object, IGpuTimeline& timeline, uint64_t fenceValue)
+{
+    if (!object) {
+        return;
+    }
+    Push(timeline, { fenceValue, std::move(object), nullptr });
+}
+
+void DeferredReleaseQueue::Release(Microsoft::WRL::ComPtr<IUnknown> object, IGpuTimeline& timeline)
+{
+    Release(std::move(object), timeline, timeline.GetLastSignaledValue() + 1);
+}
+
+void DeferredReleaseQueue::Defer(std::function<void()> callback, IGpuTimeline& timeline, uint64_t fenceValue)
+{
+    Push(timeline, { fenceValue, nullptr, std::move(callback) });
+}
+
+void DeferredReleaseQueue::Defer(std::function<void()> callback, IGpuTimeline& timeline)
+{
+    Defer(std::move(callback), timeline, timeline.GetLastSignaledValue() + 1);
+}
+
+size_t DeferredReleaseQueue::Collect()
+{
+    // 先从队列里摘下来，释放和回调在锁外执行
+    std::vector<Entry> completed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (Lane& lane : m_lanes) {
+            if (lane.entries.empty()) {
+                continue;
+            }
+            const uint64_t completedValue = lane.completion->GetCompletedValue();
+            while (!lane.entries.empty() && lane.entries.front().fenceValue <= completedValue) {
+                completed.push_back(std::move(lane.entries.front()));
+                lane.entries.pop_front();
+            }
+        }
+    }
+
+    for (Entry& entry : completed) {
+        if (entry.callback) {
+            entry.callback();
+        }
+    }
+    return completed.size();
+}
+
+size_t DeferredReleaseQueue::GetPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = 0;
+    for (const Lane& lane : m_lanes) {
+        count += lane.entries.size();
+    }
+    return count;
+}
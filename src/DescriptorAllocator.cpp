@@ -0,0 +1,55 @@
+// DescriptorAllocator.cpp
+#include "DescriptorAllocator.h"
+#include <stdexcept>
+
+DescriptorAllocator::DescriptorAllocator(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t descriptorsPerPage)
+    : m_device(device),
+      m_type(type),
+      m_descriptorSize(device->GetDescriptorHandleIncrementSize(type)),
+      m_freeList(descriptorsPerPage)
+{
+}
+
+DescriptorHandle DescriptorAllocator::Allocate()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint32_t index = m_freeList.Allocate();
+    if (index == DescriptorFreeList::INVALID_INDEX) {
+        D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+        heapDesc.NumDescriptors = m_freeList.GetPageSize();
+        heapDesc.Type = m_type;
+        heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+
+        Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> page;
+        if (FAILED(m_device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&page)))) {
+            throw std::runtime_error("Failed to create descriptor heap page");
+        }
+        m_pages.push_back(page);
+        m_pageStarts.push_back(page->GetCPUDescriptorHandleForHeapStart());
+        m_freeList.AddPage();
+        index = m_freeList.Allocate();
+    }
+
+    DescriptorHandle handle;
+    handle.index = index;
+    handle.cpuHandle.ptr = m_pageStarts[m_freeList.GetPage(index)].ptr +
+        static_cast<SIZE_T>(m_freeList.GetSlot(index)) * m_descriptorSize;
+    return handle;
+}
+
+void DescriptorAllocator::Free(DescriptorHandle& handle)
+{
+    if (!handle.IsValid()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_freeList.Free(handle.index);
+    handle = DescriptorHandle();
+}
+
+DescriptorFreeList::Stats DescriptorAllocator::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_freeList.GetStats();
+}
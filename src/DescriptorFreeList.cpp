@@ -0,0 +1,57 @@
+// DescriptorFreeList.cpp
+#include "DescriptorFreeList.h"
+#include <algorithm>
+#include <stdexcept>
+
+DescriptorFreeList::DescriptorFreeList(uint32_t pageSize)
+    : m_pageSize(pageSize)
+{
+    if (pageSize == 0) {
+        throw std::invalid_argument("Failed to create descriptor free list: page size must be non-zero");
+    }
+}
+
+uint32_t DescriptorFreeList::AddPage()
+{
+    const uint32_t first = static_cast<uint32_t>(m_next.size());
+    if (static_cast<uint64_t>(first) + m_pageSize >= ALLOCATED) {
+        throw std::runtime_error("Failed to add descriptor page: index space exhausted");
+    }
+
+    // 新页的槽位按顺序接到链表头上，先分配低下标
+    m_next.resize(first + m_pageSize);
+    for (uint32_t i = 0; i + 1 < m_pageSize; i++) {
+        m_next[first + i] = first + i + 1;
+    }
+    m_next[first + m_pageSize - 1] = m_head;
+    m_head = first;
+
+    m_stats.capacity += m_pageSize;
+    return m_stats.pageCount++;
+}
+
+uint32_t DescriptorFreeList::Allocate()
+{
+    if (m_head == INVALID_INDEX) {
+        return INVALID_INDEX;
+    }
+
+    const uint32_t index = m_head;
+    m_head = m_next[index];
+    m_next[index] = ALLOCATED;
+
+    m_stats.allocated++;
+    m_stats.peakAllocated = std::max(m_stats.peakAllocated, m_stats.allocated);
+    return index;
+}
+
+void DescriptorFreeList::Free(uint32_t index)
+{
+    if (!IsAllocated(index)) {
+        throw std::invalid_argument("Failed to free descriptor: index is not allocated");
+    }
+
+    m_next[index] = m_head;
+    m_head = index;
+    m_stats.allocated--;
+}
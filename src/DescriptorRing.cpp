@@ -0,0 +1,58 @@
+// DescriptorRing.cpp
+#include "DescriptorRing.h"
+#include <stdexcept>
+
+DescriptorRing::DescriptorRing(uint32_t capacity)
+    : m_capacity(capacity)
+{
+    if (capacity == 0) {
+        throw std::invalid_argument("DescriptorRing capacity must be non-zero");
+    }
+}
+
+uint32_t DescriptorRing::Allocate(uint32_t count)
+{
+    if (count == 0 || count > m_capacity) {
+        return INVALID_OFFSET;
+    }
+
+    // 环空了就从头开始，少跳一次环尾
+    if (GetUsed() == 0 && m_frames.empty()) {
+        m_head = 0;
+        m_tail = 0;
+    }
+
+    uint32_t offset = INVALID_OFFSET;
+    if (m_head >= m_tail && GetUsed() < m_capacity) {
+        // 空闲区间是 [head, capacity) 和 [0, tail)
+        if (m_capacity - m_head >= count) {
+            offset = m_head;
+        } else if (m_tail >= count) {
+            m_allocated += m_capacity - m_head; // 跳过的环尾随这一帧一起回收
+            offset = 0;
+        }
+    } else if (m_head < m_tail && m_tail - m_head >= count) {
+        offset = m_head;
+    }
+
+    if (offset == INVALID_OFFSET) {
+        return INVALID_OFFSET;
+    }
+    m_head = (offset + count) % m_capacity;
+    m_allocated += count;
+    return offset;
+}
+
+void DescriptorRing::EndFrame(uint64_t fenceValue)
+{
+    m_frames.push_back({ fenceValue, m_head, m_allocated });
+}
+
+void DescriptorRing::Reclaim(uint64_t completedValue)
+{
+    while (!m_frames.empty() && m_frames.front().fenceValue <= completedValue) {
+        m_tail = m_frames.front().head;
+        m_reclaimed = m_frames.front().allocated;
+        m_frames.pop_front();
+    }
+}
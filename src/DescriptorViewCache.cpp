@@ -0,0 +1,292 @@
+// DescriptorViewCache.cpp
+#include "DescriptorViewCache.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "Hash.h"
+#include "PrivateDataToken.h"
+
+namespace {
+// 挂在有缓存视图的资源上的私有数据键
+const GUID VIEW_CACHE_TOKEN_GUID = { 0x3f9d2b71, 0x5c4e, 0x4a0b, { 0x8e, 0x17, 0xd2, 0x6a, 0x41, 0xc9, 0x0f, 0x83 } };
+}
+
+void DescriptorViewCache::ViewKey::Put(uint64_t value)
+{
+    Put(static_cast<uint32_t>(value));
+    Put(static_cast<uint32_t>(value >> 32));
+}
+
+void DescriptorViewCache::ViewKey::Put(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    Put(bits);
+}
+
+bool DescriptorViewCache::ViewKey::operator==(const ViewKey& other) const
+{
+    return count == other.count && std::equal(words, words + count, other.words);
+}
+
+DescriptorViewCache::DescriptorViewCache(ID3D12Device* device, DescriptorAllocator& cpuDescriptors, DynamicDescriptorHeap& shaderVisible)
+    : m_device(device),
+      m_cpuDescriptors(cpuDescriptors),
+      m_shaderVisible(shaderVisible),
+      m_released(std::make_shared<ReleasedResources>())
+{
+    if (cpuDescriptors.GetType() != D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV) {
+        throw std::invalid_argument("DescriptorViewCache needs a CBV_SRV_UAV descriptor allocator");
+    }
+}
+
+DescriptorViewCache::~DescriptorViewCache()
+{
+    // 资源上的令牌留着，它们只会写入共享的 m_released
+    for (const auto& item : m_entries) {
+        DestroyEntry(item.second);
+    }
+}
+
+CachedView DescriptorViewCache::AcquireShaderResourceView(ID3D12Resource* resource, const D3D12_SHADER_RESOURCE_VIEW_DESC* desc)
+{
+    ViewDesc viewDesc;
+    if (desc) {
+        viewDesc.srv = *desc;
+    }
+    return Acquire(resource, ViewType::ShaderResource, viewDesc, desc == nullptr);
+}
+
+CachedView DescriptorViewCache::AcquireConstantBufferView(ID3D12Resource* resource, const D3D12_CONSTANT_BUFFER_VIEW_DESC& desc)
+{
+    ViewDesc viewDesc;
+    viewDesc.cbv = desc;
+    return Acquire(resource, ViewType::ConstantBuffer, viewDesc, false);
+}
+
+DescriptorViewCache::ViewKey DescriptorViewCache::BuildKey(ViewType type, const ViewDesc& desc, bool defaultView)
+{
+    ViewKey key;
+    key.Put(static_cast<uint32_t>(type));
+    key.Put(static_cast<uint32_t>(defaultView));
+    if (defaultView) {
+        return key;
+    }
+
+    if (type == ViewType::ConstantBuffer) {
+        key.Put(static_cast<uint64_t>(desc.cbv.BufferLocation));
+        key.Put(static_cast<uint32_t>(desc.cbv.SizeInBytes));
+        return key;
+    }
+
+    const D3D12_SHADER_RESOURCE_VIEW_DESC& srv = desc.srv;
+    key.Put(static_cast<uint32_t>(srv.Format));
+    key.Put(static_cast<uint32_t>(srv.ViewDimension));
+    key.Put(static_cast<uint32_t>(srv.Shader4ComponentMapping));
+    switch (srv.ViewDimension) {
+    case D3D12_SRV_DIMENSION_BUFFER:
+        key.Put(static_cast<uint64_t>(srv.Buffer.FirstElement));
+        key.Put(static_cast<uint32_t>(srv.Buffer.NumElements));
+        key.Put(static_cast<uint32_t>(srv.Buffer.StructureByteStride));
+        key.Put(static_cast<uint32_t>(srv.Buffer.Flags));
+        break;
+    case D3D12_SRV_DIMENSION_TEXTURE1D:
+        key.Put(static_cast<uint32_t>(srv.Texture1D.MostDetailedMip));
+        key.Put(static_cast<uint32_t>(srv.Texture1D.MipLevels));
+        key.Put(srv.Texture1D.ResourceMinLODClamp);
+        break;
+    case D3D12_SRV_DIMENSION_TEXTURE1DARRAY:
+        key.Put(static_cast<uint32_t>(srv.Texture1DArray.MostDetailedMip));
+        key.Put(static_cast<uint32_t>(srv.Texture1DArray.MipLevels));
+        key.Put(static_cast<uint32_t>(srv.Texture1DArray.FirstArraySlice));
+        key.Put(static_cast<uint32_t>(srv.Texture1DArray.ArraySize));
+        key.Put(srv.Texture1DArray.ResourceMinLODClamp);
+        break;
+    case D3D12_SRV_DIMENSION_TEXTURE2D:
+        key.Put(static_cast<uint32_t>(srv.Texture2D.MostDetailedMip));
+        key.Put(static_cast<uint32_t>(srv.Texture2D.MipLevels));
+        key.Put(static_cast<uint32_t>(srv.Texture2D.PlaneSlice));
+        key.Put(srv.Texture2D.ResourceMinLODClamp);
+        break;
+    case D3D12_SRV_DIMENSION_TEXTURE2DARRAY:
+        key.Put(static_cast<uint32_t>(srv.Texture2DArray.MostDetailedMip));
+        key.Put(static_cast<uint32_t>(srv.Texture2DArray.MipLevels));
+        key.Put(static_cast<uint32_t>(srv.Texture2DArray.FirstArraySlice));
+        key.Put(static_cast<uint32_t>(srv.Texture2DArray.ArraySize));
+        key.Put(static_cast<uint32_t>(srv.Texture2DArray.PlaneSlice));
+        key.Put(srv.Texture2DArray.ResourceMinLODClamp);
+        break;
+    case D3D12_SRV_DIMENSION_TEXTURE2DMS:
+        break; // 没有字段
+    case D3D12_SRV_DIMENSION_TEXTURE2DMSARRAY:
+        key.Put(static_cast<uint32_t>(srv.Texture2DMSArray.FirstArraySlice));
+        key.Put(static_cast<uint32_t>(srv.Texture2DMSArray.ArraySize));
+        break;
+    case D3D12_SRV_DIMENSION_TEXTURE3D:
+        key.Put(static_cast<uint32_t>(srv.Texture3D.MostDetailedMip));
+        key.Put(static_cast<uint32_t>(srv.Texture3D.MipLevels));
+        key.Put(srv.Texture3D.ResourceMinLODClamp);
+        break;
+    case D3D12_SRV_DIMENSION_TEXTURECUBE:
+        key.Put(static_cast<uint32_t>(srv.TextureCube.MostDetailedMip));
+        key.Put(static_cast<uint32_t>(srv.TextureCube.MipLevels));
+        key.Put(srv.TextureCube.ResourceMinLODClamp);
+        break;
+    case D3D12_SRV_DIMENSION_TEXTURECUBEARRAY:
+        key.Put(static_cast<uint32_t>(srv.TextureCubeArray.MostDetailedMip));
+        key.Put(static_cast<uint32_t>(srv.TextureCubeArray.MipLevels));
+        key.Put(static_cast<uint32_t>(srv.TextureCubeArray.First2DArrayFace));
+        key.Put(static_cast<uint32_t>(srv.TextureCubeArray.NumCubes));
+        key.Put(srv.TextureCubeArray.ResourceMinLODClamp);
+        break;
+    case D3D12_SRV_DIMENSION_RAYTRACING_ACCELERATION_STRUCTURE:
+        key.Put(static_cast<uint64_t>(srv.RaytracingAccelerationStructure.Location));
+        break;
+    default:
+        throw std::invalid_argument("Unsupported shader resource view dimension");
+    }
+    return key;
+}
+
+uint64_t DescriptorViewCache::HashView(ID3D12Resource* resource, const ViewKey& key)
+{
+    const uint64_t hash = HashValue(reinterpret_cast<uintptr_t>(resource));
+    return HashBytes(key.words, key.count * sizeof(uint32_t), hash);
+}
+
+CachedView DescriptorViewCache::Acquire(ID3D12Resource* resource, ViewType type, const ViewDesc& desc, bool defaultView)
+{
+    if (!resource) {
+        throw std::invalid_argument("Cached views need a resource");
+    }
+
+    const ViewKey viewKey = BuildKey(type, desc, defaultView);
+    const uint64_t key = HashView(resource, viewKey);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    CollectReleasedLocked();
+    m_stats.lookups++;
+
+    auto range = m_entries.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+        Entry& entry = it->second;
+        if (entry.resource == resource && entry.key == viewKey) {
+            entry.refCount++;
+            m_stats.hits++;
+            return { entry.descriptor.cpuHandle, entry.index, key };
+        }
+    }
+
+    Entry entry;
+    entry.resource = resource;
+    entry.key = viewKey;
+    entry.refCount = 1;
+    entry.descriptor = m_cpuDescriptors.Allocate();
+    if (type == ViewType::ShaderResource) {
+        m_device->CreateShaderResourceView(resource, defaultView ? nullptr : &desc.srv, entry.descriptor.cpuHandle);
+    } else {
+        m_device->CreateConstantBufferView(&desc.cbv, entry.descriptor.cpuHandle);
+    }
+    try {
+        entry.index = m_shaderVisible.AllocatePersistent(entry.descriptor.cpuHandle);
+    } catch (...) {
+        m_cpuDescriptors.Free(entry.descriptor);
+        throw;
+    }
+
+    // 第一次给这个资源建视图：挂上令牌，资源销毁时得到通知
+    auto views = m_resourceViews.find(resource);
+    if (views == m_resourceViews.end()) {
+        views = m_resourceViews.emplace(resource, std::vector<uint64_t>()).first;
+        std::shared_ptr<ReleasedResources> released = m_released;
+        PrivateDataToken::Attach(resource, VIEW_CACHE_TOKEN_GUID, [released, resource]() {
+            std::lock_guard<std::mutex> lock(released->mutex);
+            released->resources.push_back(resource);
+        });
+    }
+    if (std::find(views->second.begin(), views->second.end(), key) == views->second.end()) {
+        views->second.push_back(key);
+    }
+
+    m_entries.emplace(key, entry);
+    m_stats.views++;
+    return { entry.descriptor.cpuHandle, entry.index, key };
+}
+
+void DescriptorViewCache::Release(CachedView& view)
+{
+    if (!view.IsValid()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto range = m_entries.equal_range(view.key);
+    for (auto it = range.first; it != range.second; ++it) {
+        Entry& entry = it->second;
+        if (entry.index != view.index) {
+            continue;
+        }
+        if (--entry.refCount == 0) {
+            // 资源还活着，令牌留在它上面，m_resourceViews 里的键在资源销毁时一起清理
+            DestroyEntry(entry);
+            m_entries.erase(it);
+            m_stats.views--;
+        }
+        break;
+    }
+    // 找不到说明资源已经销毁、视图已经被逐出
+    view = CachedView();
+}
+
+void DescriptorViewCache::CollectReleased()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    CollectReleasedLocked();
+}
+
+void DescriptorViewCache::CollectReleasedLocked()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_released->mutex);
+        if (m_released->resources.empty()) {
+            return;
+        }
+        m_collecting.swap(m_released->resources);
+    }
+
+    for (ID3D12Resource* resource : m_collecting) {
+        auto views = m_resourceViews.find(resource);
+        if (views == m_resourceViews.end()) {
+            continue;
+        }
+        for (uint64_t key : views->second) {
+            auto range = m_entries.equal_range(key);
+            for (auto it = range.first; it != range.second;) {
+                if (it->second.resource == resource) {
+                    DestroyEntry(it->second);
+                    it = m_entries.erase(it);
+                    m_stats.views--;
+                    m_stats.evictions++;
+                } else {
+                    ++it;
+                }
+            }
+        }
+        m_resourceViews.erase(views);
+    }
+    m_collecting.clear();
+}
+
+void DescriptorViewCache::DestroyEntry(const Entry& entry)
+{
+    // CPU 描述符已经复制进着色器可见堆，可以立即释放；着色器可见的槽位要等飞行中的帧用完
+    DescriptorHandle descriptor = entry.descriptor;
+    m_cpuDescriptors.Free(descriptor);
+    m_shaderVisible.FreePersistent(entry.index);
+}
+
+DescriptorViewCache::Stats DescriptorViewCache::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
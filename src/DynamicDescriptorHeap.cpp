@@ -0,0 +1,210 @@
+// DynamicDescriptorHeap.cpp
+#include "DynamicDescriptorHeap.h"
+#include <algorithm>
+#include <stdexcept>
+#include "Hash.h"
+
+namespace {
+const size_t INITIAL_CACHE_SIZE = 256; // 2 的幂
+}
+
+DynamicDescriptorHeap::DynamicDescriptorHeap(ID3D12Device* device, IGpuTimeline& timeline, uint32_t persistentCapacity, uint32_t ringCapacity)
+    : m_device(device),
+      m_timeline(timeline),
+      m_descriptorSize(device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV)),
+      m_persistentCapacity(persistentCapacity),
+      m_persistentSlots(persistentCapacity > 0 ? persistentCapacity : 1),
+      m_ring(ringCapacity)
+{
+    if (persistentCapacity > 0) {
+        m_persistentSlots.AddPage();
+    }
+
+    D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+    heapDesc.NumDescriptors = persistentCapacity + ringCapacity;
+    heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    if (FAILED(m_device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&m_heap)))) {
+        throw std::runtime_error("Failed to create shader-visible descriptor heap");
+    }
+    m_cpuStart = m_heap->GetCPUDescriptorHandleForHeapStart();
+    m_gpuStart = m_heap->GetGPUDescriptorHandleForHeapStart();
+
+    m_tableCache.resize(INITIAL_CACHE_SIZE);
+    for (CachedTable& slot : m_tableCache) {
+        slot.frame = 0;
+    }
+}
+
+void DynamicDescriptorHeap::BeginFrame()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const uint64_t completed = m_timeline.GetCompletedValue();
+    m_ring.Reclaim(completed);
+    while (!m_retiredSlots.empty() && m_retiredSlots.front().fenceValue <= completed) {
+        for (uint32_t index : m_retiredSlots.front().indices) {
+            m_persistentSlots.Free(index);
+        }
+        m_retiredSlots.pop_front();
+    }
+
+    m_frame++;
+    m_cachedCount = 0;
+    m_cachedSources.clear();
+}
+
+void DynamicDescriptorHeap::EndFrame(uint64_t fenceValue)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ring.EndFrame(fenceValue);
+    if (!m_freedThisFrame.empty()) {
+        m_retiredSlots.push_back({ fenceValue, std::move(m_freedThisFrame) });
+        m_freedThisFrame.clear();
+    }
+}
+
+uint32_t DynamicDescriptorHeap::AllocateTable(const D3D12_CPU_DESCRIPTOR_HANDLE* sources, uint32_t count)
+{
+    if (count == 0) {
+        throw std::invalid_argument("Descriptor table must not be empty");
+    }
+
+    uint64_t hash = HASH_SEED;
+    for (uint32_t i = 0; i < count; i++) {
+        hash = HashCombine(hash, static_cast<uint64_t>(sources[i].ptr));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.tables++;
+    if (const CachedTable* cached = FindTable(hash, sources, count)) {
+        m_stats.reusedTables++;
+        return m_persistentCapacity + cached->offset;
+    }
+
+    const uint32_t offset = AllocateRange(count);
+    CopyToHeap(m_persistentCapacity + offset, sources, count);
+
+    CachedTable table;
+    table.hash = hash;
+    table.frame = m_frame;
+    table.sourceStart = static_cast<uint32_t>(m_cachedSources.size());
+    table.count = count;
+    table.offset = offset;
+    for (uint32_t i = 0; i < count; i++) {
+        m_cachedSources.push_back(sources[i].ptr);
+    }
+    InsertTable(table);
+
+    return m_persistentCapacity + offset;
+}
+
+uint32_t DynamicDescriptorHeap::AllocatePersistent(D3D12_CPU_DESCRIPTOR_HANDLE source)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const uint32_t index = m_persistentSlots.Allocate();
+    if (index == DescriptorFreeList::INVALID_INDEX) {
+        throw std::runtime_error("Persistent shader-visible descriptors exhausted");
+    }
+    CopyToHeap(index, &source, 1);
+    return index;
+}
+
+void DynamicDescriptorHeap::FreePersistent(uint32_t index)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_persistentSlots.IsAllocated(index)) {
+        throw std::invalid_argument("Descriptor index is not an allocated persistent slot");
+    }
+    m_freedThisFrame.push_back(index);
+}
+
+void DynamicDescriptorHeap::CopyToHeap(uint32_t index, const D3D12_CPU_DESCRIPTOR_HANDLE* sources, uint32_t count)
+{
+    // 来源里连续的一段合成一次复制
+    uint32_t runStart = 0;
+    for (uint32_t i = 1; i <= count; i++) {
+        if (i < count && sources[i].ptr == sources[i - 1].ptr + m_descriptorSize) {
+            continue;
+        }
+        D3D12_CPU_DESCRIPTOR_HANDLE destination = { m_cpuStart.ptr + static_cast<SIZE_T>(index + runStart) * m_descriptorSize };
+        m_device->CopyDescriptorsSimple(i - runStart, destination, sources[runStart], D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        runStart = i;
+    }
+    m_stats.copiedDescriptors += count;
+}
+
+uint32_t DynamicDescriptorHeap::AllocateRange(uint32_t count)
+{
+    uint32_t offset = m_ring.Allocate(count);
+    // 环满了：等最早的一帧完成再回收，只剩当前帧时说明容量不够
+    while (offset == DescriptorRing::INVALID_OFFSET) {
+        const uint64_t oldest = m_ring.GetOldestFenceValue();
+        if (oldest == 0) {
+            throw std::runtime_error("Shader-visible descriptor ring is too small for one frame");
+        }
+        m_stats.waits++;
+        m_timeline.WaitForValue(oldest);
+        m_ring.Reclaim(m_timeline.GetCompletedValue());
+        offset = m_ring.Allocate(count);
+    }
+    m_stats.peakDescriptors = std::max(m_stats.peakDescriptors, m_ring.GetUsed());
+    return offset;
+}
+
+const DynamicDescriptorHeap::CachedTable* DynamicDescriptorHeap::FindTable(uint64_t hash, const D3D12_CPU_DESCRIPTOR_HANDLE* sources, uint32_t count) const
+{
+    const size_t mask = m_tableCache.size() - 1;
+    for (size_t slot = hash & mask; m_tableCache[slot].frame == m_frame; slot = (slot + 1) & mask) {
+        const CachedTable& table = m_tableCache[slot];
+        if (table.hash != hash || table.count != count) {
+            continue;
+        }
+        bool match = true;
+        for (uint32_t i = 0; match && i < count; i++) {
+            match = m_cachedSources[table.sourceStart + i] == sources[i].ptr;
+        }
+        if (match) {
+            return &table;
+        }
+    }
+    return nullptr;
+}
+
+void DynamicDescriptorHeap::InsertTable(const CachedTable& table)
+{
+    // 负载超过一半时加倍，只搬本帧的条目
+    if ((m_cachedCount + 1) * 2 > m_tableCache.size()) {
+        std::vector<CachedTable> old(m_tableCache.size() * 2);
+        old.swap(m_tableCache);
+        for (CachedTable& slot : m_tableCache) {
+            slot.frame = 0;
+        }
+        m_cachedCount = 0;
+        for (const CachedTable& entry : old) {
+            if (entry.frame == m_frame) {
+                InsertTable(entry);
+            }
+        }
+    }
+
+    const size_t mask = m_tableCache.size() - 1;
+    size_t slot = table.hash & mask;
+    while (m_tableCache[slot].frame == m_frame) {
+        slot = (slot + 1) & mask;
+    }
+    m_tableCache[slot] = table;
+    m_cachedCount++;
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE DynamicDescriptorHeap::GetGpuHandle(uint32_t index) const
+{
+    return { m_gpuStart.ptr + static_cast<UINT64>(index) * m_descriptorSize };
+}
+
+DynamicDescriptorHeap::Stats DynamicDescriptorHeap::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats = m_stats;
+    stats.persistentDescriptors = m_persistentSlots.GetStats().allocated;
+    return stats;
+}
@@ -0,0 +1,191 @@
+// FenceTimeline.cpp
+#include "FenceTimeline.h"
+#include <windows.h>
+#include <stdexcept>
+#include <vector>
+
+FenceTimeline::FenceTimeline(ID3D12Device* device, ID3D12CommandQueue* queue, uint64_t initialValue)
+    : m_queue(queue), m_lastSignaled(initialValue)
+{
+    HRESULT hr = device->CreateFence(initialValue, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence));
+    if (FAILED(hr)) {
+        throw std::runtime_error("Failed to create fence");
+    }
+
+    // 等待线程的事件只创建一次，之后反复使用
+    m_fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    m_wakeEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (!m_fenceEvent || !m_wakeEvent) {
+        if (m_fenceEvent) CloseHandle(m_fenceEvent);
+        if (m_wakeEvent) CloseHandle(m_wakeEvent);
+        throw std::runtime_error("Failed to create fence events");
+    }
+
+    m_waiterThread = std::thread(&FenceTimeline::WaiterThreadMain, this);
+}
+
+FenceTimeline::~FenceTimeline()
+{
+    // 停止等待线程
+    {
+        std::lock_guard<std::mutex> lock(m_callbackMutex);
+        m_stopping = true;
+    }
+    SetEvent(m_wakeEvent);
+    if (m_waiterThread.joinable()) {
+        m_waiterThread.join();
+    }
+
+    // 剩下的回调可能还引用着 GPU 正在使用的资源，等 GPU 跑完再执行已经发过信号的值的回调，
+    // 回调里新注册的同样执行。等待从未发过信号的值的回调永远不会完成，不执行，直接丢弃
+    const uint64_t lastSignaled = m_lastSignaled.load();
+    WaitForValue(lastSignaled);
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(m_callbackMutex);
+            if (m_callbacks.empty() || m_callbacks.begin()->first > lastSignaled) {
+                m_callbacks.clear();
+                break;
+            }
+        }
+        DispatchCompleted(lastSignaled);
+    }
+
+    for (HANDLE event : m_freeWaitEvents) {
+        CloseHandle(event);
+    }
+    CloseHandle(m_fenceEvent);
+    CloseHandle(m_wakeEvent);
+}
+
+uint64_t FenceTimeline::Signal()
+{
+    // 保证信号值按提交顺序递增
+    std::lock_guard<std::mutex> lock(m_signalMutex);
+    const uint64_t value = m_lastSignaled.load() + 1;
+    HRESULT hr = m_queue->Signal(m_fence.Get(), value);
+    if (FAILED(hr)) {
+        throw std::runtime_error("Failed to signal fence");
+    }
+    m_lastSignaled.store(value);
+    return value;
+}
+
+uint64_t FenceTimeline::GetCompletedValue()
+{
+    return m_fence->GetCompletedValue();
+}
+
+HANDLE FenceTimeline::AcquireWaitEvent()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        if (!m_freeWaitEvents.empty()) {
+            HANDLE event = m_freeWaitEvents.back();
+            m_freeWaitEvents.pop_back();
+            return event;
+        }
+    }
+
+    HANDLE event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (!event) {
+        throw std::runtime_error("Failed to create fence wait event");
+    }
+    return event;
+}
+
+void FenceTimeline::ReleaseWaitEvent(HANDLE event)
+{
+    std::lock_guard<std::mutex> lock(m_waitMutex);
+    m_freeWaitEvents.push_back(event);
+}
+
+void FenceTimeline::WaitForValue(uint64_t value)
+{
+    if (m_fence->GetCompletedValue() >= value) {
+        return;
+    }
+
+    // 锁只保护事件池，等待本身不持锁
+    HANDLE event = AcquireWaitEvent();
+    HRESULT hr = m_fence->SetEventOnCompletion(value, event);
+    if (FAILED(hr)) {
+        ReleaseWaitEvent(event);
+        throw std::runtime_error("Failed to set fence completion event");
+    }
+    WaitForSingleObject(event, INFINITE);
+    ReleaseWaitEvent(event);
+}
+
+void FenceTimeline::OnCompleted(uint64_t value, std::function<void()> callback)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_callbackMutex);
+        m_callbacks.emplace(value, std::move(callback));
+    }
+    // 让等待线程重新选择最早的目标值
+    SetEvent(m_wakeEvent);
+}
+
+size_t FenceTimeline::GetPendingCallbackCount() const
+{
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    return m_callbacks.size();
+}
+
+void FenceTimeline::WaiterThreadMain()
+{
+    // fence 上已经登记、还没触发的目标值。只有最早的目标值变了才重新登记，
+    // 被新回调唤醒或虚假唤醒时目标没变，原来的登记仍然有效
+    bool registered = false;
+    uint64_t registeredTarget = 0;
+    for (;;) {
+        bool hasTarget = false;
+        uint64_t target = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_callbackMutex);
+            if (m_stopping) {
+                return;
+            }
+            if (!m_callbacks.empty()) {
+                hasTarget = true;
+                target = m_callbacks.begin()->first;
+            }
+        }
+
+        if (hasTarget && (!registered || target != registeredTarget)) {
+            // 值已经完成时事件会被立即触发
+            HRESULT hr = m_fence->SetEventOnCompletion(target, m_fenceEvent);
+            registered = SUCCEEDED(hr);
+            registeredTarget = target;
+        }
+
+        HANDLE handles[] = { m_wakeEvent, m_fenceEvent };
+        WaitForMultipleObjects(registered ? 2 : 1, handles, FALSE, INFINITE);
+
+        const uint64_t completed = m_fence->GetCompletedValue();
+        if (registered && completed >= registeredTarget) {
+            // 登记的值已经完成，事件已经或即将触发，下一个目标要重新登记
+            registered = false;
+        }
+        DispatchCompleted(completed);
+    }
+}
+
+void FenceTimeline::DispatchCompleted(uint64_t completed)
+{
+    // 在锁外执行回调，回调里可以再注册新的回调
+    {
+        std::lock_guard<std::mutex> lock(m_callbackMutex);
+        auto end = m_callbacks.upper_bound(completed);
+        for (auto it = m_callbacks.begin(); it != end; ++it) {
+            m_readyCallbacks.push_back(std::move(it->second));
+        }
+        m_callbacks.erase(m_callbacks.begin(), end);
+    }
+
+    for (auto& callback : m_readyCallbacks) {
+        callback();
+    }
+    m_readyCallbacks.clear();
+}
@@ -0,0 +1,97 @@
+// FrameArena.cpp
+#include "FrameArena.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+const size_t PARTITION_ALIGNMENT = alignof(std::max_align_t);
+const size_t GROW_GRANULARITY = 64 * 1024;
+
+size_t AlignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+}
+
+FrameArena::FrameArena(size_t bytesPerFrame, uint32_t frameCount, std::pmr::memory_resource* upstream)
+    : m_upstream(upstream)
+{
+    if (frameCount == 0 || bytesPerFrame == 0) {
+        throw std::invalid_argument("FrameArena needs at least one non-empty partition");
+    }
+
+    m_partitions.resize(frameCount);
+    for (Partition& partition : m_partitions) {
+        partition.capacity = AlignUp(bytesPerFrame, PARTITION_ALIGNMENT);
+        partition.base = static_cast<std::byte*>(m_upstream->allocate(partition.capacity, PARTITION_ALIGNMENT));
+    }
+}
+
+FrameArena::~FrameArena()
+{
+    for (Partition& partition : m_partitions) {
+        ReleaseOverflow(partition);
+        m_upstream->deallocate(partition.base, partition.capacity, PARTITION_ALIGNMENT);
+    }
+}
+
+void FrameArena::BeginFrame()
+{
+    m_current = (m_current + 1) % static_cast<uint32_t>(m_partitions.size());
+    Partition& partition = m_partitions[m_current];
+
+    // 上次用这个分区时溢出了：释放溢出块，把分区扩大到上次的用量
+    if (partition.overflow) {
+        ReleaseOverflow(partition);
+        m_upstream->deallocate(partition.base, partition.capacity, PARTITION_ALIGNMENT);
+        partition.capacity = AlignUp(partition.demand, GROW_GRANULARITY);
+        partition.base = static_cast<std::byte*>(m_upstream->allocate(partition.capacity, PARTITION_ALIGNMENT));
+        m_stats.growCount++;
+    }
+
+    partition.offset = 0;
+    partition.demand = 0;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+{
+    Partition& partition = m_partitions[m_current];
+    // 按最坏情况的对齐填充计入用量，扩大后的分区一定能装下同样的请求序列
+    partition.demand += bytes + (alignment > PARTITION_ALIGNMENT ? alignment : 0);
+    m_stats.peakBytes = std::max<uint64_t>(m_stats.peakBytes, partition.demand);
+
+    const uintptr_t base = reinterpret_cast<uintptr_t>(partition.base);
+    const size_t aligned = static_cast<size_t>(AlignUp(base + partition.offset, alignment) - base);
+    if (aligned + bytes <= partition.capacity) {
+        partition.offset = aligned + bytes;
+        return partition.base + aligned;
+    }
+    return AllocateOverflow(partition, bytes, alignment);
+}
+
+void* FrameArena::AllocateOverflow(Partition& partition, size_t bytes, size_t alignment)
+{
+    const size_t headerSize = AlignUp(sizeof(OverflowBlock), PARTITION_ALIGNMENT);
+    const size_t blockSize = headerSize + bytes + (alignment > PARTITION_ALIGNMENT ? alignment : 0);
+    void* memory = m_upstream->allocate(blockSize, PARTITION_ALIGNMENT);
+
+    OverflowBlock* block = static_cast<OverflowBlock*>(memory);
+    block->next = partition.overflow;
+    block->size = blockSize;
+    partition.overflow = block;
+
+    m_stats.overflowCount++;
+    m_stats.overflowBytes += bytes;
+
+    const uintptr_t data = reinterpret_cast<uintptr_t>(memory) + headerSize;
+    return reinterpret_cast<void*>(AlignUp(data, alignment));
+}
+
+void FrameArena::ReleaseOverflow(Partition& partition)
+{
+    while (partition.overflow) {
+        OverflowBlock* block = partition.overflow;
+        partition.overflow = block->next;
+        m_upstream->deallocate(block, block->size, PARTITION_ALIGNMENT);
+    }
+}
@@ -0,0 +1,301 @@
+// FrameGraph.cpp
+#include "FrameGraph.h"
+#include <algorithm>
+#include <stdexcept>
+
+void FrameGraph::PassBuilder::Read(FrameGraphResource resource, uint32_t state)
+{
+    m_graph.AddAccess(m_pass, resource, state, false);
+}
+
+void FrameGraph::PassBuilder::Write(FrameGraphResource resource, uint32_t state)
+{
+    m_graph.AddAccess(m_pass, resource, state, true);
+}
+
+void FrameGraph::PassBuilder::SetSideEffect()
+{
+    m_graph.m_passes[m_pass].sideEffect = true;
+}
+
+void FrameGraph::Reset()
+{
+    m_resources.clear();
+    m_passes.clear();
+    m_accesses.clear();
+    m_order.clear();
+    m_transitions.clear();
+    m_aliasing.offsets.clear();
+    m_aliasing.predecessors.clear();
+    m_aliasing.groupSizes.clear();
+    m_aliasing.heapSize = 0;
+    m_aliasing.unaliasedSize = 0;
+    m_aliasing.peakLiveSize = 0;
+    m_compiled = false;
+}
+
+FrameGraphResource FrameGraph::Import(const char* name, uint32_t initialState, uint64_t physical)
+{
+    Resource resource = {};
+    resource.name = name;
+    resource.imported = true;
+    resource.initialState = initialState;
+    resource.physical = physical;
+    m_resources.push_back(resource);
+    return static_cast<FrameGraphResource>(m_resources.size() - 1);
+}
+
+FrameGraphResource FrameGraph::CreateTransient(const char* name, uint64_t size, uint64_t alignment, uint64_t userData, uint32_t heapGroup)
+{
+    Resource resource = {};
+    resource.name = name;
+    resource.imported = false;
+    resource.initialState = STATE_UNDEFINED;
+    resource.size = size;
+    resource.alignment = alignment;
+    resource.userData = userData;
+    resource.heapGroup = heapGroup;
+    m_resources.push_back(resource);
+    return static_cast<FrameGraphResource>(m_resources.size() - 1);
+}
+
+uint32_t FrameGraph::AddPass(const char* name, const SetupFn& setup, ExecuteFn execute)
+{
+    if (m_compiled) {
+        throw std::runtime_error("Failed to add frame graph pass after Compile");
+    }
+
+    const uint32_t index = static_cast<uint32_t>(m_passes.size());
+    Pass pass = {};
+    pass.name = name;
+    pass.execute = std::move(execute);
+    pass.firstAccess = m_accesses.size();
+    m_passes.push_back(std::move(pass));
+
+    PassBuilder builder(*this, index);
+    setup(builder);
+    m_passes[index].accessCount = m_accesses.size() - m_passes[index].firstAccess;
+    return index;
+}
+
+void FrameGraph::AddAccess(uint32_t pass, FrameGraphResource resource, uint32_t state, bool write)
+{
+    if (resource >= m_resources.size()) {
+        throw std::runtime_error("Failed to access frame graph resource: invalid handle");
+    }
+    m_accesses.push_back({ pass, resource, state, write });
+}
+
+void FrameGraph::Compile()
+{
+    CullPasses();
+
+    m_order.clear();
+    for (uint32_t i = 0; i < m_passes.size(); i++) {
+        if (!m_passes[i].culled) {
+            m_passes[i].position = static_cast<uint32_t>(m_order.size());
+            m_order.push_back(i);
+        }
+    }
+
+    ComputeLifetimes();
+    ComputeTransitions();
+    m_compiled = true;
+}
+
+void FrameGraph::CullPasses()
+{
+    // 引用计数：Pass 计写了几次，资源计被读了几次（导入资源算一次外部读取）
+    for (Pass& pass : m_passes) {
+        pass.writes = 0;
+        pass.culled = false;
+    }
+    for (Resource& resource : m_resources) {
+        resource.readers = resource.imported ? 1 : 0;
+    }
+    for (const Access& access : m_accesses) {
+        if (access.write) {
+            m_passes[access.pass].writes++;
+        } else {
+            m_resources[access.resource].readers++;
+        }
+    }
+
+    m_cullStack.clear();
+    auto cullPass = [this](Pass& pass) {
+        pass.culled = true;
+        for (size_t i = pass.firstAccess; i < pass.firstAccess + pass.accessCount; i++) {
+            const Access& access = m_accesses[i];
+            if (!access.write && --m_resources[access.resource].readers == 0) {
+                m_cullStack.push_back(access.resource);
+            }
+        }
+    };
+
+    for (FrameGraphResource i = 0; i < m_resources.size(); i++) {
+        if (m_resources[i].readers == 0) {
+            m_cullStack.push_back(i);
+        }
+    }
+    // 什么也不写又没有副作用的 Pass 直接剔除
+    for (Pass& pass : m_passes) {
+        if (pass.writes == 0 && !pass.sideEffect) {
+            cullPass(pass);
+        }
+    }
+
+    // 没人读的资源，它的写入者少一个有用的输出；输出都没人用时剔除写入者
+    while (!m_cullStack.empty()) {
+        const FrameGraphResource resource = m_cullStack.back();
+        m_cullStack.pop_back();
+        for (const Access& access : m_accesses) {
+            if (access.resource != resource || !access.write) {
+                continue;
+            }
+            Pass& writer = m_passes[access.pass];
+            if (writer.culled || writer.writes == 0) {
+                continue;
+            }
+            if (--writer.writes == 0 && !writer.sideEffect) {
+                cullPass(writer);
+            }
+        }
+    }
+}
+
+void FrameGraph::ComputeLifetimes()
+{
+    for (Resource& resource : m_resources) {
+        resource.firstUse = UNUSED;
+        resource.lastUse = UNUSED;
+        resource.heapOffset = 0;
+        resource.aliasPredecessor = INVALID_RESOURCE;
+    }
+    for (const Access& access : m_accesses) {
+        const Pass& pass = m_passes[access.pass];
+        if (pass.culled) {
+            continue;
+        }
+        Resource& resource = m_resources[access.resource];
+        if (resource.firstUse == UNUSED) {
+            resource.firstUse = pass.position;
+        }
+        resource.lastUse = pass.position;
+    }
+
+    // 只给实际用到的临时资源规划内存
+    m_aliasingRequests.clear();
+    m_aliasedResources.clear();
+    for (FrameGraphResource i = 0; i < m_resources.size(); i++) {
+        const Resource& resource = m_resources[i];
+        if (!resource.imported && resource.firstUse != UNUSED) {
+            m_aliasingRequests.push_back({ resource.size, resource.alignment, resource.firstUse, resource.lastUse, resource.heapGroup });
+            m_aliasedResources.push_back(i);
+        }
+    }
+    m_aliasing = PlanAliasing(m_aliasingRequests);
+    for (size_t i = 0; i < m_aliasedResources.size(); i++) {
+        Resource& resource = m_resources[m_aliasedResources[i]];
+        resource.heapOffset = m_aliasing.offsets[i];
+        if (m_aliasing.predecessors[i] != AliasingPlan::NO_PREDECESSOR) {
+            resource.aliasPredecessor = m_aliasedResources[m_aliasing.predecessors[i]];
+        }
+    }
+}
+
+void FrameGraph::ComputeTransitions()
+{
+    m_transitions.clear();
+    m_placedTransitions.clear();
+    m_currentStates.resize(m_resources.size());
+    m_lastUsePositions.assign(m_resources.size(), uint32_t(UNUSED));
+    for (size_t i = 0; i < m_resources.size(); i++) {
+        m_currentStates[i] = m_resources[i].initialState;
+    }
+
+    for (uint32_t passIndex : m_order) {
+        const Pass& pass = m_passes[passIndex];
+
+        const size_t end = pass.firstAccess + pass.accessCount;
+        for (size_t i = pass.firstAccess; i < end; i++) {
+            const FrameGraphResource resource = m_accesses[i].resource;
+
+            // 同一个 Pass 对同一资源的多次声明合成一个状态
+            bool seen = false;
+            for (size_t j = pass.firstAccess; j < i; j++) {
+                if (m_accesses[j].resource == resource) {
+                    seen = true;
+                    break;
+                }
+            }
+            if (seen) {
+                continue;
+            }
+            uint32_t state = 0;
+            for (size_t j = i; j < end; j++) {
+                if (m_accesses[j].resource == resource) {
+                    state |= m_accesses[j].state;
+                }
+            }
+
+            const uint32_t before = m_currentStates[resource];
+            if (before != state) {
+                // 上次使用之后隔着别的 Pass（导入资源这一帧第一次使用时从第一个 Pass 算起）就拆分；
+                // 临时资源的第一次使用要先激活，不拆
+                const uint32_t lastUse = m_lastUsePositions[resource];
+                const uint32_t beginPosition = lastUse == UNUSED ? 0 : lastUse + 1;
+                Split split = Split::None;
+                if (before != STATE_UNDEFINED && beginPosition < pass.position) {
+                    m_placedTransitions.push_back({ beginPosition, { resource, before, state, Split::Begin } });
+                    split = Split::End;
+                }
+                m_placedTransitions.push_back({ pass.position, { resource, before, state, split } });
+                m_currentStates[resource] = state;
+            }
+            m_lastUsePositions[resource] = pass.position;
+        }
+    }
+
+    // 按位置分到各个 Pass；Begin 比同一位置上的 Pass 自己的转换先发出
+    std::stable_sort(m_placedTransitions.begin(), m_placedTransitions.end(),
+        [](const PlacedTransition& a, const PlacedTransition& b) {
+            if (a.position != b.position) {
+                return a.position < b.position;
+            }
+            return a.transition.split == Split::Begin && b.transition.split != Split::Begin;
+        });
+    size_t next = 0;
+    for (uint32_t passIndex : m_order) {
+        Pass& pass = m_passes[passIndex];
+        pass.firstTransition = m_transitions.size();
+        while (next < m_placedTransitions.size() && m_placedTransitions[next].position == pass.position) {
+            m_transitions.push_back(m_placedTransitions[next].transition);
+            next++;
+        }
+        pass.transitionCount = m_transitions.size() - pass.firstTransition;
+    }
+}
+
+const FrameGraph::Transition* FrameGraph::GetPassTransitions(uint32_t pass, size_t& count) const
+{
+    const Pass& p = m_passes[pass];
+    count = p.culled ? 0 : p.transitionCount;
+    return count > 0 ? &m_transitions[p.firstTransition] : nullptr;
+}
+
+void FrameGraph::Execute(const BeforePassFn& beforePass)
+{
+    if (!m_compiled) {
+        throw std::runtime_error("Failed to execute frame graph before Compile");
+    }
+
+    for (uint32_t passIndex : m_order) {
+        Pass& pass = m_passes[passIndex];
+        if (beforePass) {
+            beforePass(passIndex, pass.transitionCount > 0 ? &m_transitions[pass.firstTransition] : nullptr, pass.transitionCount);
+        }
+        if (pass.execute) {
+            pass.execute();
+        }
+    }
+}
@@ -0,0 +1,37 @@
+// FrameRing.cpp
+#include "FrameRing.h"
+#include <stdexcept>
+
+FrameRing::FrameRing(IGpuTimeline& timeline, uint32_t frameCount)
+    : m_timeline(timeline), m_slotFenceValues(frameCount, 0)
+{
+    if (frameCount == 0) {
+        throw std::invalid_argument("FrameRing needs at least one frame slot");
+    }
+}
+
+uint32_t FrameRing::BeginFrame()
+{
+    const uint64_t slotValue = m_slotFenceValues[m_currentSlot];
+    if (!m_timeline.IsComplete(slotValue)) {
+        m_stallCount++;
+        m_timeline.WaitForValue(slotValue);
+    }
+    return m_currentSlot;
+}
+
+uint64_t FrameRing::EndFrame()
+{
+    const uint64_t value = m_timeline.Signal();
+    m_slotFenceValues[m_currentSlot] = value;
+    m_currentSlot = (m_currentSlot + 1) % GetFrameCount();
+    m_frameNumber++;
+    return value;
+}
+
+void FrameRing::WaitForIdle()
+{
+    for (uint64_t value : m_slotFenceValues) {
+        m_timeline.WaitForValue(value);
+    }
+}
@@ -0,0 +1,51 @@
+// FrameSubmitBatcher.cpp
+#include "FrameSubmitBatcher.h"
+
+FrameSubmitBatcher::FrameSubmitBatcher(QueueScheduler& scheduler, GpuQueue queue)
+    : m_scheduler(scheduler), m_queue(queue)
+{
+}
+
+void FrameSubmitBatcher::Add(CommandContext&& context)
+{
+    m_contexts.push_back(std::move(context));
+}
+
+void FrameSubmitBatcher::Add(std::pmr::vector<CommandContext>&& contexts)
+{
+    for (CommandContext& context : contexts) {
+        m_contexts.push_back(std::move(context));
+    }
+    contexts.clear();
+}
+
+GpuSyncPoint FrameSubmitBatcher::Flush()
+{
+    if (m_firstUnsubmitted == m_contexts.size()) {
+        return m_lastSubmission;
+    }
+
+    m_submitScratch.clear();
+    for (size_t i = m_firstUnsubmitted; i < m_contexts.size(); i++) {
+        m_submitScratch.push_back(m_contexts[i].list.Get());
+    }
+    m_lastSubmission = m_scheduler.Submit(m_queue, m_submitScratch.data(), static_cast<UINT>(m_submitScratch.size()));
+
+    m_frameStats.submissions++;
+    m_frameStats.commandLists += static_cast<uint32_t>(m_submitScratch.size());
+    m_totalSubmissions++;
+    m_firstUnsubmitted = m_contexts.size();
+    return m_lastSubmission;
+}
+
+void FrameSubmitBatcher::EndFrame(CommandListPool& pool, uint64_t fenceValue)
+{
+    for (CommandContext& context : m_contexts) {
+        pool.Release(context, fenceValue);
+    }
+    m_contexts.clear();
+    m_firstUnsubmitted = 0;
+
+    m_lastFrameStats = m_frameStats;
+    m_frameStats = Stats();
+}
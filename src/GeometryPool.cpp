@@ -0,0 +1,142 @@
+// GeometryPool.cpp
+#include "GeometryPool.h"
+#include "d3dx12.h"
+#include <stdexcept>
+
+GeometryPool::GeometryPool(
+    HeapManager& heapManager,
+    UploadEngine& uploadEngine,
+    DeferredReleaseQueue& releaseQueue,
+    IGpuTimeline& graphicsTimeline,
+    uint32_t vertexStride,
+    uint32_t maxVertices,
+    uint32_t maxIndices)
+    : m_heapManager(heapManager),
+      m_uploadEngine(uploadEngine),
+      m_releaseQueue(releaseQueue),
+      m_graphicsTimeline(graphicsTimeline),
+      m_vertexStride(vertexStride),
+      m_maxVertices(maxVertices),
+      m_maxIndices(maxIndices),
+      m_vertexAllocator(maxVertices),
+      m_indexAllocator(maxIndices)
+{
+    m_vertexBuffer = m_heapManager.CreateResource(
+        GpuMemoryCategory::Vertex,
+        D3D12_HEAP_TYPE_DEFAULT,
+        CD3DX12_RESOURCE_DESC::Buffer(static_cast<UINT64>(vertexStride) * maxVertices),
+        D3D12_RESOURCE_STATE_COMMON
+    );
+    m_indexBuffer = m_heapManager.CreateResource(
+        GpuMemoryCategory::Index,
+        D3D12_HEAP_TYPE_DEFAULT,
+        CD3DX12_RESOURCE_DESC::Buffer(static_cast<UINT64>(sizeof(uint32_t)) * maxIndices),
+        D3D12_RESOURCE_STATE_COMMON
+    );
+}
+
+GeometryPool::~GeometryPool()
+{
+    // 调用方保证 GPU 已经空闲
+    if (m_releaseCallback) {
+        m_releaseCallback(m_vertexBuffer.resource.Get());
+        m_releaseCallback(m_indexBuffer.resource.Get());
+    }
+    m_heapManager.Free(m_vertexBuffer);
+    m_heapManager.Free(m_indexBuffer);
+}
+
+MeshHandle GeometryPool::AddMesh(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount)
+{
+    MeshHandle mesh;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        mesh.vertexRange = m_vertexAllocator.Allocate(vertexCount);
+        if (!mesh.vertexRange.IsValid()) {
+            throw std::runtime_error("Geometry pool is out of vertex space");
+        }
+        mesh.indexRange = m_indexAllocator.Allocate(indexCount);
+        if (!mesh.indexRange.IsValid()) {
+            m_vertexAllocator.Free(mesh.vertexRange);
+            throw std::runtime_error("Geometry pool is out of index space");
+        }
+        m_meshCount++;
+    }
+
+    mesh.baseVertex = static_cast<uint32_t>(mesh.vertexRange.offset);
+    mesh.vertexCount = vertexCount;
+    mesh.startIndex = static_cast<uint32_t>(mesh.indexRange.offset);
+    mesh.indexCount = indexCount;
+
+    // 上传在复制队列上批量进行，由调用方决定什么时候 Flush
+    m_uploadEngine.UploadBuffer(m_vertexBuffer.resource.Get(), static_cast<uint64_t>(mesh.baseVertex) * m_vertexStride,
+        vertices, static_cast<uint64_t>(vertexCount) * m_vertexStride);
+    m_uploadEngine.UploadBuffer(m_indexBuffer.resource.Get(), static_cast<uint64_t>(mesh.startIndex) * sizeof(uint32_t),
+        indices, static_cast<uint64_t>(indexCount) * sizeof(uint32_t));
+    return mesh;
+}
+
+void GeometryPool::RemoveMesh(MeshHandle& mesh)
+{
+    if (!mesh.IsValid()) {
+        return;
+    }
+
+    // 已经录制的帧可能还在用这个区间
+    const TlsfAllocator::Allocation vertexRange = mesh.vertexRange;
+    const TlsfAllocator::Allocation indexRange = mesh.indexRange;
+    m_releaseQueue.Defer([this, vertexRange, indexRange]() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_vertexAllocator.Free(vertexRange);
+        m_indexAllocator.Free(indexRange);
+        m_meshCount--;
+    }, m_graphicsTimeline);
+    mesh = MeshHandle();
+}
+
+void GeometryPool::Bind(CommandStream& stream) const
+{
+    const D3D12_VERTEX_BUFFER_VIEW vertexView = GetVertexBufferView();
+    const D3D12_INDEX_BUFFER_VIEW indexView = GetIndexBufferView();
+    stream.SetVertexBuffer(0, vertexView.BufferLocation, vertexView.SizeInBytes, vertexView.StrideInBytes);
+    stream.SetIndexBuffer(indexView.BufferLocation, indexView.SizeInBytes, indexView.Format);
+}
+
+void GeometryPool::PrepareForDraw(GpuQueue consumer)
+{
+    m_uploadEngine.UseResource(consumer, m_vertexBuffer.resource.Get());
+    m_uploadEngine.UseResource(consumer, m_indexBuffer.resource.Get());
+}
+
+D3D12_VERTEX_BUFFER_VIEW GeometryPool::GetVertexBufferView() const
+{
+    D3D12_VERTEX_BUFFER_VIEW view = {};
+    view.BufferLocation = m_vertexBuffer.resource->GetGPUVirtualAddress();
+    view.SizeInBytes = m_vertexStride * m_maxVertices;
+    view.StrideInBytes = m_vertexStride;
+    return view;
+}
+
+D3D12_INDEX_BUFFER_VIEW GeometryPool::GetIndexBufferView() const
+{
+    D3D12_INDEX_BUFFER_VIEW view = {};
+    view.BufferLocation = m_indexBuffer.resource->GetGPUVirtualAddress();
+    view.SizeInBytes = static_cast<UINT>(sizeof(uint32_t)) * m_maxIndices;
+    view.Format = DXGI_FORMAT_R32_UINT;
+    return view;
+}
+
+GeometryPool::Stats GeometryPool::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const TlsfAllocator::Stats vertexStats = m_vertexAllocator.GetStats();
+    const TlsfAllocator::Stats indexStats = m_indexAllocator.GetStats();
+
+    Stats stats;
+    stats.meshCount = m_meshCount;
+    stats.verticesUsed = vertexStats.usedBytes;
+    stats.indicesUsed = indexStats.usedBytes;
+    stats.vertexFragmentation = vertexStats.fragmentation;
+    stats.indexFragmentation = indexStats.fragmentation;
+    return stats;
+}
@@ -0,0 +1,153 @@
+// GpuMemoryTracker.cpp
+#include "GpuMemoryTracker.h"
+#include <algorithm>
+#include "PrivateDataToken.h"
+
+using Microsoft::WRL::ComPtr;
+
+namespace {
+// 挂在被跟踪对象上的私有数据键
+const GUID TRACKER_TOKEN_GUID = { 0x6c2f4a1e, 0x93b7, 0x4d58, { 0xa2, 0x0c, 0x5e, 0x71, 0xb8, 0x3d, 0x94, 0xf6 } };
+}
+
+const char* GetGpuMemoryCategoryName(GpuMemoryCategory category)
+{
+    switch (category) {
+    case GpuMemoryCategory::Vertex: return "Vertex";
+    case GpuMemoryCategory::Index: return "Index";
+    case GpuMemoryCategory::Buffer: return "Buffer";
+    case GpuMemoryCategory::Texture: return "Texture";
+    case GpuMemoryCategory::RenderTarget: return "RenderTarget";
+    case GpuMemoryCategory::Upload: return "Upload";
+    case GpuMemoryCategory::Readback: return "Readback";
+    case GpuMemoryCategory::Heap: return "Heap";
+    default: return "Unknown";
+    }
+}
+
+void GpuMemoryTracker::Ledger::Add(GpuMemoryCategory category, uint64_t bytes, bool placed)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    CategoryStats& stats = categories[static_cast<size_t>(category)];
+    stats.liveBytes += bytes;
+    stats.peakBytes = std::max(stats.peakBytes, stats.liveBytes);
+    stats.liveCount++;
+    stats.allocations++;
+    if (!placed) {
+        trackedBytes += bytes;
+        peakTrackedBytes = std::max(peakTrackedBytes, trackedBytes);
+    }
+}
+
+void GpuMemoryTracker::Ledger::Remove(GpuMemoryCategory category, uint64_t bytes, bool placed)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    CategoryStats& stats = categories[static_cast<size_t>(category)];
+    stats.liveBytes -= bytes;
+    stats.liveCount--;
+    if (!placed) {
+        trackedBytes -= bytes;
+    }
+}
+
+GpuMemoryTracker::GpuMemoryTracker(ID3D12Device* device, IDXGIAdapter3* adapter)
+    : m_device(device), m_adapter(adapter), m_ledger(std::make_shared<Ledger>())
+{
+}
+
+HRESULT GpuMemoryTracker::Track(HRESULT hr, void** object, GpuMemoryCategory category, uint64_t bytes, bool placed)
+{
+    if (FAILED(hr) || !object || !*object) {
+        return hr;
+    }
+
+    ComPtr<ID3D12Object> d3dObject;
+    if (FAILED(static_cast<IUnknown*>(*object)->QueryInterface(IID_PPV_ARGS(&d3dObject)))) {
+        return hr;
+    }
+
+    // 对象销毁时从记账里扣除；令牌挂不上时回调立即执行，记账两边抵消
+    m_ledger->Add(category, bytes, placed);
+    std::shared_ptr<Ledger> ledger = m_ledger;
+    PrivateDataToken::Attach(d3dObject.Get(), TRACKER_TOKEN_GUID, [ledger, category, bytes, placed]() {
+        ledger->Remove(category, bytes, placed);
+    });
+    return hr;
+}
+
+HRESULT GpuMemoryTracker::CreateCommittedResource(
+    GpuMemoryCategory category,
+    const D3D12_HEAP_PROPERTIES* heapProperties,
+    D3D12_HEAP_FLAGS heapFlags,
+    const D3D12_RESOURCE_DESC* desc,
+    D3D12_RESOURCE_STATES initialState,
+    const D3D12_CLEAR_VALUE* clearValue,
+    REFIID riid,
+    void** resource)
+{
+    // 提交资源有自己的隐式堆，至少按 64KB 占用显存
+    const D3D12_RESOURCE_ALLOCATION_INFO info = m_device->GetResourceAllocationInfo(0, 1, desc);
+    const uint64_t alignment = std::max<uint64_t>(info.Alignment, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+    const uint64_t bytes = (info.SizeInBytes + alignment - 1) / alignment * alignment;
+
+    const HRESULT hr = m_device->CreateCommittedResource(heapProperties, heapFlags, desc, initialState, clearValue, riid, resource);
+    return Track(hr, resource, category, bytes, false);
+}
+
+HRESULT GpuMemoryTracker::CreatePlacedResource(
+    GpuMemoryCategory category,
+    ID3D12Heap* heap,
+    UINT64 heapOffset,
+    const D3D12_RESOURCE_DESC* desc,
+    D3D12_RESOURCE_STATES initialState,
+    const D3D12_CLEAR_VALUE* clearValue,
+    REFIID riid,
+    void** resource)
+{
+    const D3D12_RESOURCE_ALLOCATION_INFO info = m_device->GetResourceAllocationInfo(0, 1, desc);
+    const HRESULT hr = m_device->CreatePlacedResource(heap, heapOffset, desc, initialState, clearValue, riid, resource);
+    return Track(hr, resource, category, info.SizeInBytes, true);
+}
+
+HRESULT GpuMemoryTracker::CreateHeap(const D3D12_HEAP_DESC* desc, REFIID riid, void** heap)
+{
+    const HRESULT hr = m_device->CreateHeap(desc, riid, heap);
+    return Track(hr, heap, GpuMemoryCategory::Heap, desc->SizeInBytes, false);
+}
+
+GpuMemoryTracker::CategoryStats GpuMemoryTracker::GetStats(GpuMemoryCategory category) const
+{
+    std::lock_guard<std::mutex> lock(m_ledger->mutex);
+    return m_ledger->categories[static_cast<size_t>(category)];
+}
+
+uint64_t GpuMemoryTracker::GetTrackedBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_ledger->mutex);
+    return m_ledger->trackedBytes;
+}
+
+uint64_t GpuMemoryTracker::GetPeakTrackedBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_ledger->mutex);
+    return m_ledger->peakTrackedBytes;
+}
+
+GpuMemoryBudget GpuMemoryTracker::QueryBudget() const
+{
+    GpuMemoryBudget budget;
+    budget.trackedBytes = GetTrackedBytes();
+
+    DXGI_QUERY_VIDEO_MEMORY_INFO info = {};
+    if (m_adapter && SUCCEEDED(m_adapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &info))) {
+        budget.budget = info.Budget;
+        budget.currentUsage = info.CurrentUsage;
+    }
+    return budget;
+}
+
+bool GpuMemoryTracker::CanAllocate(uint64_t bytes) const
+{
+    const GpuMemoryBudget budget = QueryBudget();
+    return budget.budget == 0 || bytes <= budget.GetAvailable();
+}
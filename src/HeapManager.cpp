@@ -0,0 +1,166 @@
+// HeapManager.cpp
+#include "HeapManager.h"
+#include <stdexcept>
+
+HeapManager::HeapManager(ID3D12Device* device, GpuMemoryTracker& memoryTracker, uint64_t blockSize)
+    : m_device(device), m_memoryTracker(memoryTracker), m_blockSize(blockSize)
+{
+}
+
+HeapManager::ResourceClass HeapManager::Classify(const D3D12_RESOURCE_DESC& desc)
+{
+    if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER) {
+        return ResourceClass::Buffer;
+    }
+    if (desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) {
+        return ResourceClass::RenderTargetTexture;
+    }
+    return ResourceClass::OtherTexture;
+}
+
+uint32_t HeapManager::CreateHeapBlock(D3D12_HEAP_TYPE heapType, ResourceClass resourceClass, uint64_t size, uint64_t alignment)
+{
+    D3D12_HEAP_DESC heapDesc = {};
+    heapDesc.SizeInBytes = size;
+    heapDesc.Properties.Type = heapType;
+    heapDesc.Alignment = alignment;
+    switch (resourceClass) {
+    case ResourceClass::Buffer:
+        heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+        break;
+    case ResourceClass::RenderTargetTexture:
+        heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+        break;
+    default:
+        heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+        break;
+    }
+
+    HeapBlock block;
+    if (FAILED(m_memoryTracker.CreateHeap(&heapDesc, IID_PPV_ARGS(&block.heap)))) {
+        throw std::runtime_error("Failed to create resource heap");
+    }
+    block.heapType = heapType;
+    block.resourceClass = resourceClass;
+    block.alignment = alignment;
+    block.allocator = std::make_unique<TlsfAllocator>(size);
+
+    for (uint32_t i = 0; i < m_heaps.size(); i++) {
+        if (!m_heaps[i].heap) {
+            m_heaps[i] = std::move(block);
+            return i;
+        }
+    }
+    m_heaps.push_back(std::move(block));
+    return static_cast<uint32_t>(m_heaps.size() - 1);
+}
+
+HeapAllocation HeapManager::CreateResource(
+    GpuMemoryCategory category,
+    D3D12_HEAP_TYPE heapType,
+    const D3D12_RESOURCE_DESC& desc,
+    D3D12_RESOURCE_STATES initialState,
+    const D3D12_CLEAR_VALUE* clearValue)
+{
+    const D3D12_RESOURCE_ALLOCATION_INFO info = m_device->GetResourceAllocationInfo(0, 1, &desc);
+    if (info.SizeInBytes == UINT64_MAX) {
+        throw std::invalid_argument("Invalid resource description for placed resource");
+    }
+    const ResourceClass resourceClass = Classify(desc);
+    // 多重采样纹理要 4MB 对齐，放在 4MB 对齐的堆里
+    const uint64_t heapAlignment = info.Alignment > D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT
+        ? D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT
+        : D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    HeapAllocation allocation;
+    for (uint32_t i = 0; i < m_heaps.size() && !allocation.range.IsValid(); i++) {
+        HeapBlock& block = m_heaps[i];
+        if (!block.heap || block.heapType != heapType || block.resourceClass != resourceClass || block.alignment < heapAlignment) {
+            continue;
+        }
+        allocation.range = block.allocator->Allocate(info.SizeInBytes, info.Alignment);
+        allocation.heapIndex = i;
+    }
+
+    if (!allocation.range.IsValid()) {
+        // 大资源单独占一个堆
+        const uint64_t size = info.SizeInBytes > m_blockSize
+            ? (info.SizeInBytes + heapAlignment - 1) / heapAlignment * heapAlignment
+            : m_blockSize;
+        allocation.heapIndex = CreateHeapBlock(heapType, resourceClass, size, heapAlignment);
+        allocation.range = m_heaps[allocation.heapIndex].allocator->Allocate(info.SizeInBytes, info.Alignment);
+        if (!allocation.range.IsValid()) {
+            // 新堆放不下说明对齐要求超过了堆的对齐，不把空堆留在列表里
+            m_heaps[allocation.heapIndex].heap.Reset();
+            m_heaps[allocation.heapIndex].allocator.reset();
+            throw std::runtime_error("Failed to allocate resource range from a new heap");
+        }
+    }
+
+    HeapBlock& block = m_heaps[allocation.heapIndex];
+    HRESULT hr = m_memoryTracker.CreatePlacedResource(
+        category, block.heap.Get(), allocation.range.offset, &desc, initialState, clearValue, IID_PPV_ARGS(&allocation.resource));
+    if (FAILED(hr)) {
+        block.allocator->Free(allocation.range);
+        throw std::runtime_error("Failed to create placed resource");
+    }
+    return allocation;
+}
+
+void HeapManager::Free(HeapAllocation& allocation)
+{
+    if (!allocation.IsValid()) {
+        return;
+    }
+    allocation.resource.Reset();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_heaps[allocation.heapIndex].allocator->Free(allocation.range);
+    allocation.range = TlsfAllocator::Allocation();
+    allocation.heapIndex = 0xffffffffu;
+}
+
+void HeapManager::Trim()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (uint32_t i = 0; i < m_heaps.size(); i++) {
+        HeapBlock& block = m_heaps[i];
+        if (!block.heap || !block.allocator->IsEmpty()) {
+            continue;
+        }
+
+        // 同一类别里更早的堆还在时才释放
+        bool keep = true;
+        for (uint32_t j = 0; j < i; j++) {
+            if (m_heaps[j].heap && m_heaps[j].heapType == block.heapType && m_heaps[j].resourceClass == block.resourceClass) {
+                keep = false;
+                break;
+            }
+        }
+        if (!keep) {
+            block.heap.Reset();
+            block.allocator.reset();
+        }
+    }
+}
+
+HeapManager::Stats HeapManager::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats;
+    double weightedFragmentation = 0.0;
+    for (const HeapBlock& block : m_heaps) {
+        if (!block.heap) {
+            continue;
+        }
+        const TlsfAllocator::Stats heapStats = block.allocator->GetStats();
+        stats.heapCount++;
+        stats.reservedBytes += heapStats.capacity;
+        stats.usedBytes += heapStats.usedBytes;
+        stats.allocationCount += heapStats.allocationCount;
+        weightedFragmentation += heapStats.fragmentation * heapStats.capacity;
+    }
+    stats.fragmentation = stats.reservedBytes > 0 ? weightedFragmentation / stats.reservedBytes : 0.0;
+    return stats;
+}
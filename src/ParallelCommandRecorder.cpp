@@ -0,0 +1,59 @@
+// ParallelCommandRecorder.cpp
+#include "ParallelCommandRecorder.h"
+#include <algorithm>
+#include <stdexcept>
+
+ParallelCommandRecorder::ParallelCommandRecorder(CommandListPool& pool, WorkerPool& workers)
+    : m_pool(pool), m_workers(workers)
+{
+}
+
+size_t ParallelCommandRecorder::GetChunkCount(size_t drawCount, size_t minDrawsPerChunk) const
+{
+    if (drawCount == 0) {
+        return 0;
+    }
+
+    // 块数：不超过可用线程数，每块也不少于 minDrawsPerChunk 个绘制
+    const size_t threadCount = static_cast<size_t>(m_workers.GetThreadCount()) + 1;
+    const size_t minChunk = std::max<size_t>(minDrawsPerChunk, 1);
+    const size_t chunkCount = std::min(threadCount, (drawCount + minChunk - 1) / minChunk);
+    const size_t drawsPerChunk = (drawCount + chunkCount - 1) / chunkCount;
+    return (drawCount + drawsPerChunk - 1) / drawsPerChunk; // 避免出现空块
+}
+
+std::pmr::vector<CommandContext> ParallelCommandRecorder::Record(
+    size_t drawCount,
+    size_t minDrawsPerChunk,
+    ID3D12PipelineState* initialState,
+    RecordChunkFn recordChunk,
+    std::pmr::memory_resource* memory)
+{
+    std::pmr::vector<CommandContext> contexts(memory);
+    if (drawCount == 0) {
+        m_lastChunkCount = 0;
+        return contexts;
+    }
+
+    const size_t chunkCount = GetChunkCount(drawCount, minDrawsPerChunk);
+    const size_t drawsPerChunk = (drawCount + chunkCount - 1) / chunkCount;
+
+    contexts.resize(chunkCount);
+    m_workers.ParallelFor(chunkCount, [&](size_t chunk) {
+        const size_t first = chunk * drawsPerChunk;
+        const size_t count = std::min(drawsPerChunk, drawCount - first);
+
+        CommandContext& context = contexts[chunk];
+        context = m_pool.Acquire(D3D12_COMMAND_LIST_TYPE_DIRECT, initialState);
+        recordChunk(context.list.Get(), chunk, first, count);
+
+        HRESULT hr = context.list->Close();
+        if (FAILED(hr)) {
+            throw std::runtime_error("Failed to close parallel command list");
+        }
+    });
+
+    m_lastChunkCount = chunkCount;
+    return contexts;
+}
+
@@ -0,0 +1,268 @@
+// PipelineStateCache.cpp
+#include "PipelineStateCache.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "Hash.h"
+
+namespace {
+// 把字段逐个追加到键里，不带结构体填充。
+// 缓冲区按需成倍扩大，写完后 Finish 截到实际长度，复用同一个缓冲区时不再分配
+class KeyWriter {
+public:
+    explicit KeyWriter(std::vector<uint8_t>& key) : m_key(key) {}
+
+    template <typename T>
+    void Put(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Key fields must be POD");
+        PutBytes(&value, sizeof(T));
+    }
+
+    void PutString(const char* text)
+    {
+        const size_t length = text ? std::strlen(text) : 0;
+        Put(static_cast<uint32_t>(length));
+        PutBytes(text, length);
+    }
+
+    void PutShader(const D3D12_SHADER_BYTECODE& shader)
+    {
+        Put(static_cast<uint64_t>(shader.BytecodeLength));
+        Put(HashShader(shader));
+    }
+
+    void Finish() { m_key.resize(m_size); }
+
+private:
+    // DXBC 容器（FXC 和 DXC 的输出都是）头部自带 16 字节的内容摘要，直接用它，不用把几 KB 的字节码都哈希一遍；
+    // 摘要为 0（没有经过验证器）或者不是容器时再哈希全部内容
+    static uint64_t HashShader(const D3D12_SHADER_BYTECODE& shader)
+    {
+        if (shader.BytecodeLength == 0) {
+            return 0;
+        }
+        const uint8_t* bytes = static_cast<const uint8_t*>(shader.pShaderBytecode);
+        const size_t DIGEST_OFFSET = 4;
+        const size_t DIGEST_SIZE = 16;
+        if (shader.BytecodeLength >= DIGEST_OFFSET + DIGEST_SIZE && std::memcmp(bytes, "DXBC", 4) == 0) {
+            static const uint8_t zeroDigest[DIGEST_SIZE] = {};
+            if (std::memcmp(bytes + DIGEST_OFFSET, zeroDigest, DIGEST_SIZE) != 0) {
+                return HashBytes(bytes + DIGEST_OFFSET, DIGEST_SIZE);
+            }
+        }
+        return HashBytes(bytes, shader.BytecodeLength);
+    }
+
+    void PutBytes(const void* data, size_t size)
+    {
+        if (m_size + size > m_key.size()) {
+            m_key.resize(std::max(m_key.size() * 2, m_size + size + INITIAL_KEY_SIZE));
+        }
+        if (size > 0) {
+            std::memcpy(m_key.data() + m_size, data, size);
+        }
+        m_size += size;
+    }
+
+    static constexpr size_t INITIAL_KEY_SIZE = 512;
+
+    std::vector<uint8_t>& m_key;
+    size_t m_size = 0;
+};
+}
+
+PipelineStateCache::PipelineStateCache(IPipelineStateCreator& creator)
+    : m_creator(creator)
+{
+    m_tables.push_back(std::make_unique<Table>(INITIAL_CAPACITY));
+    m_table.store(m_tables.back().get(), std::memory_order_release);
+}
+
+void PipelineStateCache::BuildKey(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, std::vector<uint8_t>& key)
+{
+    KeyWriter writer(key);
+    writer.Put(reinterpret_cast<uint64_t>(desc.pRootSignature));
+
+    writer.PutShader(desc.VS);
+    writer.PutShader(desc.PS);
+    writer.PutShader(desc.DS);
+    writer.PutShader(desc.HS);
+    writer.PutShader(desc.GS);
+
+    const D3D12_STREAM_OUTPUT_DESC& streamOutput = desc.StreamOutput;
+    writer.Put(streamOutput.NumEntries);
+    for (UINT i = 0; i < streamOutput.NumEntries; i++) {
+        const D3D12_SO_DECLARATION_ENTRY& entry = streamOutput.pSODeclaration[i];
+        writer.Put(entry.Stream);
+        writer.PutString(entry.SemanticName);
+        writer.Put(entry.SemanticIndex);
+        writer.Put(entry.StartComponent);
+        writer.Put(entry.ComponentCount);
+        writer.Put(entry.OutputSlot);
+    }
+    writer.Put(streamOutput.NumStrides);
+    for (UINT i = 0; i < streamOutput.NumStrides; i++) {
+        writer.Put(streamOutput.pBufferStrides[i]);
+    }
+    writer.Put(streamOutput.NumEntries ? streamOutput.RasterizedStream : 0u);
+
+    // 关闭独立混合时只有第一个渲染目标的设置生效
+    const D3D12_BLEND_DESC& blend = desc.BlendState;
+    writer.Put(blend.AlphaToCoverageEnable);
+    writer.Put(blend.IndependentBlendEnable);
+    const UINT blendTargets = blend.IndependentBlendEnable ? D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT : 1;
+    for (UINT i = 0; i < blendTargets; i++) {
+        const D3D12_RENDER_TARGET_BLEND_DESC& target = blend.RenderTarget[i];
+        writer.Put(target.BlendEnable);
+        writer.Put(target.LogicOpEnable);
+        writer.Put(target.SrcBlend);
+        writer.Put(target.DestBlend);
+        writer.Put(target.BlendOp);
+        writer.Put(target.SrcBlendAlpha);
+        writer.Put(target.DestBlendAlpha);
+        writer.Put(target.BlendOpAlpha);
+        writer.Put(target.LogicOp);
+        writer.Put(target.RenderTargetWriteMask);
+    }
+    writer.Put(desc.SampleMask);
+
+    const D3D12_RASTERIZER_DESC& raster = desc.RasterizerState;
+    writer.Put(raster.FillMode);
+    writer.Put(raster.CullMode);
+    writer.Put(raster.FrontCounterClockwise);
+    writer.Put(raster.DepthBias);
+    writer.Put(raster.DepthBiasClamp);
+    writer.Put(raster.SlopeScaledDepthBias);
+    writer.Put(raster.DepthClipEnable);
+    writer.Put(raster.MultisampleEnable);
+    writer.Put(raster.AntialiasedLineEnable);
+    writer.Put(raster.ForcedSampleCount);
+    writer.Put(raster.ConservativeRaster);
+
+    const D3D12_DEPTH_STENCIL_DESC& depth = desc.DepthStencilState;
+    writer.Put(depth.DepthEnable);
+    writer.Put(depth.DepthWriteMask);
+    writer.Put(depth.DepthFunc);
+    writer.Put(depth.StencilEnable);
+    writer.Put(depth.StencilReadMask);
+    writer.Put(depth.StencilWriteMask);
+    for (const D3D12_DEPTH_STENCILOP_DESC* face : { &depth.FrontFace, &depth.BackFace }) {
+        writer.Put(face->StencilFailOp);
+        writer.Put(face->StencilDepthFailOp);
+        writer.Put(face->StencilPassOp);
+        writer.Put(face->StencilFunc);
+    }
+
+    writer.Put(desc.InputLayout.NumElements);
+    for (UINT i = 0; i < desc.InputLayout.NumElements; i++) {
+        const D3D12_INPUT_ELEMENT_DESC& element = desc.InputLayout.pInputElementDescs[i];
+        writer.PutString(element.SemanticName);
+        writer.Put(element.SemanticIndex);
+        writer.Put(element.Format);
+        writer.Put(element.InputSlot);
+        writer.Put(element.AlignedByteOffset);
+        writer.Put(element.InputSlotClass);
+        writer.Put(element.InstanceDataStepRate);
+    }
+
+    writer.Put(desc.IBStripCutValue);
+    writer.Put(desc.PrimitiveTopologyType);
+    writer.Put(desc.NumRenderTargets);
+    for (UINT i = 0; i < desc.NumRenderTargets && i < D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT; i++) {
+        writer.Put(desc.RTVFormats[i]);
+    }
+    writer.Put(desc.DSVFormat);
+    writer.Put(desc.SampleDesc.Count);
+    writer.Put(desc.SampleDesc.Quality);
+    writer.Put(desc.NodeMask);
+    writer.Put(desc.Flags);
+    writer.Finish();
+}
+
+uint64_t PipelineStateCache::HashKey(const std::vector<uint8_t>& key)
+{
+    return HashBytes(key.data(), key.size());
+}
+
+PipelineStateCache::Entry* PipelineStateCache::Find(const Table& table, uint64_t hash, const std::vector<uint8_t>& key)
+{
+    for (size_t slot = hash & table.mask;; slot = (slot + 1) & table.mask) {
+        Entry* entry = table.slots[slot].load(std::memory_order_acquire);
+        if (!entry) {
+            return nullptr;
+        }
+        if (entry->hash == hash && entry->key == key) {
+            return entry;
+        }
+    }
+}
+
+void PipelineStateCache::Insert(Table& table, Entry* entry)
+{
+    size_t slot = entry->hash & table.mask;
+    while (table.slots[slot].load(std::memory_order_relaxed)) {
+        slot = (slot + 1) & table.mask;
+    }
+    table.slots[slot].store(entry, std::memory_order_release);
+}
+
+ID3D12PipelineState* PipelineStateCache::GetOrCreate(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc)
+{
+    // 每个线程复用自己的键缓冲区，稳定后命中路径不分配内存
+    thread_local std::vector<uint8_t> key;
+    BuildKey(desc, key);
+    const uint64_t hash = HashKey(key);
+
+    m_lookups.fetch_add(1, std::memory_order_relaxed);
+    if (Entry* entry = Find(*m_table.load(std::memory_order_acquire), hash, key)) {
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        return entry->pipeline.Get();
+    }
+
+    std::lock_guard<std::mutex> lock(m_insertMutex);
+    Table* table = m_table.load(std::memory_order_relaxed);
+    // 等锁的时候可能已经被别的线程创建了
+    if (Entry* entry = Find(*table, hash, key)) {
+        m_hits.fetch_add(1, std::memory_order_relaxed);
+        return entry->pipeline.Get();
+    }
+
+    std::unique_ptr<Entry> entry = std::make_unique<Entry>();
+    entry->hash = hash;
+    entry->key = key;
+    entry->rootSignature = desc.pRootSignature;
+    HRESULT hr = m_creator.CreateGraphicsPipelineState(desc, &entry->pipeline);
+    if (FAILED(hr) || !entry->pipeline) {
+        throw std::runtime_error("Failed to create pipeline state");
+    }
+    m_creations.fetch_add(1, std::memory_order_relaxed);
+
+    // 负载超过一半时换一张两倍大的表；旧表留着，正在查找的线程还可能在读
+    if ((m_entries.size() + 1) * 2 > table->mask + 1) {
+        m_tables.push_back(std::make_unique<Table>((table->mask + 1) * 2));
+        table = m_tables.back().get();
+        for (const std::unique_ptr<Entry>& existing : m_entries) {
+            Insert(*table, existing.get());
+        }
+    }
+    Insert(*table, entry.get());
+    m_table.store(table, std::memory_order_release);
+
+    m_entries.push_back(std::move(entry));
+    return m_entries.back()->pipeline.Get();
+}
+
+size_t PipelineStateCache::GetSize() const
+{
+    return static_cast<size_t>(m_creations.load(std::memory_order_relaxed));
+}
+
+PipelineStateCache::Stats PipelineStateCache::GetStats() const
+{
+    Stats stats;
+    stats.lookups = m_lookups.load(std::memory_order_relaxed);
+    stats.hits = m_hits.load(std::memory_order_relaxed);
+    stats.creations = m_creations.load(std::memory_order_relaxed);
+    return stats;
+}
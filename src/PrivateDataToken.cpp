@@ -0,0 +1,34 @@
+// PrivateDataToken.cpp
+#include "PrivateDataToken.h"
+#include <wrl.h>
+
+void PrivateDataToken::Attach(ID3D12Object* object, REFGUID guid, std::function<void()> onRelease)
+{
+    Microsoft::WRL::ComPtr<PrivateDataToken> token;
+    token.Attach(new PrivateDataToken(std::move(onRelease)));
+    object->SetPrivateDataInterface(guid, token.Get());
+}
+
+HRESULT STDMETHODCALLTYPE PrivateDataToken::QueryInterface(REFIID riid, void** object)
+{
+    if (!object) {
+        return E_POINTER;
+    }
+    if (riid == __uuidof(IUnknown)) {
+        AddRef();
+        *object = static_cast<IUnknown*>(this);
+        return S_OK;
+    }
+    *object = nullptr;
+    return E_NOINTERFACE;
+}
+
+ULONG STDMETHODCALLTYPE PrivateDataToken::Release()
+{
+    const ULONG count = --m_refCount;
+    if (count == 0) {
+        m_onRelease();
+        delete this;
+    }
+    return count;
+}
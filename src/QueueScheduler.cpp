@@ -0,0 +1,116 @@
+// QueueScheduler.cpp
+#include "QueueScheduler.h"
+#include <algorithm>
+#include <stdexcept>
+
+QueueScheduler::QueueState& QueueScheduler::GetQueue(GpuQueue queue)
+{
+    QueueState& state = m_queues[static_cast<size_t>(queue)];
+    if (!state.timeline) {
+        throw std::invalid_argument("Queue is not registered with the scheduler");
+    }
+    return state;
+}
+
+const QueueScheduler::QueueState& QueueScheduler::GetQueue(GpuQueue queue) const
+{
+    const QueueState& state = m_queues[static_cast<size_t>(queue)];
+    if (!state.timeline) {
+        throw std::invalid_argument("Queue is not registered with the scheduler");
+    }
+    return state;
+}
+
+void QueueScheduler::RegisterQueue(GpuQueue queue, FenceTimeline& timeline)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    QueueState& state = m_queues[static_cast<size_t>(queue)];
+    state = QueueState();
+    state.timeline = &timeline;
+    state.lastCompletion = Clock::now();
+}
+
+void QueueScheduler::AddDependency(GpuQueue queue, const GpuSyncPoint& point)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    QueueState& state = GetQueue(queue);
+    const size_t source = static_cast<size_t>(point.queue);
+
+    // 同一队列上的提交本来就按顺序执行
+    if (!point.IsValid() || point.queue == queue) {
+        state.stats.waitsSkipped++;
+        return;
+    }
+    state.pendingWaits[source] = std::max(state.pendingWaits[source], point.value);
+}
+
+GpuSyncPoint QueueScheduler::Submit(GpuQueue queue, ID3D12CommandList* const* commandLists, UINT count)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    QueueState& state = GetQueue(queue);
+    ID3D12CommandQueue* commandQueue = state.timeline->GetQueue();
+
+    for (size_t source = 0; source < QUEUE_COUNT; source++) {
+        const uint64_t value = state.pendingWaits[source];
+        if (value == 0) {
+            continue;
+        }
+        state.pendingWaits[source] = 0;
+
+        // 已经等过更大的值，或者 GPU 已经做完了，就不用再插 Wait
+        FenceTimeline* sourceTimeline = m_queues[source].timeline;
+        if (value <= state.waitedValues[source] || sourceTimeline->IsComplete(value)) {
+            state.stats.waitsSkipped++;
+            continue;
+        }
+        if (FAILED(commandQueue->Wait(sourceTimeline->GetFence(), value))) {
+            throw std::runtime_error("Failed to insert cross-queue wait");
+        }
+        state.waitedValues[source] = value;
+        state.stats.waitsIssued++;
+    }
+
+    if (count > 0) {
+        commandQueue->ExecuteCommandLists(count, commandLists);
+    }
+    const Clock::time_point submitTime = Clock::now();
+    const uint64_t value = state.timeline->Signal();
+    state.stats.submissions++;
+    state.stats.commandLists += count;
+
+    state.timeline->OnCompleted(value, [this, queue, submitTime]() {
+        OnSubmissionCompleted(queue, submitTime);
+    });
+    return { queue, value };
+}
+
+void QueueScheduler::OnSubmissionCompleted(GpuQueue queue, Clock::time_point submitTime)
+{
+    // 在时间线的等待线程上执行，同一队列的回调按 fence 值顺序到达
+    std::lock_guard<std::mutex> lock(m_mutex);
+    QueueState& state = m_queues[static_cast<size_t>(queue)];
+    const Clock::time_point now = Clock::now();
+    const Clock::time_point start = std::max(submitTime, state.lastCompletion);
+    if (now > start) {
+        state.stats.busySeconds += std::chrono::duration<double>(now - start).count();
+    }
+    state.lastCompletion = now;
+}
+
+FenceTimeline& QueueScheduler::GetTimeline(GpuQueue queue) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return *GetQueue(queue).timeline;
+}
+
+GpuSyncPoint QueueScheduler::GetLastSubmission(GpuQueue queue) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return { queue, GetQueue(queue).timeline->GetLastSignaledValue() };
+}
+
+QueueScheduler::QueueStats QueueScheduler::GetStats(GpuQueue queue) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return GetQueue(queue).stats;
+}
@@ -6,6 +6,7 @@
 #include <d3d12sdklayers.h>
 #include <wrl.h>
 #include "d3dx12.h"
+#include "D3D12CommandBackend.h"
 #include <filesystem>
 
 using namespace Microsoft::WRL;
@@ -25,6 +26,48 @@ Vertex triangleVertices[] =
     { XMFLOAT3(-0.5f, -0.5f, 0.0f ), XMFLOAT4(0.0f, 0.0f, 1.0f, 1.0f) }  // Left
 };
 
+uint32_t triangleIndices[] = { 0, 1, 2 };
+
+// 与 vertex_shader.hlsl 的 DrawConstants 对应，每次绘制一个元素
+struct DrawConstants
+{
+    XMFLOAT4 offset;
+};
+
+// 与 vertex_shader.hlsl 的 cbuffer DrawRootConstants 对应，每次绘制唯一的绑定
+struct DrawRootConstants
+{
+    uint32_t drawDataIndex; // DrawConstants 数组的 SRV 在全局描述符表里的下标
+    uint32_t drawIndex;     // 数组里的元素
+};
+
+Renderer::~Renderer()
+{
+    // 析构前等待 GPU 用完所有帧槽的资源
+    if (m_frameRing) {
+        m_frameRing->WaitForIdle();
+    }
+    if (m_computeTimeline) {
+        m_computeTimeline->WaitForValue(m_computeTimeline->GetLastSignaledValue());
+    }
+    // 几何池比 bundle 缓存后析构，缓存已经不在了
+    if (m_geometryPool) {
+        m_geometryPool->SetReleaseCallback(nullptr);
+    }
+    m_uploadEngine.reset();
+}
+
+void Renderer::SetFramesInFlight(UINT count)
+{
+    if (m_frameRing) {
+        throw std::logic_error("SetFramesInFlight must be called before Initialize");
+    }
+    if (count == 0 || count > MAX_FRAMES_IN_FLIGHT) {
+        throw std::invalid_argument("Frames in flight out of range");
+    }
+    m_framesInFlight = count;
+}
+
 void Renderer::Initialize(HWND hwnd)
 {
     CreateDevice();
@@ -41,14 +84,17 @@ void Renderer::Initialize(HWND hwnd)
 
 void Renderer::CreateFence()
 {
-    // 创建一个 fence
-    HRESULT hr = m_device->CreateFence(m_fenceValue, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence));
-    if (FAILED(hr)) {
-        std::cout << "Failed to create fence" << std::endl;
-        throw std::runtime_error("Failed to create fence");
-    }
-
-    m_fenceValue = 1;  // 初始化为 1
+    // 创建直接队列的 fence 时间线和帧槽环
+    m_timeline = std::make_unique<FenceTimeline>(m_device.Get(), m_commandQueue.Get());
+    m_frameRing = std::make_unique<FrameRing>(*m_timeline, m_framesInFlight);
+
+    // 计算队列有自己的时间线，两个队列的提交都经过调度器
+    m_computeTimeline = std::make_unique<FenceTimeline>(m_device.Get(), m_computeQueue.Get());
+    m_copyTimeline = std::make_unique<FenceTimeline>(m_device.Get(), m_copyQueue.Get());
+    m_queueScheduler = std::make_unique<QueueScheduler>();
+    m_queueScheduler->RegisterQueue(GpuQueue::Graphics, *m_timeline);
+    m_queueScheduler->RegisterQueue(GpuQueue::Compute, *m_computeTimeline);
+    m_queueScheduler->RegisterQueue(GpuQueue::Copy, *m_copyTimeline);
 }
 
 void Renderer::CreateDevice()
@@ -60,6 +106,14 @@ void Renderer::CreateDevice()
     if (FAILED(hr)) {
         throw std::runtime_error("Failed to create D3D12 device");
     }
+
+    // 找到设备所在的适配器，用来查询显存预算；拿不到时只做记账
+    ComPtr<IDXGIFactory4> dxgiFactory;
+    ComPtr<IDXGIAdapter3> adapter;
+    if (SUCCEEDED(CreateDXGIFactory1(IID_PPV_ARGS(&dxgiFactory)))) {
+        dxgiFactory->EnumAdapterByLuid(m_device->GetAdapterLuid(), IID_PPV_ARGS(&adapter));
+    }
+    m_memoryTracker = std::make_unique<GpuMemoryTracker>(m_device.Get(), adapter.Get());
 }
 
 void Renderer::CreateCommandQueue()
@@ -72,6 +126,20 @@ void Renderer::CreateCommandQueue()
     if (FAILED(hr)) {
         throw std::runtime_error("Failed to create command queue");
     }
+
+    // 异步计算队列，和直接队列并行执行
+    queueDesc.Type = D3D12_COMMAND_LIST_TYPE_COMPUTE;
+    hr = m_device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&m_computeQueue));
+    if (FAILED(hr)) {
+        throw std::runtime_error("Failed to create compute command queue");
+    }
+
+    // 复制队列，负责异步上传
+    queueDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+    hr = m_device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&m_copyQueue));
+    if (FAILED(hr)) {
+        throw std::runtime_error("Failed to create copy command queue");
+    }
 }
 
 void Renderer::CreateSwapChain(HWND hwnd)
@@ -104,29 +172,33 @@ void Renderer::CreateSwapChain(HWND hwnd)
 
 void Renderer::CreateDescriptorHeaps()
 {
-    // 创建 RTV 描述符堆
-    D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
-    rtvHeapDesc.NumDescriptors = m_swapChainBufferCount;  // 后台缓冲区数量
-    rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;     // 渲染目标视图类型
-    rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-
-    HRESULT hr = m_device->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&m_rtvHeap));
-    if (FAILED(hr)) {
-        throw std::runtime_error("Failed to create RTV descriptor heap");
+    // 每种描述符堆类型一个分页的 CPU 描述符分配器，只创建一次：
+    // 重新调用（交换链重建）时已经分配出去的描述符和引用分配器的视图缓存都保持有效
+    for (UINT type = 0; type < D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES; type++) {
+        if (!m_descriptorAllocators[type]) {
+            m_descriptorAllocators[type] = std::make_unique<DescriptorAllocator>(m_device.Get(), static_cast<D3D12_DESCRIPTOR_HEAP_TYPE>(type));
+        }
     }
 
-    // 为每个交换链缓冲区创建 RTV 描述符
+    // 为每个交换链缓冲区分配并创建 RTV 描述符
+    DescriptorAllocator& rtvAllocator = GetDescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
     for (UINT i = 0; i < m_swapChainBufferCount; i++) {
-        hr = m_swapChain->GetBuffer(i, IID_PPV_ARGS(&m_renderTargets[i]));
+        HRESULT hr = m_swapChain->GetBuffer(i, IID_PPV_ARGS(&m_renderTargets[i]));
         if (FAILED(hr)) {
             throw std::runtime_error("Failed to get swap chain buffer");
         }
+        m_stateTracker.Register(m_renderTargets[i].Get(), D3D12_RESOURCE_STATE_PRESENT);
 
-        // 创建渲染目标视图
-        m_device->CreateRenderTargetView(m_renderTargets[i].Get(), nullptr, m_rtvHeap->GetCPUDescriptorHandleForHeapStart());
-        // 移动到下一个描述符
-        D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = m_rtvHeap->GetCPUDescriptorHandleForHeapStart();
-        rtvHandle.ptr = rtvHandle.ptr + m_rtvDescriptorSize;
+        // 创建渲染目标视图，重新调用时沿用已经分配的描述符
+        if (!m_renderTargetViews[i].IsValid()) {
+            m_renderTargetViews[i] = rtvAllocator.Allocate();
+        }
+        m_device->CreateRenderTargetView(m_renderTargets[i].Get(), nullptr, m_renderTargetViews[i].cpuHandle);
+    }
+
+    // 绘制常量数组的 SRV 每帧指向上传环里新的位置，CPU 描述符只需要一个
+    if (!m_drawDataView.IsValid()) {
+        m_drawDataView = GetDescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV).Allocate();
     }
 }
 
@@ -178,7 +250,7 @@ void Renderer::LoadShaders()
     // 编译顶点着色器
     Microsoft::WRL::ComPtr<ID3DBlob> vertexShaderBlob;
     Microsoft::WRL::ComPtr<ID3DBlob> vertexShaderErrorBlob;
-    CompileShaderFromFile(vertexShaderPath, "main", "vs_5_0", vertexShaderBlob, vertexShaderErrorBlob);
+    CompileShaderFromFile(vertexShaderPath, "main", "vs_5_1", vertexShaderBlob, vertexShaderErrorBlob);
 
     // 编译像素着色器
     Microsoft::WRL::ComPtr<ID3DBlob> pixelShaderBlob;
@@ -194,15 +266,60 @@ void Renderer::LoadShaders()
 
 void Renderer::CreateRootSignature()
 {
-    D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
-    rootSignatureDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+    // 旧的根签名要被替换，依赖它的 bundle 作废
+    if (m_bundleCache && m_rootSignature) {
+        m_bundleCache->Invalidate(m_rootSignature.Get());
+    }
+
+    // bindless：所有 SRV 都在一个全局的无界描述符数组里（整个着色器可见堆），
+    // 每次绘制只通过根常量传下标。无界的 SRV 范围至少要资源绑定层级 2
+    D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+    if (FAILED(m_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options))) ||
+        options.ResourceBindingTier < D3D12_RESOURCE_BINDING_TIER_2) {
+        throw std::runtime_error("Bindless descriptors require resource binding tier 2");
+    }
+    D3D12_FEATURE_DATA_ROOT_SIGNATURE rootSignatureFeature = { D3D_ROOT_SIGNATURE_VERSION_1_1 };
+    if (FAILED(m_device->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &rootSignatureFeature, sizeof(rootSignatureFeature))) ||
+        rootSignatureFeature.HighestVersion < D3D_ROOT_SIGNATURE_VERSION_1_1) {
+        throw std::runtime_error("Root signature version 1.1 is not supported");
+    }
+
+    // 常驻区的描述符在引用它们的命令列表录制之后还可能写入新的槽位，所以描述符是易变的；
+    // 描述符指向的数据在命令列表执行期间不变
+    D3D12_DESCRIPTOR_RANGE1 bindlessRange = {};
+    bindlessRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+    bindlessRange.NumDescriptors = UINT_MAX; // 无界
+    bindlessRange.BaseShaderRegister = 0;
+    bindlessRange.RegisterSpace = 1;
+    bindlessRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE | D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE;
+    bindlessRange.OffsetInDescriptorsFromTableStart = 0;
+
+    D3D12_ROOT_PARAMETER1 rootParameters[ROOT_PARAMETER_COUNT] = {};
+    rootParameters[ROOT_DRAW_CONSTANTS].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    rootParameters[ROOT_DRAW_CONSTANTS].Constants.ShaderRegister = 0;
+    rootParameters[ROOT_DRAW_CONSTANTS].Constants.RegisterSpace = 0;
+    rootParameters[ROOT_DRAW_CONSTANTS].Constants.Num32BitValues = sizeof(DrawRootConstants) / sizeof(uint32_t);
+    rootParameters[ROOT_DRAW_CONSTANTS].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+    rootParameters[ROOT_BINDLESS_TABLE].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+    rootParameters[ROOT_BINDLESS_TABLE].DescriptorTable.NumDescriptorRanges = 1;
+    rootParameters[ROOT_BINDLESS_TABLE].DescriptorTable.pDescriptorRanges = &bindlessRange;
+    rootParameters[ROOT_BINDLESS_TABLE].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+    D3D12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc = {};
+    rootSignatureDesc.Version = D3D_ROOT_SIGNATURE_VERSION_1_1;
+    rootSignatureDesc.Desc_1_1.NumParameters = ROOT_PARAMETER_COUNT;
+    rootSignatureDesc.Desc_1_1.pParameters = rootParameters;
+    rootSignatureDesc.Desc_1_1.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
 
     // 创建根签名
     ComPtr<ID3DBlob> signature;
     ComPtr<ID3DBlob> error;
 
-    HRESULT hr = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, &error);
+    HRESULT hr = D3D12SerializeVersionedRootSignature(&rootSignatureDesc, &signature, &error);
     if (FAILED(hr)) {
+        if (error) {
+            OutputDebugStringA((char*)error->GetBufferPointer());
+        }
         std::cout << "Failed to serialize root signature" << std::endl;
         throw std::runtime_error("Failed to serialize root signature");
     }
@@ -236,139 +353,202 @@ void Renderer::CreatePipelineState()
     psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
     psoDesc.SampleDesc.Count = 1;
 
-    HRESULT hr = m_device->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&m_pipelineState));
-    if (FAILED(hr)) {
+    // 相同的描述从缓存里直接拿到同一个 PSO
+    if (!m_pipelineCache) {
+        m_pipelineCreator = std::make_unique<DevicePipelineStateCreator>(m_device.Get());
+        m_pipelineCache = std::make_unique<PipelineStateCache>(*m_pipelineCreator);
+    }
+    ID3D12PipelineState* pipelineState = nullptr;
+    try {
+        pipelineState = m_pipelineCache->GetOrCreate(psoDesc);
+    } catch (const std::exception&) {
         std::cout << "Failed to create pipeline state" << std::endl;
-        throw std::runtime_error("Failed to create pipeline state");
+        throw;
     }
+
+    // 换成了另一个 PSO：依赖旧 PSO 的 bundle 作废
+    if (m_bundleCache && m_pipelineState && m_pipelineState.Get() != pipelineState) {
+        m_bundleCache->Invalidate(m_pipelineState.Get());
+    }
+    m_pipelineState = pipelineState;
+}
+
+PipelineStateCache::Stats Renderer::GetPipelineStateCacheStats() const
+{
+    return m_pipelineCache->GetStats();
 }
 
 
 void Renderer::CreateVertexBuffer()
 {
-    // 重置命令列表
-    HRESULT hr = m_commandList->Reset(m_commandAllocator.Get(), nullptr);
-    if (FAILED(hr)) {
-        throw std::runtime_error("Failed to reset command list in CreateVertexBuffer");
+    // 旧的三角形网格把区间还给几何池（GPU 用完之后才真正回收）
+    if (m_triangleMesh.IsValid()) {
+        m_geometryPool->RemoveMesh(m_triangleMesh);
     }
 
-    // 创建顶点缓冲区
-    const UINT vertexBufferSize = sizeof(triangleVertices);
+    // 顶点和索引放进几何池，在复制队列上异步上传，不等待 GPU；图形队列第一次绘制时才等复制队列
+    m_triangleMesh = m_geometryPool->AddMesh(triangleVertices, _countof(triangleVertices), triangleIndices, _countof(triangleIndices));
+    m_uploadEngine->Flush();
+}
 
-    // 创建 GPU 顶点缓冲区 (默认堆)
-    hr = m_device->CreateCommittedResource(
-        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-        D3D12_HEAP_FLAG_NONE,
-        &CD3DX12_RESOURCE_DESC::Buffer(vertexBufferSize),
-        D3D12_RESOURCE_STATE_COPY_DEST,
-        nullptr,
-        IID_PPV_ARGS(&m_vertexBuffer)
-    );
+void Renderer::WaitForGpu()
+{
+    // 向命令队列发送信号并等待完成
+    m_timeline->WaitForValue(m_timeline->Signal());
+}
 
-    if (FAILED(hr)) {
-        throw std::runtime_error("Failed to create vertex buffer");
-    }
-
-    // 创建上传缓冲区
-    ComPtr<ID3D12Resource> vertexBufferUpload;
-    hr = m_device->CreateCommittedResource(
-        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-        D3D12_HEAP_FLAG_NONE,
-        &CD3DX12_RESOURCE_DESC::Buffer(vertexBufferSize),
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&vertexBufferUpload)
-    );
+void Renderer::CreateCommandList()
+{
+    // 命令分配器和命令列表都从池中按需取出，提交后按 fence 值回收
+    m_commandListPool = std::make_unique<CommandListPool>(m_device.Get());
+
+    // 默认堆上的资源放在大块堆里，由 TLSF 分配
+    m_heapManager = std::make_unique<HeapManager>(m_device.Get(), *m_memoryTracker);
+    m_commandListPool->SetTimeline(D3D12_COMMAND_LIST_TYPE_DIRECT, m_timeline.get());
+    m_commandListPool->SetTimeline(D3D12_COMMAND_LIST_TYPE_COMPUTE, m_computeTimeline.get());
+    m_commandListPool->SetTimeline(D3D12_COMMAND_LIST_TYPE_COPY, m_copyTimeline.get());
+    m_deferredRelease = std::make_unique<DeferredReleaseQueue>();
+    m_uploadEngine = std::make_unique<UploadEngine>(m_device.Get(), *m_memoryTracker, *m_commandListPool, *m_queueScheduler, *m_deferredRelease);
+
+    // 静态网格共用一个顶点缓冲区和一个索引缓冲区
+    m_geometryPool = std::make_unique<GeometryPool>(*m_heapManager, *m_uploadEngine, *m_deferredRelease, *m_timeline,
+        static_cast<uint32_t>(sizeof(Vertex)), GEOMETRY_POOL_MAX_VERTICES, GEOMETRY_POOL_MAX_INDICES);
+
+    // 每帧的动态数据（常量、动态顶点）从按帧槽分区的上传环里分配
+    m_uploadRing = std::make_unique<UploadRing>(*m_memoryTracker, *m_timeline, UPLOAD_RING_BYTES_PER_FRAME, m_framesInFlight);
+
+    // 唯一的着色器可见堆：常驻区放长期存在的视图，其余按 fence 回收，整个堆是 bindless 的全局表
+    m_dynamicDescriptors = std::make_unique<DynamicDescriptorHeap>(m_device.Get(), *m_timeline,
+        PERSISTENT_DESCRIPTOR_CAPACITY, DYNAMIC_DESCRIPTOR_CAPACITY);
+    m_viewCache = std::make_unique<DescriptorViewCache>(m_device.Get(),
+        GetDescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV), *m_dynamicDescriptors);
+
+    // 每帧的 CPU 临时数据同样按帧槽分区
+    m_frameArena = std::make_unique<FrameArena>(FRAME_ARENA_BYTES_PER_FRAME, m_framesInFlight);
+
+    // 绘制在工作线程上并行录制，整帧的命令列表在 Present 前一次提交
+    m_workerPool = std::make_unique<WorkerPool>();
+    m_parallelRecorder = std::make_unique<ParallelCommandRecorder>(*m_commandListPool, *m_workerPool);
+    m_submitBatcher = std::make_unique<FrameSubmitBatcher>(*m_queueScheduler, GpuQueue::Graphics);
+
+    // 静态绘制序列录制成 bundle 后复用
+    m_bundleCache = std::make_unique<BundleCache>(m_device.Get(), *m_timeline);
+    m_geometryPool->SetReleaseCallback([this](ID3D12Resource* buffer) { m_bundleCache->Invalidate(buffer); });
+    m_transientHeap = std::make_unique<TransientResourceHeap>(m_device.Get(), *m_memoryTracker, *m_timeline, m_stateTracker, *m_deferredRelease);
+}
 
-    if (FAILED(hr)) {
-        throw std::runtime_error("Failed to create upload buffer");
-    }
+const FrameSubmitBatcher::Stats& Renderer::GetLastFrameSubmitStats() const
+{
+    return m_submitBatcher->GetLastFrameStats();
+}
 
-    // 复制顶点数据到上传缓冲区
-    void* pData;
-    vertexBufferUpload->Map(0, nullptr, &pData);
-    memcpy(pData, triangleVertices, sizeof(triangleVertices));
-    vertexBufferUpload->Unmap(0, nullptr);
+const StateFilteredCommandList::Stats& Renderer::GetLastFrameStateFilterStats() const
+{
+    return m_lastFrameStateStats;
+}
 
-    // 将数据从上传缓冲区复制到 GPU 顶点缓冲区
-    m_commandList->CopyBufferRegion(m_vertexBuffer.Get(), 0, vertexBufferUpload.Get(), 0, vertexBufferSize);
+GpuSyncPoint Renderer::SubmitAsyncCompute(const std::function<void(ID3D12GraphicsCommandList*)>& record)
+{
+    CommandContext context = m_commandListPool->Acquire(D3D12_COMMAND_LIST_TYPE_COMPUTE);
+    record(context.list.Get());
+    context.list->Close();
+
+    // 立即提交到计算队列，和图形队列上的帧并行执行
+    ID3D12CommandList* lists[] = { context.list.Get() };
+    GpuSyncPoint point = m_queueScheduler->Submit(GpuQueue::Compute, lists, _countof(lists));
+    m_commandListPool->Release(context, point.value);
+    return point;
+}
 
-    // 切换顶点缓冲区资源状态
-    auto resourceBarrier = CD3DX12_RESOURCE_BARRIER::Transition(
-        m_vertexBuffer.Get(),
-        D3D12_RESOURCE_STATE_COPY_DEST,
-        D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER
-    );
-    m_commandList->ResourceBarrier(1, &resourceBarrier);
+void Renderer::AddGraphicsDependency(const GpuSyncPoint& point)
+{
+    m_queueScheduler->AddDependency(GpuQueue::Graphics, point);
+}
 
-    // 关闭命令列表
-    hr = m_commandList->Close();
-    if (FAILED(hr)) {
-        std::cout << "Failed to close command list" << std::endl;
-        throw std::runtime_error("Failed to close command list in CreateVertexBuffer");
-    }
+QueueScheduler::QueueStats Renderer::GetQueueStats(GpuQueue queue) const
+{
+    return m_queueScheduler->GetStats(queue);
+}
 
-    // 执行命令列表
-    ID3D12CommandList* ppCommandLists[] = { m_commandList.Get() };
-    m_commandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+const FrameArena::Stats& Renderer::GetFrameArenaStats() const
+{
+    return m_frameArena->GetStats();
+}
 
-    // 等待 GPU 完成
-    WaitForGpu();
+const TransientResourceHeap::Stats& Renderer::GetTransientHeapStats() const
+{
+    return m_transientHeap->GetStats();
 }
 
-void Renderer::WaitForGpu()
+GpuMemoryTracker::CategoryStats Renderer::GetGpuMemoryStats(GpuMemoryCategory category) const
 {
-    // 向命令队列发送信号
-    m_commandQueue->Signal(m_fence.Get(), m_fenceValue);
+    return m_memoryTracker->GetStats(category);
+}
 
-    // 检查当前完成的值
-    if (m_fence->GetCompletedValue() < m_fenceValue) {
-        HANDLE eventHandle = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-        m_fence->SetEventOnCompletion(m_fenceValue, eventHandle);
-        WaitForSingleObject(eventHandle, INFINITE);
-        CloseHandle(eventHandle);
-    }
+GpuMemoryBudget Renderer::QueryGpuMemoryBudget() const
+{
+    return m_memoryTracker->QueryBudget();
+}
 
-    m_fenceValue++;
+DescriptorAllocator& Renderer::GetDescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE type)
+{
+    return *m_descriptorAllocators[type];
 }
 
-void Renderer::CreateCommandList()
+DynamicDescriptorHeap::Stats Renderer::GetDynamicDescriptorStats() const
 {
+    return m_dynamicDescriptors->GetStats();
+}
 
-    hr = m_device->CreateCommandAllocator(
-        D3D12_COMMAND_LIST_TYPE_DIRECT, 
-        IID_PPV_ARGS(&m_commandAllocator)
-    );
-    if (FAILED(hr)) {
-        throw std::runtime_error("Failed to create command allocator");
-    }
+uint32_t Renderer::RegisterBindlessDescriptor(D3D12_CPU_DESCRIPTOR_HANDLE source)
+{
+    return m_dynamicDescriptors->AllocatePersistent(source);
+}
 
-    // 创建命令列表
-    HRESULT hr = m_device->CreateCommandList(
-        0, D3D12_COMMAND_LIST_TYPE_DIRECT, m_commandAllocator.Get(),
-        m_pipelineState.Get(), IID_PPV_ARGS(&m_commandList)
-    );
-    if (FAILED(hr)) {
-        throw std::runtime_error("Failed to create command list");
-    }
-    m_commandList->Close();
+void Renderer::ReleaseBindlessDescriptor(uint32_t index)
+{
+    m_dynamicDescriptors->FreePersistent(index);
 }
 
+DescriptorViewCache& Renderer::GetDescriptorViewCache()
+{
+    return *m_viewCache;
+}
 
-void Renderer::ExecuteCommandList()
+DescriptorViewCache::Stats Renderer::GetDescriptorViewCacheStats() const
 {
-    // Ensure the command allocator is reset before resetting the command list.
-    try {
-        m_commandAllocator->Reset();
-        m_commandList->Reset(m_commandAllocator.Get(), m_pipelineState.Get());
-    } catch (const std::exception& e) {
-        std::cout << "Error during command list reset: " << e.what() << std::endl;
-        return;
+    return m_viewCache->GetStats();
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE Renderer::GetCurrentRtv() const
+{
+    return m_renderTargetViews[m_backBufferIndex].cpuHandle;
+}
+
+void Renderer::RecordFrameTargets(CommandStream& stream) const
+{
+    // 获取渲染目标视图（RTV）
+    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = GetCurrentRtv();
+
+    // 获取深度目标视图（DSV） - 如果你有深度缓冲区
+    D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle = {};
+    if (m_dsvHeap) {
+        dsvHandle = m_dsvHeap->GetCPUDescriptorHandleForHeapStart();
     }
 
-    // Set root signature
-    m_commandList->SetGraphicsRootSignature(m_rootSignature.Get());
+    // 设置渲染目标视图（RTV）和深度目标视图（DSV）
+    stream.SetRenderTarget(D3D12CommandBackend::ToHandle(rtvHandle), m_dsvHeap ? D3D12CommandBackend::ToHandle(dsvHandle) : 0);
+
+    // 设置视口
+    stream.SetViewport(0.0f, 0.0f, static_cast<float>(m_width), static_cast<float>(m_height), 0.0f, 1.0f);
+
+    // 设置裁剪矩形
+    stream.SetScissor(0, 0, static_cast<int32_t>(m_width), static_cast<int32_t>(m_height));
+}
+
 
+void Renderer::ExecuteCommandList()
+{
     // Define the vertex data for the triangle
     Vertex vertices[] = {
         {{0.0f, 0.5f, 0.0f}, {1.0f, 0.0f, 0.0f, 1.0f}},  // Vertex 1
@@ -379,128 +559,238 @@ void Renderer::ExecuteCommandList()
     // Calculate the size of the vertex buffer
     UINT vertexBufferSize = sizeof(vertices);
 
-    // Check if the vertex buffer already exists, if not, create it
-    if (!m_vertexBuffer) {
-        D3D12_HEAP_PROPERTIES heapProps = {};
-        heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;  // Use an upload heap for CPU access
-
-        D3D12_RESOURCE_DESC bufferDesc = {};
-        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-        bufferDesc.Width = vertexBufferSize;
-        bufferDesc.Height = 1;
-        bufferDesc.DepthOrArraySize = 1;
-        bufferDesc.MipLevels = 1;
-        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
-        bufferDesc.SampleDesc.Count = 1;
-        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-
-        HRESULT hr = m_device->CreateCommittedResource(
-            &heapProps,
-            D3D12_HEAP_FLAG_NONE,
-            &bufferDesc,
-            D3D12_RESOURCE_STATE_GENERIC_READ,
-            nullptr,
-            IID_PPV_ARGS(&m_vertexBuffer)
-        );
-        if (FAILED(hr)) {
-            throw std::runtime_error("Failed to create vertex buffer");
-        }
-        // Copy the vertex data to the buffer
-        void* pData;
-        m_vertexBuffer->Map(0, nullptr, &pData);
-        memcpy(pData, vertices, vertexBufferSize);
-        m_vertexBuffer->Unmap(0, nullptr);
-    }
-
     // Create the vertex buffer view
     D3D12_VERTEX_BUFFER_VIEW vertexBufferView = {};
-    vertexBufferView.BufferLocation = m_vertexBuffer->GetGPUVirtualAddress();
     vertexBufferView.SizeInBytes = vertexBufferSize;
     vertexBufferView.StrideInBytes = sizeof(Vertex);
 
-    // Set the primitive topology
-    m_commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    // Without a mesh in the geometry pool the vertices are dynamic data: one pointer bump in
+    // this frame's partition of the upload ring, no resource creation and no Map/Unmap
+    ID3D12GraphicsCommandList* triangleBundle = nullptr;
+    if (!m_triangleMesh.IsValid()) {
+        vertexBufferView.BufferLocation = m_uploadRing->AllocateAndCopy(vertices, vertexBufferSize).gpuAddress;
+    } else {
+        // The triangle is a static sequence: record it once into a bundle and replay it every frame.
+        // The bundle inherits the geometry pool's buffers from the calling list and only carries the draw
+        m_bundleCache->BeginFrame();
+        m_triangleStream.Reset();
+        m_triangleStream.SetRootSignature(D3D12CommandBackend::ToHandle(m_rootSignature.Get()));
+        m_triangleStream.SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        m_triangleStream.DrawIndexed(m_triangleMesh.indexCount, 1, m_triangleMesh.startIndex, static_cast<int32_t>(m_triangleMesh.baseVertex));
+        triangleBundle = m_bundleCache->GetOrRecord(
+            m_triangleStream, m_pipelineState.Get(), { m_rootSignature.Get(), m_geometryPool->GetVertexBuffer(), m_geometryPool->GetIndexBuffer() });
+    }
 
-    // Bind the vertex buffer and issue the draw call
-    m_commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
-    m_commandList->DrawInstanced(3, 1, 0, 0);
+    // Record the draws in parallel chunks; each chunk's list carries its own state.
+    // Commands go into the chunk's command stream first and are then translated to the list.
+    const size_t drawCount = 1;
 
-    // Close the command list
-    try {
-        m_commandList->Close();
-    } catch (const std::exception& e) {
-        std::cout << "Error closing command list: " << e.what() << std::endl;
+    // Every draw's constants go into one array in the upload ring. Its SRV is copied into this frame's
+    // part of the shader-visible heap once, and each draw only passes its indices as root constants
+    UploadAllocation drawData = m_uploadRing->Allocate(drawCount * sizeof(DrawConstants), sizeof(DrawConstants));
+    DrawConstants* drawConstants = static_cast<DrawConstants*>(drawData.cpuAddress);
+    for (size_t i = 0; i < drawCount; i++) {
+        drawConstants[i].offset = XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
     }
 
-    // Execute the command list
-    ID3D12CommandList* ppCommandLists[] = { m_commandList.Get() };
-    m_commandQueue->ExecuteCommandLists(ARRAYSIZE(ppCommandLists), ppCommandLists);
+    D3D12_SHADER_RESOURCE_VIEW_DESC drawDataView = {};
+    drawDataView.Format = DXGI_FORMAT_UNKNOWN;
+    drawDataView.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
+    drawDataView.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    drawDataView.Buffer.FirstElement = drawData.offset / sizeof(DrawConstants);
+    drawDataView.Buffer.NumElements = static_cast<UINT>(drawCount);
+    drawDataView.Buffer.StructureByteStride = sizeof(DrawConstants);
+    m_device->CreateShaderResourceView(drawData.resource, &drawDataView, m_drawDataView.cpuHandle);
+    const uint32_t drawDataIndex = m_dynamicDescriptors->AllocateTable(&m_drawDataView.cpuHandle, 1);
+    const size_t minDrawsPerChunk = 256;
+    const size_t chunkCount = m_parallelRecorder->GetChunkCount(drawCount, minDrawsPerChunk);
+    if (m_chunkStreams.size() < chunkCount) {
+        m_chunkStreams.resize(chunkCount);
+        m_chunkStateStats.resize(chunkCount);
+    }
+
+    FrameVector<CommandContext> drawContexts = m_parallelRecorder->Record(
+        drawCount, minDrawsPerChunk, m_pipelineState.Get(),
+        [&](ID3D12GraphicsCommandList* commandList, size_t chunk, size_t first, size_t count) {
+            CommandStream& stream = m_chunkStreams[chunk];
+            stream.Reset();
+            RecordFrameTargets(stream);
+
+            // Set root signature (a bundle's root signature must match the calling list's)
+            stream.SetRootSignature(D3D12CommandBackend::ToHandle(m_rootSignature.Get()));
+
+            // The one shader-visible heap and the global bindless table are bound once at the top of
+            // every list and never switched. The bundles inherit both, as they use the same root signature
+            stream.SetDescriptorHeaps(D3D12CommandBackend::ToHandle(m_dynamicDescriptors->GetHeap()));
+            stream.SetRootDescriptorTable(ROOT_BINDLESS_TABLE, D3D12CommandBackend::ToHandle(m_dynamicDescriptors->GetGlobalTable()));
+
+            // Static meshes all live in the geometry pool, bound once per list
+            if (triangleBundle) {
+                m_geometryPool->Bind(stream);
+            }
+
+            // Dynamic vertices change address every frame, so they are drawn directly instead of through a bundle
+            if (!triangleBundle) {
+                stream.SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+                stream.SetVertexBuffer(0, vertexBufferView.BufferLocation, vertexBufferView.SizeInBytes, vertexBufferView.StrideInBytes);
+                for (size_t i = 0; i < count; i++) {
+                    const DrawRootConstants rootConstants = { drawDataIndex, static_cast<uint32_t>(first + i) };
+                    stream.SetRootConstants(ROOT_DRAW_CONSTANTS, sizeof(rootConstants) / sizeof(uint32_t), &rootConstants);
+                    stream.Draw(3, 1, 0, 0);
+                }
+            }
+
+            D3D12CommandBackend backend(commandList);
+            ReplayCommandStream(stream, backend);
+            m_chunkStateStats[chunk] = backend.GetStateStats();
+
+            // Replay the cached triangle bundle for each draw; the draw's indices are the only per-draw binding
+            for (size_t i = 0; triangleBundle && i < count; i++) {
+                const DrawRootConstants rootConstants = { drawDataIndex, static_cast<uint32_t>(first + i) };
+                commandList->SetGraphicsRoot32BitConstants(ROOT_DRAW_CONSTANTS, sizeof(rootConstants) / sizeof(uint32_t), &rootConstants, 0);
+                commandList->ExecuteBundle(triangleBundle);
+            }
+
+            // The last chunk closes the frame: the back buffer's transition to PRESENT goes at its end
+            // instead of into a list of its own. Only this chunk touches the state tracker while recording
+            if (first + count == drawCount) {
+                RecordPresentBarriers(commandList);
+            }
+        },
+        m_frameArena.get());
+
+    for (size_t chunk = 0; chunk < drawContexts.size(); chunk++) {
+        m_frameStateStats += m_chunkStateStats[chunk];
+    }
+
+    // The lists are submitted together with the rest of the frame
+    m_submitBatcher->Add(std::move(drawContexts));
 }
 
-void Renderer::Render()
+void Renderer::RecordClearPass()
 {
-    // 获取当前后台缓冲区索引
-    UINT backBufferIndex = m_swapChain->GetCurrentBackBufferIndex();
+    CommandContext clearContext = m_commandListPool->Acquire(D3D12_COMMAND_LIST_TYPE_DIRECT, m_pipelineState.Get());
+    m_commandList = clearContext.list;
+    m_frameStream.Reset();
 
-    // 设置资源屏障，将后台缓冲区从 PRESENT 转换为 RENDER_TARGET
-    CD3DX12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(
-        m_renderTargets[backBufferIndex].Get(),
-        D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
-    m_commandList->ResourceBarrier(1, &barrier);
+    // 渲染图声明的状态转换（后台缓冲区进入 RENDER_TARGET）。列表还要继续录制，
+    // 这里开始的拆分屏障留到关闭前再结束
+    m_stateTracker.Flush(m_commandList.Get());
 
-    // 获取渲染目标视图（RTV）
-    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = m_rtvHeap->GetCPUDescriptorHandleForHeapStart();
-    rtvHandle.ptr = rtvHandle.ptr + backBufferIndex * m_rtvDescriptorSize;
+    RecordFrameTargets(m_frameStream);
 
-    // 获取深度目标视图（DSV） - 如果你有深度缓冲区
-    D3D12_CPU_DESCRIPTOR_HANDLE dsvHandle = {};
+    // 清除渲染目标视图
+    const FLOAT clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f }; // 深蓝色
+    m_frameStream.ClearRenderTarget(D3D12CommandBackend::ToHandle(GetCurrentRtv()), clearColor);
+
+    D3D12CommandBackend clearBackend(m_commandList.Get());
+    ReplayCommandStream(m_frameStream, clearBackend);
+    m_frameStateStats += clearBackend.GetStateStats();
+
+    // 清除深度目标视图
     if (m_dsvHeap) {
-        dsvHandle = m_dsvHeap->GetCPUDescriptorHandleForHeapStart();
+        m_commandList->ClearDepthStencilView(m_dsvHeap->GetCPUDescriptorHandleForHeapStart(), D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
     }
+    m_stateTracker.Flush(m_commandList.Get(), true);
+    m_commandList->Close();
+    m_submitBatcher->Add(std::move(clearContext));
+}
 
-    // 设置渲染目标视图（RTV）和深度目标视图（DSV）
-    m_commandList->OMSetRenderTargets(1, &rtvHandle, FALSE, m_dsvHeap ? &dsvHandle : nullptr);
+void Renderer::FlushPendingBarriers()
+{
+    if (!m_stateTracker.HasPendingBarriers()) {
+        return;
+    }
 
-    // 设置视口
-    D3D12_VIEWPORT viewport = {};
-    viewport.TopLeftX = 0.0f;
-    viewport.TopLeftY = 0.0f;
-    viewport.Width = static_cast<float>(m_width);
-    viewport.Height = static_cast<float>(m_height);
-    viewport.MinDepth = 0.0f;
-    viewport.MaxDepth = 1.0f;
-    m_commandList->RSSetViewports(1, &viewport);
+    // 单独用一个只有屏障的命令列表，按顺序排在这一帧的提交里
+    CommandContext barrierContext = m_commandListPool->Acquire(D3D12_COMMAND_LIST_TYPE_DIRECT);
+    m_stateTracker.Flush(barrierContext.list.Get(), true);
+    barrierContext.list->Close();
+    m_submitBatcher->Add(std::move(barrierContext));
+}
 
-    // 设置裁剪矩形
-    D3D12_RECT scissorRect = {};
-    scissorRect.left = 0;
-    scissorRect.top = 0;
-    scissorRect.right = m_width;
-    scissorRect.bottom = m_height;
-    m_commandList->RSSetScissorRects(1, &scissorRect);
-
-    // 清除渲染目标视图和深度目标视图
-    const FLOAT clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f }; // 深蓝色
-    m_commandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
-    if (m_dsvHeap) {
-        m_commandList->ClearDepthStencilView(dsvHandle, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+void Renderer::RecordPresentBarriers(ID3D12GraphicsCommandList* commandList)
+{
+    // 提前满足 Present Pass 的要求；轮到它执行时状态已经对了，不会再单独用一个命令列表
+    size_t count = 0;
+    const FrameGraph::Transition* transitions = m_frameGraph.GetPassTransitions(m_presentPass, count);
+    for (size_t i = 0; i < count; i++) {
+        ID3D12Resource* resource = reinterpret_cast<ID3D12Resource*>(m_frameGraph.GetPhysical(transitions[i].resource));
+        m_stateTracker.Require(resource, static_cast<D3D12_RESOURCE_STATES>(transitions[i].after));
     }
+    m_stateTracker.Flush(commandList, true);
+}
 
+void Renderer::Render()
+{
+    // 等待当前帧槽空闲（只有 GPU 还在使用这个帧槽时才会阻塞）
+    m_frameRing->BeginFrame();
+    m_uploadRing->BeginFrame();
+    m_dynamicDescriptors->BeginFrame();
+    m_frameArena->BeginFrame();
 
-    // Execute the command list (draw the triangle)
-    ExecuteCommandList();
+    // 释放 GPU 已经用完的延迟释放对象，逐出已经销毁的资源的缓存视图
+    m_deferredRelease->Collect();
+    m_viewCache->CollectReleased();
 
-    // 设置资源屏障，将后台缓冲区从 RENDER_TARGET 转换为 PRESENT
-    barrier = CD3DX12_RESOURCE_BARRIER::Transition(
-        m_renderTargets[backBufferIndex].Get(),
-        D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
-    m_commandList->ResourceBarrier(1, &barrier);
+    // 获取当前后台缓冲区索引
+    m_backBufferIndex = m_swapChain->GetCurrentBackBufferIndex();
+
+    ID3D12Resource* backBuffer = m_renderTargets[m_backBufferIndex].Get();
+
+    // 每帧重建渲染图：清屏、三角形、呈现三个 Pass，后台缓冲区作为导入资源
+    m_frameGraph.Reset();
+    m_transientHeap->BeginFrame();
+    const FrameGraphResource backBufferHandle = m_frameGraph.Import(
+        "BackBuffer", m_stateTracker.GetState(backBuffer), reinterpret_cast<uint64_t>(backBuffer));
+
+    m_frameGraph.AddPass("Clear",
+        [&](FrameGraph::PassBuilder& builder) {
+            builder.Write(backBufferHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
+        },
+        [this]() { RecordClearPass(); });
+
+    m_frameGraph.AddPass("Triangle",
+        [&](FrameGraph::PassBuilder& builder) {
+            builder.Write(backBufferHandle, D3D12_RESOURCE_STATE_RENDER_TARGET);
+        },
+        [this]() {
+            // 几何池还有没完成的上传时，这一帧的图形提交先等复制队列
+            m_geometryPool->PrepareForDraw(GpuQueue::Graphics);
+            FlushPendingBarriers();
+            ExecuteCommandList();
+        });
+
+    // 转换通常已经由三角形 Pass 的最后一个命令列表发出；没有录制绘制时才单独用一个列表
+    m_presentPass = m_frameGraph.AddPass("Present",
+        [&](FrameGraph::PassBuilder& builder) {
+            builder.Write(backBufferHandle, D3D12_RESOURCE_STATE_PRESENT);
+            builder.SetSideEffect();
+        },
+        [this]() { FlushPendingBarriers(); });
+
+    m_frameGraph.Compile();
+    m_transientHeap->Realize(m_frameGraph);
+
+    // Pass 之间的状态转换交给状态跟踪器，由 Pass 在自己的命令列表开头发出
+    m_frameGraph.Execute([this](uint32_t, const FrameGraph::Transition* transitions, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            ID3D12Resource* resource = reinterpret_cast<ID3D12Resource*>(m_frameGraph.GetPhysical(transitions[i].resource));
+            if (transitions[i].before == FrameGraph::STATE_UNDEFINED) {
+                m_transientHeap->Activate(m_frameGraph, transitions[i].resource);
+            }
+            // 中间隔着别的 Pass 时图会把转换拆开：Begin 提前开始，End 由之后的 Require 结束
+            if (transitions[i].split == FrameGraph::Split::Begin) {
+                m_stateTracker.BeginTransition(resource, static_cast<D3D12_RESOURCE_STATES>(transitions[i].after));
+            } else {
+                m_stateTracker.Require(resource, static_cast<D3D12_RESOURCE_STATES>(transitions[i].after));
+            }
+        }
+    });
+    m_commandList = nullptr;
 
-    // 关闭命令列表并提交
-    m_commandList->Close();
-    ID3D12CommandList* ppCommandLists[] = { m_commandList.Get() };
-    m_commandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+    // 整帧的命令列表按顺序一次提交
+    m_submitBatcher->Flush();
 
     // 呈现交换链
     try {
@@ -509,11 +799,12 @@ void Renderer::Render()
         std::cout << "Error during swap chain present: " << e.what() << std::endl;
     }
 
-    // 重置命令分配器和命令列表，为下一帧准备
-    try {
-        m_commandAllocator->Reset();
-        m_commandList->Reset(m_commandAllocator.Get(), m_pipelineState.Get());
-    } catch (const std::exception& e) {
-        std::cout << "Error during command allocator reset: " << e.what() << std::endl;
-    }
+    // 在当前帧槽上记录 fence 值，不等待 GPU，直接进入下一帧
+    uint64_t frameFenceValue = m_frameRing->EndFrame();
+    m_uploadRing->EndFrame(frameFenceValue);
+    m_dynamicDescriptors->EndFrame(frameFenceValue);
+    m_submitBatcher->EndFrame(*m_commandListPool, frameFenceValue);
+
+    m_lastFrameStateStats = m_frameStateStats;
+    m_frameStateStats = StateFilteredCommandList::Stats();
 }
@@ -0,0 +1,292 @@
+// ResourceStateTracker.cpp
+#include "ResourceStateTracker.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+const D3D12_RESOURCE_STATES READ_ONLY_STATES =
+    D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER | D3D12_RESOURCE_STATE_INDEX_BUFFER |
+    D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE |
+    D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT | D3D12_RESOURCE_STATE_COPY_SOURCE |
+    D3D12_RESOURCE_STATE_DEPTH_READ;
+}
+
+bool ResourceStateTracker::IsReadOnlyState(D3D12_RESOURCE_STATES state)
+{
+    return state != D3D12_RESOURCE_STATE_COMMON && (state & ~READ_ONLY_STATES) == 0;
+}
+
+bool ResourceStateTracker::Satisfies(D3D12_RESOURCE_STATES current, D3D12_RESOURCE_STATES required)
+{
+    // 相同状态，或者要求的只读状态已经包含在当前的只读组合里
+    if (current == required) {
+        return true;
+    }
+    return IsReadOnlyState(required) && IsReadOnlyState(current) && (current & required) == required;
+}
+
+void ResourceStateTracker::Register(ID3D12Resource* resource, D3D12_RESOURCE_STATES initialState, UINT subresourceCount)
+{
+    TrackedResource tracked;
+    tracked.state = initialState;
+    tracked.subresourceCount = subresourceCount == 0 ? 1 : subresourceCount;
+    m_resources[resource] = tracked;
+}
+
+void ResourceStateTracker::Unregister(ID3D12Resource* resource)
+{
+    m_resources.erase(resource);
+
+    // 丢掉还没发出的屏障，避免引用已经释放的资源
+    for (size_t i = 0; i < m_pending.size();) {
+        const D3D12_RESOURCE_BARRIER& barrier = m_pending[i];
+        const bool transition = barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION && barrier.Transition.pResource == resource;
+        const bool aliasing = barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_ALIASING &&
+            (barrier.Aliasing.pResourceBefore == resource || barrier.Aliasing.pResourceAfter == resource);
+        if (transition || aliasing) {
+            m_pending.erase(m_pending.begin() + i);
+        } else {
+            i++;
+        }
+    }
+    for (size_t i = 0; i < m_splits.size();) {
+        if (m_splits[i].resource == resource) {
+            m_splits.erase(m_splits.begin() + i);
+        } else {
+            i++;
+        }
+    }
+}
+
+void ResourceStateTracker::Alias(ID3D12Resource* before, ID3D12Resource* after)
+{
+    D3D12_RESOURCE_BARRIER barrier = {};
+    barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+    barrier.Aliasing.pResourceBefore = before;
+    barrier.Aliasing.pResourceAfter = after;
+    m_pending.push_back(barrier);
+    m_stats.aliasingBarriers++;
+}
+
+ResourceStateTracker::TrackedResource& ResourceStateTracker::GetTracked(ID3D12Resource* resource)
+{
+    auto it = m_resources.find(resource);
+    if (it == m_resources.end()) {
+        throw std::invalid_argument("Resource is not registered with the state tracker");
+    }
+    return it->second;
+}
+
+D3D12_RESOURCE_STATES ResourceStateTracker::GetState(ID3D12Resource* resource, UINT subresource) const
+{
+    auto it = m_resources.find(resource);
+    if (it == m_resources.end()) {
+        throw std::invalid_argument("Resource is not registered with the state tracker");
+    }
+    const TrackedResource& tracked = it->second;
+    if (tracked.subresourceStates.empty() || subresource >= tracked.subresourceStates.size()) {
+        return tracked.state;
+    }
+    return tracked.subresourceStates[subresource];
+}
+
+void ResourceStateTracker::AddTransition(
+    ID3D12Resource* resource, UINT subresource,
+    D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after,
+    D3D12_RESOURCE_BARRIER_FLAGS flags)
+{
+    // 和同一刷新点内还没发出的完整转换合并
+    if (flags == D3D12_RESOURCE_BARRIER_FLAG_NONE) {
+        for (size_t i = 0; i < m_pending.size(); i++) {
+            D3D12_RESOURCE_BARRIER& pending = m_pending[i];
+            if (pending.Type != D3D12_RESOURCE_BARRIER_TYPE_TRANSITION ||
+                pending.Flags != D3D12_RESOURCE_BARRIER_FLAG_NONE ||
+                pending.Transition.pResource != resource ||
+                pending.Transition.Subresource != subresource ||
+                pending.Transition.StateAfter != before) {
+                continue;
+            }
+
+            m_stats.merged++;
+            if (pending.Transition.StateBefore == after) {
+                m_pending.erase(m_pending.begin() + i);
+            } else {
+                pending.Transition.StateAfter = after;
+            }
+            return;
+        }
+    }
+
+    D3D12_RESOURCE_BARRIER barrier = {};
+    barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    barrier.Flags = flags;
+    barrier.Transition.pResource = resource;
+    barrier.Transition.Subresource = subresource;
+    barrier.Transition.StateBefore = before;
+    barrier.Transition.StateAfter = after;
+    m_pending.push_back(barrier);
+}
+
+bool ResourceStateTracker::HasSplit(ID3D12Resource* resource) const
+{
+    for (const SplitTransition& split : m_splits) {
+        if (split.resource == resource) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ResourceStateTracker::FinishSplit(ID3D12Resource* resource, UINT subresource, D3D12_RESOURCE_STATES state, bool exact)
+{
+    for (size_t i = 0; i < m_splits.size(); i++) {
+        SplitTransition split = m_splits[i];
+        if (split.resource != resource || split.subresource != subresource) {
+            continue;
+        }
+        m_splits.erase(m_splits.begin() + i);
+
+        if (!split.begun) {
+            // BEGIN_ONLY 还没发出去，中间没有空隙，换成普通转换
+            for (size_t j = 0; j < m_pending.size(); j++) {
+                D3D12_RESOURCE_BARRIER& pending = m_pending[j];
+                if (pending.Flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY &&
+                    pending.Transition.pResource == resource &&
+                    pending.Transition.Subresource == subresource) {
+                    pending.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+                    break;
+                }
+            }
+        } else {
+            AddTransition(resource, subresource, split.before, split.after, D3D12_RESOURCE_BARRIER_FLAG_END_ONLY);
+            m_stats.splitBarriers++;
+        }
+
+        // 拆分转换的目标状态不满足要求时，再接一个普通转换
+        if (exact ? split.after != state : !Satisfies(split.after, state)) {
+            AddTransition(resource, subresource, split.after, state, D3D12_RESOURCE_BARRIER_FLAG_NONE);
+        }
+        return true;
+    }
+    return false;
+}
+
+void ResourceStateTracker::TransitionSubresource(
+    ID3D12Resource* resource, UINT subresource,
+    D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after, bool exact)
+{
+    if (FinishSplit(resource, subresource, after, exact)) {
+        return;
+    }
+    if (exact ? before == after : Satisfies(before, after)) {
+        return;
+    }
+    AddTransition(resource, subresource, before, after, D3D12_RESOURCE_BARRIER_FLAG_NONE);
+}
+
+void ResourceStateTracker::Require(ID3D12Resource* resource, D3D12_RESOURCE_STATES state, UINT subresource)
+{
+    TrackedResource& tracked = GetTracked(resource);
+    if (tracked.subresourceCount == 1) {
+        subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    }
+
+    if (subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES) {
+        // 子资源各自转换过，但现在状态又一致、也没有进行中的拆分：合回整个资源，发一个屏障而不是每个子资源一个
+        if (!tracked.subresourceStates.empty() && !HasSplit(resource) &&
+            std::all_of(tracked.subresourceStates.begin(), tracked.subresourceStates.end(),
+                [&](D3D12_RESOURCE_STATES subresourceState) { return subresourceState == tracked.subresourceStates[0]; })) {
+            tracked.state = tracked.subresourceStates[0];
+            tracked.subresourceStates.clear();
+        }
+
+        if (tracked.subresourceStates.empty()) {
+            TransitionSubresource(resource, subresource, tracked.state, state, false);
+            tracked.state = Satisfies(tracked.state, state) ? tracked.state : state;
+        } else {
+            // 子资源状态不一致：逐个转换到完全相同的状态，然后重新按整个资源跟踪
+            for (UINT i = 0; i < tracked.subresourceCount; i++) {
+                TransitionSubresource(resource, i, tracked.subresourceStates[i], state, true);
+            }
+            tracked.subresourceStates.clear();
+            tracked.state = state;
+        }
+        return;
+    }
+
+    if (subresource >= tracked.subresourceCount) {
+        throw std::out_of_range("Subresource index out of range");
+    }
+    if (tracked.subresourceStates.empty()) {
+        tracked.subresourceStates.assign(tracked.subresourceCount, tracked.state);
+    }
+
+    D3D12_RESOURCE_STATES& current = tracked.subresourceStates[subresource];
+    TransitionSubresource(resource, subresource, current, state, false);
+    current = Satisfies(current, state) ? current : state;
+}
+
+void ResourceStateTracker::BeginTransition(ID3D12Resource* resource, D3D12_RESOURCE_STATES state, UINT subresource)
+{
+    TrackedResource& tracked = GetTracked(resource);
+    if (tracked.subresourceCount == 1) {
+        subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    }
+
+    // 只处理状态一致的整个资源或单个子资源
+    D3D12_RESOURCE_STATES before;
+    if (subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES) {
+        if (!tracked.subresourceStates.empty()) {
+            return;
+        }
+        before = tracked.state;
+    } else {
+        before = GetState(resource, subresource);
+    }
+    if (Satisfies(before, state)) {
+        return;
+    }
+    for (const SplitTransition& split : m_splits) {
+        if (split.resource == resource && split.subresource == subresource) {
+            return;
+        }
+    }
+
+    AddTransition(resource, subresource, before, state, D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY);
+    m_splits.push_back({ resource, subresource, before, state, false });
+
+    // 从跟踪的角度看资源已经在目标状态了，拆分的后半段在 Require 时补上
+    if (subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES) {
+        tracked.state = state;
+    } else {
+        if (tracked.subresourceStates.empty()) {
+            tracked.subresourceStates.assign(tracked.subresourceCount, tracked.state);
+        }
+        tracked.subresourceStates[subresource] = state;
+    }
+}
+
+UINT ResourceStateTracker::Flush(ID3D12GraphicsCommandList* commandList, bool closingList)
+{
+    // 拆分屏障不能跨命令列表，列表关闭前把未结束的拆分都结束掉
+    if (closingList) {
+        while (!m_splits.empty()) {
+            const SplitTransition split = m_splits.back();
+            FinishSplit(split.resource, split.subresource, split.after, true);
+        }
+    }
+
+    const UINT count = static_cast<UINT>(m_pending.size());
+    if (count > 0) {
+        commandList->ResourceBarrier(count, m_pending.data());
+        m_stats.barriers += count;
+        m_stats.barrierCalls++;
+        m_pending.clear();
+    }
+
+    // 已经发出的 BEGIN_ONLY 之后，Require 时要用 END_ONLY 结束
+    for (SplitTransition& split : m_splits) {
+        split.begun = true;
+    }
+    return count;
+}
@@ -0,0 +1,90 @@
+// StagingBatcher.cpp
+#include "StagingBatcher.h"
+#include <algorithm>
+#include <cstring>
+
+void StagingBatcher::Add(uint64_t destination, uint64_t destinationOffset, const void* data, uint64_t size)
+{
+    if (size == 0) {
+        return;
+    }
+    const uint64_t dataOffset = m_data.size();
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    m_data.insert(m_data.end(), bytes, bytes + size);
+    m_pending.push_back({ destination, destinationOffset, size, dataOffset, m_pending.size() });
+    m_stats.requested++;
+}
+
+void StagingBatcher::Clear()
+{
+    m_pending.clear();
+    m_data.clear();
+    m_copies.clear();
+}
+
+const std::vector<StagingCopy>& StagingBatcher::Build(IStagingAllocator& allocator)
+{
+    m_copies.clear();
+    std::sort(m_pending.begin(), m_pending.end(), [](const Pending& a, const Pending& b) {
+        if (a.destination != b.destination) {
+            return a.destination < b.destination;
+        }
+        if (a.destinationOffset != b.destinationOffset) {
+            return a.destinationOffset < b.destinationOffset;
+        }
+        return a.sequence < b.sequence;
+    });
+
+    // 每个目标单独处理
+    size_t begin = 0;
+    while (begin < m_pending.size()) {
+        size_t end = begin + 1;
+        while (end < m_pending.size() && m_pending[end].destination == m_pending[begin].destination) {
+            end++;
+        }
+        EmitGroup(begin, end, allocator);
+        begin = end;
+    }
+
+    m_stats.emitted += m_copies.size();
+    return m_copies;
+}
+
+void StagingBatcher::EmitGroup(size_t begin, size_t end, IStagingAllocator& allocator)
+{
+    // 有重叠的写入时回到提交顺序，后写的覆盖先写的
+    for (size_t i = begin + 1; i < end; i++) {
+        const Pending& previous = m_pending[i - 1];
+        if (previous.destinationOffset + previous.size > m_pending[i].destinationOffset) {
+            std::sort(m_pending.begin() + begin, m_pending.begin() + end,
+                [](const Pending& a, const Pending& b) { return a.sequence < b.sequence; });
+            break;
+        }
+    }
+
+    const size_t groupStart = m_copies.size();
+    for (size_t i = begin; i < end; i++) {
+        const Pending& pending = m_pending[i];
+        const StagingSpan span = allocator.Allocate(pending.size);
+        std::memcpy(span.cpuAddress, m_data.data() + pending.dataOffset, static_cast<size_t>(pending.size));
+
+        // 目标连续、暂存内存也连续时并进上一次复制
+        if (m_copies.size() > groupStart) {
+            StagingCopy& last = m_copies.back();
+            const bool destinationContiguous = last.destinationOffset + last.size == pending.destinationOffset;
+            const bool stagingContiguous = last.stagingPage == span.page && last.stagingOffset + last.size == span.offset;
+            if (destinationContiguous && stagingContiguous) {
+                last.size += pending.size;
+                continue;
+            }
+        }
+
+        StagingCopy copy;
+        copy.destination = pending.destination;
+        copy.destinationOffset = pending.destinationOffset;
+        copy.stagingPage = span.page;
+        copy.stagingOffset = span.offset;
+        copy.size = pending.size;
+        m_copies.push_back(copy);
+    }
+}
@@ -0,0 +1,185 @@
+// StateFilteredCommandList.cpp
+#include "StateFilteredCommandList.h"
+#include <algorithm>
+#include <cstring>
+
+StateFilteredCommandList::StateFilteredCommandList(ID3D12GraphicsCommandList* commandList)
+    : m_commandList(commandList)
+{
+}
+
+void StateFilteredCommandList::Invalidate()
+{
+    m_pipelineValid = false;
+    m_rootSignatureValid = false;
+    m_descriptorHeapCount = 0;
+    m_rootTableValidMask = 0;
+    m_topologyValid = false;
+    m_vertexBufferValidMask = 0;
+    m_indexBufferValid = false;
+    m_viewportCount = 0;
+    m_scissorCount = 0;
+    m_renderTargetsValid = false;
+}
+
+bool StateFilteredCommandList::Elide(bool redundant)
+{
+    if (redundant) {
+        m_stats.elided++;
+    } else {
+        m_stats.issued++;
+    }
+    return redundant;
+}
+
+void StateFilteredCommandList::SetPipelineState(ID3D12PipelineState* pipelineState)
+{
+    if (Elide(m_pipelineValid && m_pipelineState == pipelineState)) {
+        return;
+    }
+    m_commandList->SetPipelineState(pipelineState);
+    m_pipelineState = pipelineState;
+    m_pipelineValid = true;
+}
+
+void StateFilteredCommandList::SetGraphicsRootSignature(ID3D12RootSignature* rootSignature)
+{
+    if (Elide(m_rootSignatureValid && m_rootSignature == rootSignature)) {
+        return;
+    }
+    m_commandList->SetGraphicsRootSignature(rootSignature);
+    m_rootSignature = rootSignature;
+    m_rootSignatureValid = true;
+    m_rootTableValidMask = 0;
+}
+
+void StateFilteredCommandList::SetDescriptorHeaps(UINT numHeaps, ID3D12DescriptorHeap* const* heaps)
+{
+    const bool cacheable = numHeaps > 0 && numHeaps <= MAX_DESCRIPTOR_HEAPS;
+    if (Elide(cacheable && m_descriptorHeapCount == numHeaps &&
+              std::equal(heaps, heaps + numHeaps, m_descriptorHeaps))) {
+        return;
+    }
+    m_commandList->SetDescriptorHeaps(numHeaps, heaps);
+    m_descriptorHeapCount = cacheable ? numHeaps : 0;
+    if (cacheable) {
+        std::copy(heaps, heaps + numHeaps, m_descriptorHeaps);
+    }
+    m_rootTableValidMask = 0;
+}
+
+void StateFilteredCommandList::SetGraphicsRootDescriptorTable(UINT rootIndex, D3D12_GPU_DESCRIPTOR_HANDLE table)
+{
+    const bool cacheable = rootIndex < MAX_ROOT_TABLES;
+    if (Elide(cacheable && (m_rootTableValidMask & (1u << rootIndex)) && m_rootTables[rootIndex].ptr == table.ptr)) {
+        return;
+    }
+    m_commandList->SetGraphicsRootDescriptorTable(rootIndex, table);
+    if (cacheable) {
+        m_rootTables[rootIndex] = table;
+        m_rootTableValidMask |= 1u << rootIndex;
+    }
+}
+
+void StateFilteredCommandList::IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY topology)
+{
+    if (Elide(m_topologyValid && m_topology == topology)) {
+        return;
+    }
+    m_commandList->IASetPrimitiveTopology(topology);
+    m_topology = topology;
+    m_topologyValid = true;
+}
+
+void StateFilteredCommandList::IASetVertexBuffers(UINT startSlot, UINT numViews, const D3D12_VERTEX_BUFFER_VIEW* views)
+{
+    // 超出缓存范围的槽位不做过滤
+    if (views == nullptr || startSlot + numViews > MAX_VERTEX_BUFFERS) {
+        Elide(false);
+        m_commandList->IASetVertexBuffers(startSlot, numViews, views);
+        for (UINT slot = startSlot; slot < startSlot + numViews && slot < MAX_VERTEX_BUFFERS; slot++) {
+            m_vertexBufferValidMask &= ~(1u << slot);
+        }
+        return;
+    }
+
+    const UINT mask = ((numViews >= 32 ? 0u : (1u << numViews)) - 1u) << startSlot;
+    const bool redundant = (m_vertexBufferValidMask & mask) == mask &&
+        std::memcmp(&m_vertexBuffers[startSlot], views, numViews * sizeof(D3D12_VERTEX_BUFFER_VIEW)) == 0;
+    if (Elide(redundant)) {
+        return;
+    }
+    m_commandList->IASetVertexBuffers(startSlot, numViews, views);
+    std::memcpy(&m_vertexBuffers[startSlot], views, numViews * sizeof(D3D12_VERTEX_BUFFER_VIEW));
+    m_vertexBufferValidMask |= mask;
+}
+
+void StateFilteredCommandList::IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW* view)
+{
+    if (view == nullptr) {
+        Elide(false);
+        m_commandList->IASetIndexBuffer(view);
+        m_indexBufferValid = false;
+        return;
+    }
+    if (Elide(m_indexBufferValid && std::memcmp(&m_indexBuffer, view, sizeof(D3D12_INDEX_BUFFER_VIEW)) == 0)) {
+        return;
+    }
+    m_commandList->IASetIndexBuffer(view);
+    m_indexBuffer = *view;
+    m_indexBufferValid = true;
+}
+
+void StateFilteredCommandList::RSSetViewports(UINT numViewports, const D3D12_VIEWPORT* viewports)
+{
+    const bool cacheable = numViewports > 0 && numViewports <= MAX_VIEWPORTS;
+    if (Elide(cacheable && m_viewportCount == numViewports &&
+              std::memcmp(m_viewports, viewports, numViewports * sizeof(D3D12_VIEWPORT)) == 0)) {
+        return;
+    }
+    m_commandList->RSSetViewports(numViewports, viewports);
+    m_viewportCount = cacheable ? numViewports : 0;
+    if (cacheable) {
+        std::memcpy(m_viewports, viewports, numViewports * sizeof(D3D12_VIEWPORT));
+    }
+}
+
+void StateFilteredCommandList::RSSetScissorRects(UINT numRects, const D3D12_RECT* rects)
+{
+    const bool cacheable = numRects > 0 && numRects <= MAX_VIEWPORTS;
+    if (Elide(cacheable && m_scissorCount == numRects &&
+              std::memcmp(m_scissors, rects, numRects * sizeof(D3D12_RECT)) == 0)) {
+        return;
+    }
+    m_commandList->RSSetScissorRects(numRects, rects);
+    m_scissorCount = cacheable ? numRects : 0;
+    if (cacheable) {
+        std::memcpy(m_scissors, rects, numRects * sizeof(D3D12_RECT));
+    }
+}
+
+void StateFilteredCommandList::OMSetRenderTargets(UINT numRenderTargets, const D3D12_CPU_DESCRIPTOR_HANDLE* rtvs, const D3D12_CPU_DESCRIPTOR_HANDLE* dsv)
+{
+    const bool cacheable = numRenderTargets <= MAX_RENDER_TARGETS;
+    bool redundant = cacheable && m_renderTargetsValid &&
+        m_renderTargetCount == numRenderTargets &&
+        m_hasDepthStencil == (dsv != nullptr) &&
+        (dsv == nullptr || dsv->ptr == m_depthStencil.ptr);
+    for (UINT i = 0; redundant && i < numRenderTargets; i++) {
+        redundant = rtvs[i].ptr == m_renderTargets[i].ptr;
+    }
+    if (Elide(redundant)) {
+        return;
+    }
+
+    m_commandList->OMSetRenderTargets(numRenderTargets, rtvs, FALSE, dsv);
+    m_renderTargetsValid = cacheable;
+    if (cacheable) {
+        m_renderTargetCount = numRenderTargets;
+        for (UINT i = 0; i < numRenderTargets; i++) {
+            m_renderTargets[i] = rtvs[i];
+        }
+        m_hasDepthStencil = dsv != nullptr;
+        m_depthStencil = dsv ? *dsv : D3D12_CPU_DESCRIPTOR_HANDLE{};
+    }
+}
@@ -0,0 +1,299 @@
+// TlsfAllocator.cpp
+#include "TlsfAllocator.h"
+#include <algorithm>
+#include <stdexcept>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+uint32_t HighestBit(uint64_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<uint32_t>(index);
+#else
+    return 63u - static_cast<uint32_t>(__builtin_clzll(value));
+#endif
+}
+
+uint32_t LowestBit(uint64_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<uint32_t>(index);
+#else
+    return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+}
+}
+
+TlsfAllocator::TlsfAllocator(uint64_t capacity)
+    : m_capacity(capacity)
+{
+    if (capacity == 0) {
+        throw std::invalid_argument("TlsfAllocator capacity must not be zero");
+    }
+    for (uint32_t fl = 0; fl < FL_COUNT; fl++) {
+        for (uint32_t sl = 0; sl < SL_COUNT; sl++) {
+            m_freeHeads[fl][sl] = INVALID_BLOCK;
+        }
+    }
+
+    const uint32_t block = NewBlock();
+    m_blocks[block].offset = 0;
+    m_blocks[block].size = capacity;
+    InsertFree(block);
+}
+
+void TlsfAllocator::Mapping(uint64_t size, uint32_t& fl, uint32_t& sl)
+{
+    // 小于 SL_COUNT 的大小线性映射到第 0 级
+    if (size < SL_COUNT) {
+        fl = 0;
+        sl = static_cast<uint32_t>(size);
+        return;
+    }
+    const uint32_t bit = HighestBit(size);
+    sl = static_cast<uint32_t>(size >> (bit - SL_LOG2)) & (SL_COUNT - 1);
+    fl = bit - SL_LOG2 + 1;
+}
+
+void TlsfAllocator::MappingSearch(uint64_t size, uint32_t& fl, uint32_t& sl)
+{
+    // 向上取整到下一个桶的起点，这个桶里的任何块都放得下
+    if (size >= SL_COUNT) {
+        size += (1ull << (HighestBit(size) - SL_LOG2)) - 1;
+    }
+    Mapping(size, fl, sl);
+}
+
+uint32_t TlsfAllocator::NewBlock()
+{
+    if (!m_unusedBlocks.empty()) {
+        const uint32_t block = m_unusedBlocks.back();
+        m_unusedBlocks.pop_back();
+        m_blocks[block] = Block();
+        return block;
+    }
+    m_blocks.push_back(Block());
+    return static_cast<uint32_t>(m_blocks.size() - 1);
+}
+
+void TlsfAllocator::DeleteBlock(uint32_t block)
+{
+    m_unusedBlocks.push_back(block);
+}
+
+void TlsfAllocator::InsertFree(uint32_t block)
+{
+    Block& b = m_blocks[block];
+    uint32_t fl, sl;
+    Mapping(b.size, fl, sl);
+
+    b.free = true;
+    b.prevFree = INVALID_BLOCK;
+    b.nextFree = m_freeHeads[fl][sl];
+    if (b.nextFree != INVALID_BLOCK) {
+        m_blocks[b.nextFree].prevFree = block;
+    }
+    m_freeHeads[fl][sl] = block;
+    m_flBitmap |= 1ull << fl;
+    m_slBitmaps[fl] |= 1u << sl;
+}
+
+void TlsfAllocator::RemoveFree(uint32_t block)
+{
+    Block& b = m_blocks[block];
+    uint32_t fl, sl;
+    Mapping(b.size, fl, sl);
+
+    if (b.prevFree != INVALID_BLOCK) {
+        m_blocks[b.prevFree].nextFree = b.nextFree;
+    } else {
+        m_freeHeads[fl][sl] = b.nextFree;
+    }
+    if (b.nextFree != INVALID_BLOCK) {
+        m_blocks[b.nextFree].prevFree = b.prevFree;
+    }
+    if (m_freeHeads[fl][sl] == INVALID_BLOCK) {
+        m_slBitmaps[fl] &= ~(1u << sl);
+        if (m_slBitmaps[fl] == 0) {
+            m_flBitmap &= ~(1ull << fl);
+        }
+    }
+    b.free = false;
+    b.prevFree = INVALID_BLOCK;
+    b.nextFree = INVALID_BLOCK;
+}
+
+uint32_t TlsfAllocator::FindFreeBlock(uint64_t size)
+{
+    uint32_t fl, sl;
+    MappingSearch(size, fl, sl);
+    if (fl >= FL_COUNT) {
+        return INVALID_BLOCK;
+    }
+
+    // 先在同一级里找不小于 sl 的桶，再找更高的一级
+    uint32_t slMap = m_slBitmaps[fl] & (~0u << sl);
+    if (slMap == 0) {
+        const uint64_t flMap = fl + 1 < FL_COUNT ? m_flBitmap & (~0ull << (fl + 1)) : 0;
+        if (flMap == 0) {
+            return INVALID_BLOCK;
+        }
+        fl = LowestBit(flMap);
+        slMap = m_slBitmaps[fl];
+    }
+    sl = LowestBit(slMap);
+    return m_freeHeads[fl][sl];
+}
+
+bool TlsfAllocator::Fits(uint32_t block, uint64_t size, uint64_t alignment) const
+{
+    const Block& b = m_blocks[block];
+    const uint64_t alignedOffset = (b.offset + alignment - 1) & ~(alignment - 1);
+    return alignedOffset - b.offset + size <= b.size;
+}
+
+void TlsfAllocator::SplitTail(uint32_t block, uint64_t size)
+{
+    const uint64_t remaining = m_blocks[block].size - size;
+    if (remaining == 0) {
+        return;
+    }
+
+    const uint32_t tail = NewBlock();
+    Block& b = m_blocks[block]; // NewBlock 可能让 vector 重新分配
+    Block& t = m_blocks[tail];
+    t.offset = b.offset + size;
+    t.size = remaining;
+    t.prevPhysical = block;
+    t.nextPhysical = b.nextPhysical;
+    if (b.nextPhysical != INVALID_BLOCK) {
+        m_blocks[b.nextPhysical].prevPhysical = tail;
+    }
+    b.nextPhysical = tail;
+    b.size = size;
+    InsertFree(tail);
+}
+
+TlsfAllocator::Allocation TlsfAllocator::Allocate(uint64_t size, uint64_t alignment)
+{
+    Allocation allocation;
+    if (size == 0 || (alignment & (alignment - 1)) != 0) {
+        return allocation;
+    }
+    alignment = std::max<uint64_t>(alignment, 1);
+
+    const uint64_t searchSize = size + alignment - 1;
+    if (searchSize < size || size > m_capacity) {
+        return allocation;
+    }
+    // 先按 size 找，起点对齐后还放得下就直接用，这样刚好够大的对齐空闲块也能复用
+    uint32_t block = FindFreeBlock(size);
+    if (block != INVALID_BLOCK && !Fits(block, size, alignment)) {
+        // 起点没对齐时再按 size + alignment - 1 找，这个大小的块一定能切出对齐的区间
+        block = alignment > 1 && searchSize <= m_capacity ? FindFreeBlock(searchSize) : INVALID_BLOCK;
+    }
+    if (block == INVALID_BLOCK) {
+        // 向上取整的查找可能漏掉刚好够用的块，最后在这两个大小所在的桶里顺序找一次
+        const uint64_t scanSizes[2] = { size, std::min(searchSize, m_capacity) };
+        for (uint32_t i = 0; i < 2 && block == INVALID_BLOCK; i++) {
+            uint32_t fl, sl;
+            Mapping(scanSizes[i], fl, sl);
+            for (uint32_t candidate = fl < FL_COUNT ? m_freeHeads[fl][sl] : INVALID_BLOCK;
+                 candidate != INVALID_BLOCK; candidate = m_blocks[candidate].nextFree) {
+                if (Fits(candidate, size, alignment)) {
+                    block = candidate;
+                    break;
+                }
+            }
+        }
+        if (block == INVALID_BLOCK) {
+            return allocation;
+        }
+    }
+    RemoveFree(block);
+
+    // 对齐前面空出来的部分放回空闲表
+    const uint64_t offset = m_blocks[block].offset;
+    const uint64_t alignedOffset = (offset + alignment - 1) & ~(alignment - 1);
+    const uint64_t padding = alignedOffset - offset;
+    if (padding > 0) {
+        SplitTail(block, padding);
+        const uint32_t head = block;
+        block = m_blocks[head].nextPhysical;
+        RemoveFree(block);
+        InsertFree(head);
+    }
+    SplitTail(block, size);
+
+    m_usedBytes += size;
+    m_allocationCount++;
+    allocation.offset = alignedOffset;
+    allocation.size = size;
+    allocation.block = block;
+    return allocation;
+}
+
+void TlsfAllocator::Free(const Allocation& allocation)
+{
+    if (!allocation.IsValid()) {
+        return;
+    }
+    uint32_t block = allocation.block;
+    if (block >= m_blocks.size() || m_blocks[block].free || m_blocks[block].offset != allocation.offset) {
+        throw std::invalid_argument("TlsfAllocator: invalid or double free");
+    }
+    m_usedBytes -= m_blocks[block].size;
+    m_allocationCount--;
+
+    // 和前后相邻的空闲块合并
+    const uint32_t prev = m_blocks[block].prevPhysical;
+    if (prev != INVALID_BLOCK && m_blocks[prev].free) {
+        RemoveFree(prev);
+        m_blocks[prev].size += m_blocks[block].size;
+        m_blocks[prev].nextPhysical = m_blocks[block].nextPhysical;
+        if (m_blocks[block].nextPhysical != INVALID_BLOCK) {
+            m_blocks[m_blocks[block].nextPhysical].prevPhysical = prev;
+        }
+        DeleteBlock(block);
+        block = prev;
+    }
+    const uint32_t next = m_blocks[block].nextPhysical;
+    if (next != INVALID_BLOCK && m_blocks[next].free) {
+        RemoveFree(next);
+        m_blocks[block].size += m_blocks[next].size;
+        m_blocks[block].nextPhysical = m_blocks[next].nextPhysical;
+        if (m_blocks[next].nextPhysical != INVALID_BLOCK) {
+            m_blocks[m_blocks[next].nextPhysical].prevPhysical = block;
+        }
+        DeleteBlock(next);
+    }
+    InsertFree(block);
+}
+
+TlsfAllocator::Stats TlsfAllocator::GetStats() const
+{
+    Stats stats;
+    stats.capacity = m_capacity;
+    stats.allocationCount = m_allocationCount;
+    for (uint32_t fl = 0; fl < FL_COUNT; fl++) {
+        if ((m_flBitmap & (1ull << fl)) == 0) {
+            continue;
+        }
+        for (uint32_t sl = 0; sl < SL_COUNT; sl++) {
+            for (uint32_t block = m_freeHeads[fl][sl]; block != INVALID_BLOCK; block = m_blocks[block].nextFree) {
+                stats.freeBytes += m_blocks[block].size;
+                stats.largestFreeBlock = std::max(stats.largestFreeBlock, m_blocks[block].size);
+                stats.freeBlockCount++;
+            }
+        }
+    }
+    stats.usedBytes = m_capacity - stats.freeBytes;
+    stats.fragmentation = stats.freeBytes > 0 ? 1.0 - static_cast<double>(stats.largestFreeBlock) / stats.freeBytes : 0.0;
+    return stats;
+}
@@ -0,0 +1,214 @@
+// TransientResourceHeap.cpp
+#include "TransientResourceHeap.h"
+#include "Hash.h"
+#include "d3dx12.h"
+#include <algorithm>
+#include <stdexcept>
+
+TransientResourceHeap::TransientResourceHeap(ID3D12Device* device, GpuMemoryTracker& memoryTracker, IGpuTimeline& timeline, ResourceStateTracker& tracker, DeferredReleaseQueue& releaseQueue)
+    : m_device(device), m_memoryTracker(memoryTracker), m_timeline(timeline), m_tracker(tracker), m_releaseQueue(releaseQueue)
+{
+    // 资源堆层级 2 允许缓冲区和各种纹理放在同一个堆里，所有临时资源可以互相别名
+    D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+    if (SUCCEEDED(m_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options)))) {
+        m_sharedHeap = options.ResourceHeapTier >= D3D12_RESOURCE_HEAP_TIER_2;
+    }
+}
+
+TransientResourceHeap::~TransientResourceHeap()
+{
+    for (uint32_t group = 0; group < HEAP_GROUP_COUNT; group++) {
+        ReleaseResources(group);
+    }
+}
+
+void TransientResourceHeap::ReleaseResources(uint32_t heapGroup)
+{
+    for (auto it = m_resources.begin(); it != m_resources.end();) {
+        if (it->second.heapGroup != heapGroup) {
+            ++it;
+            continue;
+        }
+        m_tracker.Unregister(it->second.resource.Get());
+        it = m_resources.erase(it);
+    }
+}
+
+uint32_t TransientResourceHeap::GetHeapGroup(const D3D12_RESOURCE_DESC& desc) const
+{
+    if (m_sharedHeap) {
+        return HEAP_GROUP_BUFFERS; // 层级 2 上只用第一个堆
+    }
+    if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER) {
+        return HEAP_GROUP_BUFFERS;
+    }
+    const D3D12_RESOURCE_FLAGS targetFlags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+    return (desc.Flags & targetFlags) != 0 ? HEAP_GROUP_RT_DS_TEXTURES : HEAP_GROUP_OTHER_TEXTURES;
+}
+
+uint64_t TransientResourceHeap::HashDesc(const D3D12_RESOURCE_DESC& desc)
+{
+    uint64_t hash = HashValue(desc.Dimension);
+    hash = HashCombine(hash, desc.Alignment);
+    hash = HashCombine(hash, desc.Width);
+    hash = HashCombine(hash, desc.Height);
+    hash = HashCombine(hash, desc.DepthOrArraySize);
+    hash = HashCombine(hash, desc.MipLevels);
+    hash = HashCombine(hash, desc.Format);
+    hash = HashCombine(hash, desc.SampleDesc.Count);
+    hash = HashCombine(hash, desc.SampleDesc.Quality);
+    hash = HashCombine(hash, desc.Layout);
+    return HashCombine(hash, desc.Flags);
+}
+
+bool TransientResourceHeap::IsSameDesc(const D3D12_RESOURCE_DESC& a, const D3D12_RESOURCE_DESC& b)
+{
+    return a.Dimension == b.Dimension && a.Alignment == b.Alignment && a.Width == b.Width && a.Height == b.Height
+        && a.DepthOrArraySize == b.DepthOrArraySize && a.MipLevels == b.MipLevels && a.Format == b.Format
+        && a.SampleDesc.Count == b.SampleDesc.Count && a.SampleDesc.Quality == b.SampleDesc.Quality
+        && a.Layout == b.Layout && a.Flags == b.Flags;
+}
+
+void TransientResourceHeap::BeginFrame()
+{
+    m_descs.clear();
+    m_frameNumber++;
+    EvictUnused();
+}
+
+void TransientResourceHeap::EvictUnused()
+{
+    // 渲染图的形状变了以后，旧偏移上的资源不会再被用到；GPU 可能还在用，交给延迟释放队列
+    for (auto it = m_resources.begin(); it != m_resources.end();) {
+        if (m_frameNumber - it->second.lastUsedFrame <= EVICT_AFTER_FRAMES) {
+            ++it;
+            continue;
+        }
+        m_tracker.Unregister(it->second.resource.Get());
+        m_releaseQueue.Release(it->second.resource, m_timeline);
+        it = m_resources.erase(it);
+        m_stats.evictedCount++;
+    }
+}
+
+FrameGraphResource TransientResourceHeap::Register(FrameGraph& graph, const char* name, const D3D12_RESOURCE_DESC& desc)
+{
+    const D3D12_RESOURCE_ALLOCATION_INFO info = m_device->GetResourceAllocationInfo(0, 1, &desc);
+    m_descs.push_back(desc);
+    return graph.CreateTransient(name, info.SizeInBytes, info.Alignment, m_descs.size() - 1, GetHeapGroup(desc));
+}
+
+FrameGraphResource TransientResourceHeap::CreateTexture(FrameGraph& graph, const char* name, const D3D12_RESOURCE_DESC& desc)
+{
+    if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER) {
+        throw std::invalid_argument("Use CreateBuffer for transient buffers");
+    }
+    return Register(graph, name, desc);
+}
+
+FrameGraphResource TransientResourceHeap::CreateBuffer(FrameGraph& graph, const char* name, uint64_t size, D3D12_RESOURCE_FLAGS flags)
+{
+    return Register(graph, name, CD3DX12_RESOURCE_DESC::Buffer(size, flags));
+}
+
+void TransientResourceHeap::GrowHeap(uint32_t heapGroup, uint64_t requiredSize)
+{
+    Heap& heap = m_heaps[heapGroup];
+
+    // 按倍数增长，需求每帧慢慢变大时不会每帧都重建堆和其上的所有放置资源
+    const uint64_t newSize = AlignUp(std::max(requiredSize, heap.size * 2), D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+
+    // 旧堆上的放置资源可能还在飞行中的帧里使用，交给延迟释放队列，不等 GPU
+    for (auto& entry : m_resources) {
+        if (entry.second.heapGroup == heapGroup) {
+            m_releaseQueue.Release(entry.second.resource, m_timeline);
+        }
+    }
+    ReleaseResources(heapGroup);
+    if (heap.heap) {
+        m_releaseQueue.Release(heap.heap, m_timeline);
+        heap.heap.Reset();
+        m_stats.heapBytes -= heap.size;
+        heap.size = 0;
+    }
+
+    D3D12_HEAP_DESC heapDesc = {};
+    heapDesc.SizeInBytes = newSize;
+    heapDesc.Properties.Type = D3D12_HEAP_TYPE_DEFAULT;
+    heapDesc.Alignment = D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT;
+    if (m_sharedHeap) {
+        heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES;
+    } else if (heapGroup == HEAP_GROUP_BUFFERS) {
+        heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+    } else if (heapGroup == HEAP_GROUP_RT_DS_TEXTURES) {
+        heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+    } else {
+        heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+    }
+    if (FAILED(m_memoryTracker.CreateHeap(&heapDesc, IID_PPV_ARGS(&heap.heap)))) {
+        throw std::runtime_error("Failed to create transient resource heap");
+    }
+    heap.size = heapDesc.SizeInBytes;
+    m_stats.heapBytes += heap.size;
+}
+
+void TransientResourceHeap::Realize(FrameGraph& graph)
+{
+    m_stats.requiredBytes = graph.GetTransientHeapSize();
+    m_stats.lowerBoundBytes = graph.GetPeakLiveTransientSize();
+    m_stats.committedBytes = 0;
+    m_stats.resourceCount = 0;
+
+    for (uint32_t group = 0; group < HEAP_GROUP_COUNT; group++) {
+        const uint64_t requiredSize = graph.GetTransientHeapSize(group);
+        if (requiredSize > m_heaps[group].size) {
+            GrowHeap(group, requiredSize);
+        }
+    }
+
+    for (FrameGraphResource resource = 0; resource < graph.GetResourceCount(); resource++) {
+        if (!graph.IsTransient(resource) || !graph.IsResourceUsed(resource)) {
+            continue;
+        }
+
+        const D3D12_RESOURCE_DESC& desc = m_descs[graph.GetUserData(resource)];
+        const uint32_t group = graph.GetHeapGroup(resource);
+        const uint64_t offset = graph.GetHeapOffset(resource);
+        const uint64_t key = HashCombine(HashCombine(HashDesc(desc), offset), group);
+
+        // 同样的资源单独用提交资源创建时至少按 64KB 对齐占用显存
+        const D3D12_RESOURCE_ALLOCATION_INFO info = m_device->GetResourceAllocationInfo(0, 1, &desc);
+        m_stats.committedBytes += AlignUp(info.SizeInBytes, std::max<uint64_t>(info.Alignment, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT));
+        m_stats.resourceCount++;
+
+        auto range = m_resources.equal_range(key);
+        auto it = std::find_if(range.first, range.second, [&](const auto& entry) {
+            return entry.second.heapGroup == group && entry.second.offset == offset && IsSameDesc(entry.second.desc, desc);
+        });
+        if (it == range.second) {
+            const GpuMemoryCategory category = desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER ? GpuMemoryCategory::Buffer
+                : (desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) ? GpuMemoryCategory::RenderTarget
+                : GpuMemoryCategory::Texture;
+            Microsoft::WRL::ComPtr<ID3D12Resource> placed;
+            if (FAILED(m_memoryTracker.CreatePlacedResource(category, m_heaps[group].heap.Get(), offset, &desc, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&placed)))) {
+                throw std::runtime_error("Failed to create placed transient resource");
+            }
+            m_tracker.Register(placed.Get(), D3D12_RESOURCE_STATE_COMMON);
+            it = m_resources.emplace(key, PlacedResource{ placed, desc, offset, group, m_frameNumber });
+        }
+        it->second.lastUsedFrame = m_frameNumber;
+        graph.SetPhysical(resource, reinterpret_cast<uint64_t>(it->second.resource.Get()));
+    }
+    m_stats.savedBytes = m_stats.committedBytes > m_stats.requiredBytes ? m_stats.committedBytes - m_stats.requiredBytes : 0;
+}
+
+void TransientResourceHeap::Activate(const FrameGraph& graph, FrameGraphResource resource)
+{
+    // 和它重叠的资源内容作废，使用方要先清除或丢弃再读取。
+    // 这一帧里之前占用整段内存的资源已知时只对它做别名，否则（帧的第一个使用者）对任何重叠的资源
+    const FrameGraphResource predecessor = graph.GetAliasPredecessor(resource);
+    ID3D12Resource* before = predecessor != FrameGraph::INVALID_RESOURCE
+        ? reinterpret_cast<ID3D12Resource*>(graph.GetPhysical(predecessor))
+        : nullptr;
+    m_tracker.Alias(before, reinterpret_cast<ID3D12Resource*>(graph.GetPhysical(resource)));
+}
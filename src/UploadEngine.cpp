@@ -0,0 +1,305 @@
+// UploadEngine.cpp
+#include "UploadEngine.h"
+#include "d3dx12.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+UploadEngine::UploadEngine(ID3D12Device* device, GpuMemoryTracker& memoryTracker, CommandListPool& pool, QueueScheduler& scheduler, DeferredReleaseQueue& releaseQueue)
+    : m_device(device), m_memoryTracker(memoryTracker), m_pool(pool), m_scheduler(scheduler), m_releaseQueue(releaseQueue), m_timeline(scheduler.GetTimeline(GpuQueue::Copy)), m_completion(m_timeline)
+{
+}
+
+UploadEngine::~UploadEngine()
+{
+    // 暂存页可能还在被复制队列读取
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FlushLocked();
+    m_timeline.WaitForValue(m_timeline.GetLastSignaledValue());
+}
+
+UploadEngine::StagingPage UploadEngine::CreatePage(uint64_t size)
+{
+    StagingPage page;
+    page.size = size;
+    HRESULT hr = m_memoryTracker.CreateCommittedResource(
+        GpuMemoryCategory::Upload,
+        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+        D3D12_HEAP_FLAG_NONE,
+        &CD3DX12_RESOURCE_DESC::Buffer(size),
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(&page.resource)
+    );
+    if (FAILED(hr)) {
+        throw std::runtime_error("Failed to create upload staging page");
+    }
+
+    // 上传堆的页一直保持映射
+    D3D12_RANGE readRange = { 0, 0 };
+    void* cpuAddress = nullptr;
+    if (FAILED(page.resource->Map(0, &readRange, &cpuAddress))) {
+        throw std::runtime_error("Failed to map upload staging page");
+    }
+    page.cpuAddress = static_cast<uint8_t*>(cpuAddress);
+    return page;
+}
+
+void UploadEngine::RecyclePages()
+{
+    const uint64_t completed = m_completion.GetCompletedValue();
+    while (!m_retiredPages.empty() && m_retiredPages.front().fenceValue <= completed) {
+        StagingPage page = std::move(m_retiredPages.front());
+        m_retiredPages.pop_front();
+        page.offset = 0;
+        m_freePages.push_back(std::move(page));
+    }
+    const uint64_t previousBatch = m_completedBatch;
+    while (!m_submitted.empty() && m_submitted.front().fenceValue <= completed) {
+        m_completedBatch = m_submitted.front().id;
+        m_completedFenceValue = m_submitted.front().fenceValue;
+        m_submitted.pop_front();
+    }
+
+    // 复制已经完成的资源不用再等，包括从来没有被使用过的
+    if (m_completedBatch != previousBatch) {
+        for (auto it = m_pendingResources.begin(); it != m_pendingResources.end();) {
+            it = it->second.batch <= m_completedBatch ? m_pendingResources.erase(it) : std::next(it);
+        }
+    }
+}
+
+// Flush 时缓冲区数据从当前打开的暂存页里按顺序分配，同一页里相邻两次分配首尾相接
+struct UploadEngine::OpenPageAllocator : IStagingAllocator {
+    explicit OpenPageAllocator(UploadEngine& engine) : engine(engine) {}
+
+    StagingSpan Allocate(uint64_t size) override
+    {
+        StagingSpan span;
+        span.page = engine.AllocateStaging(size, 1, span.offset);
+        span.cpuAddress = engine.m_openPages[span.page].cpuAddress + span.offset;
+        return span;
+    }
+
+    UploadEngine& engine;
+};
+
+uint32_t UploadEngine::AllocateStaging(uint64_t size, uint64_t alignment, uint64_t& offset)
+{
+    if (!m_openPages.empty()) {
+        StagingPage& page = m_openPages.back();
+        const uint64_t aligned = (page.offset + alignment - 1) & ~(alignment - 1);
+        if (aligned + size <= page.size) {
+            offset = aligned;
+            page.offset = aligned + size;
+            return static_cast<uint32_t>(m_openPages.size() - 1);
+        }
+    }
+
+    if (size > STAGING_PAGE_SIZE) {
+        m_openPages.push_back(CreatePage(size));
+    } else if (!m_freePages.empty()) {
+        m_openPages.push_back(std::move(m_freePages.back()));
+        m_freePages.pop_back();
+    } else {
+        m_openPages.push_back(CreatePage(STAGING_PAGE_SIZE));
+    }
+
+    // 页的起点满足任何对齐要求
+    StagingPage& page = m_openPages.back();
+    offset = 0;
+    page.offset = size;
+    return static_cast<uint32_t>(m_openPages.size() - 1);
+}
+
+UploadTicket UploadEngine::TrackUpload(ID3D12Resource* destination, uint64_t size)
+{
+    // 新的上传要重新等，之前声明过的等待只覆盖旧的批次
+    m_pendingResources[destination] = { m_currentBatch, 0 };
+    m_stats.uploads++;
+    m_stats.bytes += size;
+    return { m_currentBatch };
+}
+
+UploadTicket UploadEngine::UploadBuffer(ID3D12Resource* destination, uint64_t destinationOffset, const void* data, uint64_t size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    RecyclePages();
+
+    // 缓冲区数据先留在 CPU 内存里，Flush 时按目标排好序再写进暂存页，目标连续的写入合并成一次复制
+    m_bufferCopies.Add(reinterpret_cast<uint64_t>(destination), destinationOffset, data, size);
+    return TrackUpload(destination, size);
+}
+
+UploadTicket UploadEngine::UploadTexture(ID3D12Resource* destination, UINT subresource, const void* data, uint64_t rowPitch)
+{
+    const D3D12_RESOURCE_DESC desc = destination->GetDesc();
+    TextureCopy copy = {};
+    UINT rowCount = 0;
+    UINT64 rowSize = 0;
+    UINT64 totalSize = 0;
+    m_device->GetCopyableFootprints(&desc, subresource, 1, 0, &copy.footprint, &rowCount, &rowSize, &totalSize);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    RecyclePages();
+
+    // 暂存区要按纹理数据的放置对齐，每行按 footprint 的 RowPitch 排列
+    uint64_t stagingOffset = 0;
+    copy.stagingPage = AllocateStaging(totalSize, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, stagingOffset);
+    copy.footprint.Offset = stagingOffset;
+    copy.destination = destination;
+    copy.subresource = subresource;
+
+    uint8_t* target = m_openPages[copy.stagingPage].cpuAddress + stagingOffset;
+    const uint8_t* source = static_cast<const uint8_t*>(data);
+    for (UINT slice = 0; slice < copy.footprint.Footprint.Depth; slice++) {
+        for (UINT row = 0; row < rowCount; row++) {
+            const size_t sourceRow = static_cast<size_t>(slice) * rowCount + row;
+            memcpy(target + sourceRow * copy.footprint.Footprint.RowPitch, source + sourceRow * rowPitch, static_cast<size_t>(rowSize));
+        }
+    }
+    m_textureCopies.push_back(copy);
+
+    return TrackUpload(destination, totalSize);
+}
+
+void UploadEngine::Flush()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FlushLocked();
+}
+
+void UploadEngine::FlushLocked()
+{
+    if (m_bufferCopies.GetPendingCount() == 0 && m_textureCopies.empty()) {
+        return;
+    }
+
+    CommandContext context = m_pool.Acquire(D3D12_COMMAND_LIST_TYPE_COPY);
+
+    // 缓冲区复制按目标排序，按这个顺序写进暂存页并合并
+    OpenPageAllocator allocator(*this);
+    for (const StagingCopy& copy : m_bufferCopies.Build(allocator)) {
+        context.list->CopyBufferRegion(
+            reinterpret_cast<ID3D12Resource*>(copy.destination), copy.destinationOffset,
+            m_openPages[copy.stagingPage].resource.Get(), copy.stagingOffset, copy.size);
+        m_stats.copies++;
+    }
+    m_bufferCopies.Clear();
+
+    // 纹理复制每个子资源一次，同样按目标排序
+    std::stable_sort(m_textureCopies.begin(), m_textureCopies.end(), [](const TextureCopy& a, const TextureCopy& b) {
+        return a.destination != b.destination ? a.destination < b.destination : a.subresource < b.subresource;
+    });
+    for (const TextureCopy& copy : m_textureCopies) {
+        D3D12_TEXTURE_COPY_LOCATION destination = {};
+        destination.pResource = copy.destination;
+        destination.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+        destination.SubresourceIndex = copy.subresource;
+
+        D3D12_TEXTURE_COPY_LOCATION source = {};
+        source.pResource = m_openPages[copy.stagingPage].resource.Get();
+        source.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+        source.PlacedFootprint = copy.footprint;
+
+        context.list->CopyTextureRegion(&destination, 0, 0, 0, &source, nullptr);
+        m_stats.copies++;
+    }
+    m_textureCopies.clear();
+
+    if (FAILED(context.list->Close())) {
+        throw std::runtime_error("Failed to close upload command list");
+    }
+    ID3D12CommandList* lists[] = { context.list.Get() };
+    const GpuSyncPoint point = m_scheduler.Submit(GpuQueue::Copy, lists, _countof(lists));
+    m_pool.Release(context, point.value);
+
+    for (StagingPage& page : m_openPages) {
+        if (page.size != STAGING_PAGE_SIZE) {
+            // 超大上传用的专用页不复用，复制完成后释放
+            m_releaseQueue.Release(page.resource, m_timeline, point.value);
+            continue;
+        }
+        page.fenceValue = point.value;
+        m_retiredPages.push_back(std::move(page));
+    }
+    m_openPages.clear();
+
+    m_submitted.push_back({ m_currentBatch, point.value });
+    m_completion.Request(point.value);
+    m_currentBatch++;
+    m_stats.batches++;
+}
+
+uint64_t UploadEngine::GetFenceValue(uint64_t batch) const
+{
+    if (batch <= m_completedBatch) {
+        return m_completedFenceValue; // 已经完成，用最近完成的批次的值
+    }
+    for (const Batch& submitted : m_submitted) {
+        if (submitted.id == batch) {
+            return submitted.fenceValue;
+        }
+    }
+    return 0;
+}
+
+void UploadEngine::UseResource(GpuQueue consumer, ID3D12Resource* resource)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_pendingResources.find(resource);
+    if (it == m_pendingResources.end()) {
+        return;
+    }
+
+    // 还在录制中的上传先提交，否则消费者没有可以等的值
+    if (it->second.batch == m_currentBatch) {
+        FlushLocked();
+    }
+    RecyclePages();
+    it = m_pendingResources.find(resource);
+    if (it == m_pendingResources.end()) {
+        return;
+    }
+
+    // 每个消费队列各自等一次；条目留到复制完成，别的队列第一次使用时同样要等
+    const uint32_t queueBit = 1u << static_cast<uint32_t>(consumer);
+    if ((it->second.waitedQueues & queueBit) == 0) {
+        m_scheduler.AddDependency(consumer, { GpuQueue::Copy, GetFenceValue(it->second.batch) });
+        it->second.waitedQueues |= queueBit;
+        m_stats.queueWaits++;
+    }
+}
+
+GpuSyncPoint UploadEngine::GetSyncPoint(const UploadTicket& ticket) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return { GpuQueue::Copy, GetFenceValue(ticket.batch) };
+}
+
+bool UploadEngine::IsComplete(const UploadTicket& ticket)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    RecyclePages();
+    return ticket.batch <= m_completedBatch;
+}
+
+void UploadEngine::Wait(const UploadTicket& ticket)
+{
+    uint64_t fenceValue = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (ticket.batch == m_currentBatch) {
+            FlushLocked();
+        }
+        fenceValue = GetFenceValue(ticket.batch);
+    }
+    m_timeline.WaitForValue(fenceValue);
+}
+
+UploadEngine::Stats UploadEngine::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
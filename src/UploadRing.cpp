@@ -0,0 +1,140 @@
+// UploadRing.cpp
+#include "UploadRing.h"
+#include "d3dx12.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+UploadRing::UploadRing(GpuMemoryTracker& memoryTracker, IGpuTimeline& timeline, uint64_t bytesPerFrame, uint32_t frameCount)
+    : m_memoryTracker(memoryTracker), m_timeline(timeline), m_bytesPerFrame(bytesPerFrame)
+{
+    if (frameCount == 0 || bytesPerFrame == 0) {
+        throw std::invalid_argument("UploadRing needs at least one non-empty partition");
+    }
+
+    // 分区起点按常量缓冲区的对齐要求排列
+    m_bytesPerFrame = (bytesPerFrame + D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1) &
+        ~static_cast<uint64_t>(D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT - 1);
+    m_partitions.resize(frameCount);
+
+    HRESULT hr = m_memoryTracker.CreateCommittedResource(
+        GpuMemoryCategory::Upload,
+        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+        D3D12_HEAP_FLAG_NONE,
+        &CD3DX12_RESOURCE_DESC::Buffer(m_bytesPerFrame * frameCount),
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(&m_buffer)
+    );
+    if (FAILED(hr)) {
+        throw std::runtime_error("Failed to create upload ring buffer");
+    }
+
+    // 一直映射到析构，CPU 只写不读
+    D3D12_RANGE readRange = { 0, 0 };
+    void* cpuAddress = nullptr;
+    if (FAILED(m_buffer->Map(0, &readRange, &cpuAddress))) {
+        throw std::runtime_error("Failed to map upload ring buffer");
+    }
+    m_cpuBase = static_cast<uint8_t*>(cpuAddress);
+    m_gpuBase = m_buffer->GetGPUVirtualAddress();
+}
+
+UploadRing::~UploadRing()
+{
+    // 分区里的数据可能还在被 GPU 读取
+    for (const Partition& partition : m_partitions) {
+        m_timeline.WaitForValue(partition.fenceValue);
+    }
+    m_buffer->Unmap(0, nullptr);
+}
+
+void UploadRing::BeginFrame()
+{
+    m_current = (m_current + 1) % static_cast<uint32_t>(m_partitions.size());
+    Partition& partition = m_partitions[m_current];
+
+    // 帧环通常已经等过这个值，这里不会阻塞
+    m_timeline.WaitForValue(partition.fenceValue);
+    partition.overflow.clear();
+
+    m_partitionBase = m_current * m_bytesPerFrame;
+    m_offset.store(0, std::memory_order_relaxed);
+}
+
+void UploadRing::EndFrame(uint64_t fenceValue)
+{
+    m_partitions[m_current].fenceValue = fenceValue;
+
+    std::lock_guard<std::mutex> lock(m_overflowMutex);
+    m_stats.peakBytes = std::max(m_stats.peakBytes, std::min(m_offset.load(std::memory_order_relaxed), m_bytesPerFrame));
+}
+
+UploadAllocation UploadRing::Allocate(uint64_t size, uint64_t alignment)
+{
+    // 只移动指针；并发分配用 CAS 保证对齐后的区间互不重叠
+    uint64_t offset = m_offset.load(std::memory_order_relaxed);
+    uint64_t aligned = 0;
+    do {
+        aligned = (offset + alignment - 1) & ~(alignment - 1);
+        if (aligned + size > m_bytesPerFrame) {
+            return AllocateOverflow(size);
+        }
+    } while (!m_offset.compare_exchange_weak(offset, aligned + size, std::memory_order_relaxed));
+
+    UploadAllocation allocation;
+    allocation.offset = m_partitionBase + aligned;
+    allocation.cpuAddress = m_cpuBase + allocation.offset;
+    allocation.gpuAddress = m_gpuBase + allocation.offset;
+    allocation.resource = m_buffer.Get();
+    return allocation;
+}
+
+UploadAllocation UploadRing::AllocateAndCopy(const void* data, uint64_t size, uint64_t alignment)
+{
+    UploadAllocation allocation = Allocate(size, alignment);
+    memcpy(allocation.cpuAddress, data, static_cast<size_t>(size));
+    return allocation;
+}
+
+UploadAllocation UploadRing::AllocateOverflow(uint64_t size)
+{
+    Microsoft::WRL::ComPtr<ID3D12Resource> buffer;
+    HRESULT hr = m_memoryTracker.CreateCommittedResource(
+        GpuMemoryCategory::Upload,
+        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+        D3D12_HEAP_FLAG_NONE,
+        &CD3DX12_RESOURCE_DESC::Buffer(size),
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(&buffer)
+    );
+    if (FAILED(hr)) {
+        throw std::runtime_error("Failed to create upload ring overflow buffer");
+    }
+
+    // 溢出缓冲区和所在分区一起回收，回收时直接释放，不用 Unmap
+    D3D12_RANGE readRange = { 0, 0 };
+    void* cpuAddress = nullptr;
+    if (FAILED(buffer->Map(0, &readRange, &cpuAddress))) {
+        throw std::runtime_error("Failed to map upload ring overflow buffer");
+    }
+
+    UploadAllocation allocation;
+    allocation.cpuAddress = cpuAddress;
+    allocation.gpuAddress = buffer->GetGPUVirtualAddress();
+    allocation.resource = buffer.Get();
+    allocation.offset = 0;
+
+    std::lock_guard<std::mutex> lock(m_overflowMutex);
+    m_partitions[m_current].overflow.push_back(buffer);
+    m_stats.overflowCount++;
+    m_stats.overflowBytes += size;
+    return allocation;
+}
+
+UploadRing::Stats UploadRing::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_overflowMutex);
+    return m_stats;
+}
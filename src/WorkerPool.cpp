@@ -0,0 +1,109 @@
+// WorkerPool.cpp
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(unsigned threadCount)
+{
+    if (threadCount == 0) {
+        unsigned hardwareThreads = std::thread::hardware_concurrency();
+        threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    m_threads.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; i++) {
+        m_threads.emplace_back(&WorkerPool::WorkerMain, this);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void WorkerPool::ParallelFor(size_t count, FunctionRef<void(size_t)> fn)
+{
+    if (count == 0) {
+        return;
+    }
+
+    // 只有一项或没有工作线程时直接在调用线程上执行
+    if (count == 1 || m_threads.empty()) {
+        for (size_t i = 0; i < count; i++) {
+            fn(i);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> submitLock(m_submitMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &fn;
+        m_jobCount = count;
+        m_nextIndex.store(0);
+        m_error = nullptr;
+        m_checkedIn = 0;
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    RunJob();
+
+    // 等所有工作线程都处理完这一代任务，保证返回后没有线程再引用 fn
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_checkedIn == m_threads.size(); });
+        m_job = nullptr;
+        error = m_error;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void WorkerPool::RunJob()
+{
+    for (;;) {
+        const size_t index = m_nextIndex.fetch_add(1);
+        if (index >= m_jobCount) {
+            return;
+        }
+        try {
+            (*m_job)(index);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error) {
+                m_error = std::current_exception();
+            }
+        }
+    }
+}
+
+void WorkerPool::WorkerMain()
+{
+    uint64_t seenGeneration = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stopping || m_generation != seenGeneration; });
+            if (m_stopping) {
+                return;
+            }
+            seenGeneration = m_generation;
+        }
+
+        RunJob();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_checkedIn++;
+        }
+        m_done.notify_one();
+    }
+}
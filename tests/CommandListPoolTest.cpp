@@ -0,0 +1,137 @@
+// CommandListPoolTest.cpp
+#include "CommandListPool.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "FakeD3D12.h"
+#include "MockGpuTimeline.h"
+#include "TestCommon.h"
+
+// 替换全局 operator new，统计测试期间的堆分配次数
+namespace {
+std::atomic<uint64_t> g_globalAllocations{ 0 };
+}
+
+void* operator new(size_t size)
+{
+    g_globalAllocations++;
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace {
+const uint32_t LISTS_PER_FRAME = 8;
+
+Microsoft::WRL::ComPtr<ID3D12Device> CreateFakeDevice()
+{
+    Microsoft::WRL::ComPtr<ID3D12Device> device;
+    device.Attach(new FakeDevice());
+    return device;
+}
+
+void TestAllocatorWaitsForFence()
+{
+    Microsoft::WRL::ComPtr<ID3D12Device> device = CreateFakeDevice();
+    MockGpuTimeline timeline;
+    CommandListPool pool(device.Get());
+    pool.SetTimeline(D3D12_COMMAND_LIST_TYPE_DIRECT, &timeline);
+
+    CommandContext first = pool.Acquire(D3D12_COMMAND_LIST_TYPE_DIRECT);
+    ID3D12CommandAllocator* firstAllocator = first.allocator.Get();
+    ID3D12GraphicsCommandList* firstList = first.list.Get();
+    pool.Release(first, timeline.Signal());
+
+    // 命令列表马上可以复用，分配器还在 GPU 上，要新建一个
+    CommandContext second = pool.Acquire(D3D12_COMMAND_LIST_TYPE_DIRECT);
+    CHECK(second.list.Get() == firstList);
+    CHECK(second.allocator.Get() != firstAllocator);
+    CHECK(pool.GetAllocatorCount() == 2);
+    CHECK(pool.GetCommandListCount() == 1);
+    pool.Release(second, timeline.Signal());
+
+    // GPU 完成第一次提交后回收它的分配器
+    timeline.Complete(1);
+    CommandContext third = pool.Acquire(D3D12_COMMAND_LIST_TYPE_DIRECT);
+    CHECK(third.allocator.Get() == firstAllocator);
+    CHECK(pool.GetAllocatorCount() == 2);
+    pool.Release(third, timeline.Signal());
+}
+
+void TestNoAllocationsAfterWarmUp()
+{
+    // 每帧 LISTS_PER_FRAME 个列表，GPU 落后两帧：分配器在 fence 队列里排队，
+    // 队列和空闲列表的容量稳定之后，每帧的 Acquire/Release 不再分配内存
+    Microsoft::WRL::ComPtr<ID3D12Device> device = CreateFakeDevice();
+    MockGpuTimeline timeline;
+    CommandListPool pool(device.Get());
+    pool.SetTimeline(D3D12_COMMAND_LIST_TYPE_DIRECT, &timeline);
+    CommandContext contexts[LISTS_PER_FRAME];
+
+    auto runFrame = [&]() {
+        for (CommandContext& context : contexts) {
+            context = pool.Acquire(D3D12_COMMAND_LIST_TYPE_DIRECT);
+            context.list->Close();
+        }
+        const uint64_t fenceValue = timeline.Signal();
+        for (CommandContext& context : contexts) {
+            pool.Release(context, fenceValue);
+        }
+        timeline.Complete(fenceValue > 2 ? fenceValue - 2 : 0);
+    };
+
+    for (int frame = 0; frame < 10; frame++) {
+        runFrame();
+    }
+    const size_t allocators = pool.GetAllocatorCount();
+    CHECK(allocators == 3 * LISTS_PER_FRAME);
+    CHECK(pool.GetCommandListCount() == LISTS_PER_FRAME);
+
+    const uint64_t before = g_globalAllocations.load();
+    for (int frame = 0; frame < 1000; frame++) {
+        runFrame();
+    }
+    CHECK(g_globalAllocations.load() == before);
+    CHECK(pool.GetAllocatorCount() == allocators);
+}
+
+void TestRingQueue()
+{
+    RingQueue<int> queue(2);
+    for (int i = 0; i < 5; i++) {
+        queue.push_back(i);
+    }
+    CHECK(queue.size() == 5 && queue.capacity() == 8);
+    CHECK(queue.front() == 0 && queue.back() == 4);
+
+    // 读写位置绕过存储末尾之后顺序不变，也不扩容
+    for (int i = 5; i < 100; i++) {
+        CHECK(queue.front() == i - 5);
+        queue.pop_front();
+        queue.push_back(i);
+        CHECK(queue.back() == i);
+    }
+    CHECK(queue.capacity() == 8);
+    queue.clear();
+    CHECK(queue.empty());
+}
+}
+
+int main()
+{
+    RUN_TEST(TestAllocatorWaitsForFence);
+    RUN_TEST(TestNoAllocationsAfterWarmUp);
+    RUN_TEST(TestRingQueue);
+    return FinishTests();
+}
@@ -0,0 +1,190 @@
+// CommandStreamTest.cpp
+#include "CommandStream.h"
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include "TestCommon.h"
+
+namespace {
+// 在 NullCommandBackend 的计数之外保存每个回放出来的包，按顺序检查解码后的参数
+struct RecordingBackend : NullCommandBackend {
+    std::vector<std::vector<uint8_t>> packets;
+
+    template <typename T>
+    void Execute(const T& cmd)
+    {
+        NullCommandBackend::Execute(cmd);
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&cmd);
+        packets.emplace_back(bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    T Get(size_t index) const
+    {
+        T cmd;
+        std::memcpy(&cmd, packets[index].data(), sizeof(T));
+        return cmd;
+    }
+};
+
+const float CLEAR_COLOR[4] = { 0.0f, 0.2f, 0.4f, 1.0f };
+
+// 每种命令录一条
+void RecordEveryOp(CommandStream& stream)
+{
+    const uint32_t constants[2] = { 7, 9 };
+    stream.SetPipeline(0x1000);
+    stream.SetRootSignature(0x2000);
+    stream.SetDescriptorHeaps(0x3000, 0x3100);
+    stream.SetRootDescriptorTable(2, 0x4000);
+    stream.SetRootConstants(1, 2, constants, 3);
+    stream.SetPrimitiveTopology(4);
+    stream.SetVertexBuffer(1, 0x5000, 256, 28);
+    stream.SetIndexBuffer(0x6000, 128, 57);
+    stream.SetViewport(1.0f, 2.0f, 640.0f, 480.0f, 0.25f, 0.75f);
+    stream.SetScissor(3, 4, 640, 480);
+    stream.SetRenderTarget(0x7000, 0x7100);
+    stream.ClearRenderTarget(0x7000, CLEAR_COLOR);
+    stream.Barrier(0x8000, 4, 1, 2);
+    stream.Draw(3, 2, 1, 5);
+    stream.DrawIndexed(6, 1, 12, -4, 2);
+}
+
+const size_t OP_COUNT = 15;
+
+void TestReplayDecodesEveryOp()
+{
+    CommandStream stream;
+    RecordEveryOp(stream);
+    CHECK(stream.GetCommandCount() == OP_COUNT);
+
+    RecordingBackend backend;
+    ReplayCommandStream(stream, backend);
+    CHECK(backend.commandCount == OP_COUNT);
+    CHECK(backend.drawCount == 2);
+    CHECK(backend.packets.size() == OP_COUNT);
+
+    CHECK(backend.Get<CmdSetPipeline>(0).header.op == CommandOp::SetPipeline);
+    CHECK(backend.Get<CmdSetPipeline>(0).header.size == sizeof(CmdSetPipeline));
+    CHECK(backend.Get<CmdSetPipeline>(0).pipeline == 0x1000);
+    CHECK(backend.Get<CmdSetRootSignature>(1).rootSignature == 0x2000);
+
+    const CmdSetDescriptorHeaps heaps = backend.Get<CmdSetDescriptorHeaps>(2);
+    CHECK(heaps.resourceHeap == 0x3000 && heaps.samplerHeap == 0x3100);
+
+    const CmdSetRootDescriptorTable table = backend.Get<CmdSetRootDescriptorTable>(3);
+    CHECK(table.rootIndex == 2 && table.gpuHandle == 0x4000);
+
+    const CmdSetRootConstants constants = backend.Get<CmdSetRootConstants>(4);
+    CHECK(constants.rootIndex == 1 && constants.count == 2 && constants.destOffset == 3);
+    CHECK(constants.values[0] == 7 && constants.values[1] == 9);
+    CHECK(constants.values[2] == 0 && constants.values[3] == 0);
+
+    CHECK(backend.Get<CmdSetPrimitiveTopology>(5).topology == 4);
+
+    const CmdSetVertexBuffer vertexBuffer = backend.Get<CmdSetVertexBuffer>(6);
+    CHECK(vertexBuffer.slot == 1 && vertexBuffer.gpuAddress == 0x5000);
+    CHECK(vertexBuffer.sizeInBytes == 256 && vertexBuffer.stride == 28);
+
+    const CmdSetIndexBuffer indexBuffer = backend.Get<CmdSetIndexBuffer>(7);
+    CHECK(indexBuffer.gpuAddress == 0x6000 && indexBuffer.sizeInBytes == 128 && indexBuffer.format == 57);
+
+    const CmdSetViewport viewport = backend.Get<CmdSetViewport>(8);
+    CHECK(viewport.x == 1.0f && viewport.y == 2.0f && viewport.width == 640.0f && viewport.height == 480.0f);
+    CHECK(viewport.minDepth == 0.25f && viewport.maxDepth == 0.75f);
+
+    const CmdSetScissor scissor = backend.Get<CmdSetScissor>(9);
+    CHECK(scissor.left == 3 && scissor.top == 4 && scissor.right == 640 && scissor.bottom == 480);
+
+    const CmdSetRenderTarget renderTarget = backend.Get<CmdSetRenderTarget>(10);
+    CHECK(renderTarget.rtv == 0x7000 && renderTarget.dsv == 0x7100);
+
+    const CmdClearRenderTarget clear = backend.Get<CmdClearRenderTarget>(11);
+    CHECK(clear.rtv == 0x7000 && std::memcmp(clear.color, CLEAR_COLOR, sizeof(CLEAR_COLOR)) == 0);
+
+    const CmdBarrier barrier = backend.Get<CmdBarrier>(12);
+    CHECK(barrier.resource == 0x8000 && barrier.stateBefore == 4 && barrier.stateAfter == 1 && barrier.subresource == 2);
+
+    const CmdDraw draw = backend.Get<CmdDraw>(13);
+    CHECK(draw.vertexCount == 3 && draw.instanceCount == 2 && draw.startVertex == 1 && draw.startInstance == 5);
+
+    const CmdDrawIndexed drawIndexed = backend.Get<CmdDrawIndexed>(14);
+    CHECK(drawIndexed.indexCount == 6 && drawIndexed.instanceCount == 1 && drawIndexed.startIndex == 12);
+    CHECK(drawIndexed.baseVertex == -4 && drawIndexed.startInstance == 2);
+}
+
+void TestResetReusesBuffer()
+{
+    CommandStream stream(64);
+    RecordEveryOp(stream);
+    const size_t size = stream.GetSize();
+    const uint8_t* data = stream.GetData();
+
+    // Reset 之后再录同样的内容：不再扩容，大小和命令数与第一次相同
+    stream.Reset();
+    CHECK(stream.GetSize() == 0 && stream.GetCommandCount() == 0);
+    RecordEveryOp(stream);
+    CHECK(stream.GetData() == data);
+    CHECK(stream.GetSize() == size);
+    CHECK(stream.GetCommandCount() == OP_COUNT);
+
+    NullCommandBackend backend;
+    ReplayCommandStream(stream, backend);
+    CHECK(backend.commandCount == OP_COUNT);
+}
+
+void TestReusedBufferRecordsIdenticalBytes()
+{
+    // 先用全 1 的根常量把缓冲区写满，回绕后录制的包的填充字段必须是 0，
+    // 和新的命令流逐字节相同
+    CommandStream reused;
+    const uint32_t ones[4] = { ~0u, ~0u, ~0u, ~0u };
+    for (int i = 0; i < 64; i++) {
+        reused.SetRootConstants(~0u, 4, ones, ~0u);
+    }
+    reused.Reset();
+    RecordEveryOp(reused);
+
+    CommandStream fresh;
+    RecordEveryOp(fresh);
+    CHECK(reused.GetSize() == fresh.GetSize());
+    CHECK(std::memcmp(reused.GetData(), fresh.GetData(), fresh.GetSize()) == 0);
+}
+
+void TestInvalidCommands()
+{
+    CommandStream stream;
+    const uint32_t values[5] = {};
+    bool threw = false;
+    try {
+        stream.SetRootConstants(0, 5, values);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(stream.GetCommandCount() == 0);
+
+    // 损坏的操作码在回放时报错，不会被静默跳过
+    stream.Draw(3);
+    CommandHeader* header = reinterpret_cast<CommandHeader*>(const_cast<uint8_t*>(stream.GetData()));
+    header->op = static_cast<CommandOp>(0xffff);
+    NullCommandBackend backend;
+    threw = false;
+    try {
+        ReplayCommandStream(stream, backend);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(backend.commandCount == 0);
+}
+}
+
+int main()
+{
+    RUN_TEST(TestReplayDecodesEveryOp);
+    RUN_TEST(TestResetReusesBuffer);
+    RUN_TEST(TestReusedBufferRecordsIdenticalBytes);
+    RUN_TEST(TestInvalidCommands);
+    return FinishTests();
+}
@@ -0,0 +1,87 @@
+// CompletionTrackerTest.cpp
+#include "CompletionTracker.h"
+#include "MockGpuTimeline.h"
+#include "TestCommon.h"
+
+namespace {
+void TestAdvancesOnCallback()
+{
+    MockGpuTimeline timeline;
+    CompletionTracker tracker(timeline);
+    const uint64_t first = timeline.Signal();
+    const uint64_t second = timeline.Signal();
+    tracker.Request(first);
+    tracker.Request(second);
+
+    // 每个请求的值挂一个回调，完成值只由回调推进
+    CHECK(timeline.GetPendingCallbackCount() == 2);
+    CHECK(tracker.GetCompletedValue() == 0);
+
+    timeline.Complete(first);
+    CHECK(tracker.GetCompletedValue() == first);
+    CHECK(timeline.GetPendingCallbackCount() == 1);
+
+    timeline.Complete(second);
+    CHECK(tracker.GetCompletedValue() == second);
+    CHECK(timeline.GetPendingCallbackCount() == 0);
+}
+
+void TestUnsignaledValueArmsAfterSignal()
+{
+    // 请求下一次信号的值（还没发出）：发出之前不挂回调
+    MockGpuTimeline timeline;
+    CompletionTracker tracker(timeline);
+    tracker.Request(timeline.GetLastSignaledValue() + 1);
+    CHECK(timeline.GetPendingCallbackCount() == 0);
+
+    const uint64_t value = timeline.Signal();
+    CHECK(tracker.GetCompletedValue() == 0);
+    CHECK(timeline.GetPendingCallbackCount() == 1);
+    timeline.Complete(value);
+    CHECK(tracker.GetCompletedValue() == value);
+}
+
+void TestLowerRequestIsCovered()
+{
+    // 不大于已经请求过的值的请求不再挂回调，较大的值完成时一起完成
+    MockGpuTimeline timeline;
+    CompletionTracker tracker(timeline);
+    timeline.Signal();
+    const uint64_t last = timeline.Signal();
+    tracker.Request(last);
+    tracker.Request(1);
+    tracker.Request(last);
+    CHECK(timeline.GetPendingCallbackCount() == 1);
+    timeline.Complete(last);
+    CHECK(tracker.GetCompletedValue() == last);
+}
+
+void TestDestructorWaitsForPendingCallbacks()
+{
+    // 析构时等 GPU 执行到挂起的值，回调在析构返回之前全部执行，不会留下指向已析构对象的回调
+    MockGpuTimeline timeline;
+    {
+        CompletionTracker tracker(timeline);
+        tracker.Request(timeline.Signal());
+        tracker.Request(timeline.Signal());
+        tracker.Request(timeline.GetLastSignaledValue() + 1);
+        CHECK(timeline.GetPendingCallbackCount() == 2);
+    }
+    CHECK(timeline.GetWaitCount() == 1);
+    CHECK(timeline.GetLastWaitValue() == 2);
+    CHECK(timeline.GetPendingCallbackCount() == 0);
+
+    // 没有发过信号的值不挂回调，之后发出也不会有回调
+    timeline.Signal();
+    CHECK(timeline.GetPendingCallbackCount() == 0);
+}
+}
+
+int main()
+{
+    RUN_TEST(TestAdvancesOnCallback);
+    RUN_TEST(TestUnsignaledValueArmsAfterSignal);
+    RUN_TEST(TestLowerRequestIsCovered);
+    RUN_TEST(TestDestructorWaitsForPendingCallbacks);
+    return FinishTests();
+}
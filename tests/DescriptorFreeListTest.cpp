@@ -0,0 +1,159 @@
+// DescriptorFreeListTest.cpp
+#include "DescriptorFreeList.h"
+#include <stdexcept>
+#include <vector>
+#include "TestCommon.h"
+
+namespace {
+const uint32_t PAGE_SIZE = 4;
+
+void TestAddPageOrdering()
+{
+    DescriptorFreeList list(PAGE_SIZE);
+    CHECK(list.AddPage() == 0);
+
+    // 一页之内按下标从低到高分配
+    for (uint32_t i = 0; i < PAGE_SIZE; i++) {
+        CHECK(list.Allocate() == i);
+    }
+    CHECK(list.Allocate() == DescriptorFreeList::INVALID_INDEX);
+
+    // 新页接在全局下标后面，页号和页内位置可以从下标算回来
+    CHECK(list.AddPage() == 1);
+    const uint32_t index = list.Allocate();
+    CHECK(index == PAGE_SIZE);
+    CHECK(list.GetPage(index) == 1 && list.GetSlot(index) == 0);
+    CHECK(list.GetPage(PAGE_SIZE * 2 - 1) == 1 && list.GetSlot(PAGE_SIZE * 2 - 1) == PAGE_SIZE - 1);
+
+    // 新页的槽位接在链表头上：旧页还有空闲槽位时也先分配新页的
+    DescriptorFreeList twoPages(PAGE_SIZE);
+    twoPages.AddPage();
+    twoPages.AddPage();
+    for (uint32_t i = 0; i < PAGE_SIZE; i++) {
+        CHECK(twoPages.Allocate() == PAGE_SIZE + i);
+    }
+    CHECK(twoPages.Allocate() == 0);
+}
+
+void TestFreeReusesMostRecent()
+{
+    // 释放的槽位放回链表头，下一次分配立即拿回来，不扫描其它槽位
+    DescriptorFreeList list(PAGE_SIZE);
+    list.AddPage();
+    list.AddPage();
+    std::vector<uint32_t> indices;
+    for (int i = 0; i < 6; i++) {
+        indices.push_back(list.Allocate());
+    }
+
+    list.Free(indices[1]);
+    list.Free(indices[4]);
+    CHECK(!list.IsAllocated(indices[1]) && !list.IsAllocated(indices[4]));
+    CHECK(list.Allocate() == indices[4]);
+    CHECK(list.Allocate() == indices[1]);
+    CHECK(list.IsAllocated(indices[1]) && list.IsAllocated(indices[4]));
+
+    // 分配和释放交替进行时一直复用同一个槽位
+    const uint32_t reused = list.Allocate();
+    list.Free(reused);
+    for (int i = 0; i < 100; i++) {
+        const uint32_t index = list.Allocate();
+        CHECK(index == reused);
+        list.Free(index);
+    }
+}
+
+void TestDoubleFree()
+{
+    DescriptorFreeList list(PAGE_SIZE);
+    list.AddPage();
+    const uint32_t index = list.Allocate();
+    list.Free(index);
+
+    bool threw = false;
+    try {
+        list.Free(index);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // 从没分配过的槽位和超出范围的下标同样报错，链表不被破坏
+    threw = false;
+    try {
+        list.Free(PAGE_SIZE * 8);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+    CHECK(list.GetStats().allocated == 0);
+    for (uint32_t i = 0; i < PAGE_SIZE; i++) {
+        CHECK(list.Allocate() != DescriptorFreeList::INVALID_INDEX);
+    }
+    CHECK(list.Allocate() == DescriptorFreeList::INVALID_INDEX);
+}
+
+void TestExhaustion()
+{
+    // 没有页时直接返回 INVALID_INDEX；用完之后同样返回，AddPage 之后恢复
+    DescriptorFreeList list(PAGE_SIZE);
+    CHECK(list.Allocate() == DescriptorFreeList::INVALID_INDEX);
+    list.AddPage();
+    for (uint32_t i = 0; i < PAGE_SIZE; i++) {
+        list.Allocate();
+    }
+    CHECK(list.Allocate() == DescriptorFreeList::INVALID_INDEX);
+    CHECK(list.Allocate() == DescriptorFreeList::INVALID_INDEX);
+    CHECK(list.GetStats().allocated == PAGE_SIZE);
+
+    list.AddPage();
+    CHECK(list.Allocate() == PAGE_SIZE);
+}
+
+void TestStats()
+{
+    DescriptorFreeList list(PAGE_SIZE);
+    list.AddPage();
+    list.AddPage();
+    CHECK(list.GetStats().pageCount == 2);
+    CHECK(list.GetStats().capacity == PAGE_SIZE * 2);
+    CHECK(list.GetStats().allocated == 0 && list.GetStats().peakAllocated == 0);
+
+    std::vector<uint32_t> indices;
+    for (int i = 0; i < 5; i++) {
+        indices.push_back(list.Allocate());
+    }
+    for (int i = 0; i < 3; i++) {
+        list.Free(indices[i]);
+    }
+    // 峰值记住最多同时分配的个数，释放之后不回落
+    CHECK(list.GetStats().allocated == 2);
+    CHECK(list.GetStats().peakAllocated == 5);
+
+    list.Allocate();
+    CHECK(list.GetStats().allocated == 3);
+    CHECK(list.GetStats().peakAllocated == 5);
+}
+
+void TestInvalidPageSize()
+{
+    bool threw = false;
+    try {
+        DescriptorFreeList list(0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+}
+
+int main()
+{
+    RUN_TEST(TestAddPageOrdering);
+    RUN_TEST(TestFreeReusesMostRecent);
+    RUN_TEST(TestDoubleFree);
+    RUN_TEST(TestExhaustion);
+    RUN_TEST(TestStats);
+    RUN_TEST(TestInvalidPageSize);
+    return FinishTests();
+}
@@ -0,0 +1,133 @@
+// DescriptorRingTest.cpp
+#include "DescriptorRing.h"
+#include <stdexcept>
+#include "TestCommon.h"
+
+namespace {
+const uint32_t CAPACITY = 16;
+
+void TestWrapSkipsTail()
+{
+    DescriptorRing ring(CAPACITY);
+    CHECK(ring.Allocate(10) == 0);
+    ring.EndFrame(1);
+    CHECK(ring.Allocate(4) == 10);
+    ring.EndFrame(2);
+    ring.Reclaim(1);
+    CHECK(ring.GetUsed() == 4);
+
+    // 环尾只剩 2 个放不下 4 个：跳过环尾从头开始，跳过的部分算作已用
+    CHECK(ring.Allocate(4) == 0);
+    CHECK(ring.GetUsed() == 10);
+    ring.EndFrame(3);
+
+    // 跳过的环尾随切出它的那一帧（第 3 帧）回收，而不是随第 2 帧
+    ring.Reclaim(2);
+    CHECK(ring.GetUsed() == 6);
+    CHECK(ring.GetOldestFenceValue() == 3);
+    ring.Reclaim(3);
+    CHECK(ring.GetUsed() == 0);
+    CHECK(ring.GetOldestFenceValue() == 0);
+}
+
+void TestFullReturnsInvalid()
+{
+    DescriptorRing ring(CAPACITY);
+    CHECK(ring.Allocate(0) == DescriptorRing::INVALID_OFFSET);
+    CHECK(ring.Allocate(CAPACITY + 1) == DescriptorRing::INVALID_OFFSET);
+
+    // 整个环切满之后写位置回到 0，和尾重合，但不能当成空环再分配
+    CHECK(ring.Allocate(CAPACITY) == 0);
+    CHECK(ring.GetUsed() == CAPACITY);
+    CHECK(ring.Allocate(1) == DescriptorRing::INVALID_OFFSET);
+    ring.EndFrame(1);
+    ring.Reclaim(0);
+    CHECK(ring.Allocate(1) == DescriptorRing::INVALID_OFFSET);
+
+    // 写位置追上尾之前剩下的空隙不够时同样失败，不会覆盖还没回收的帧
+    ring.Reclaim(1);
+    CHECK(ring.Allocate(12) == 0);
+    ring.EndFrame(2);
+    CHECK(ring.Allocate(2) == 12);
+    ring.EndFrame(3);
+    ring.Reclaim(2);
+    CHECK(ring.Allocate(13) == DescriptorRing::INVALID_OFFSET);
+    CHECK(ring.Allocate(12) == 0);
+    CHECK(ring.Allocate(1) == DescriptorRing::INVALID_OFFSET);
+}
+
+void TestPartialReclaim()
+{
+    // 只回收 fence 已经完成的帧，按帧的顺序一帧一帧放回
+    DescriptorRing ring(CAPACITY);
+    for (uint64_t frame = 1; frame <= 3; frame++) {
+        CHECK(ring.Allocate(4) == (frame - 1) * 4);
+        ring.EndFrame(frame);
+    }
+    CHECK(ring.GetUsed() == 12);
+    CHECK(ring.GetOldestFenceValue() == 1);
+
+    ring.Reclaim(0);
+    CHECK(ring.GetUsed() == 12);
+    ring.Reclaim(2);
+    CHECK(ring.GetUsed() == 4);
+    CHECK(ring.GetOldestFenceValue() == 3);
+    ring.Reclaim(2);
+    CHECK(ring.GetUsed() == 4);
+
+    // 回收的空间马上能用：环尾 4 个，加上绕回来的 8 个
+    CHECK(ring.Allocate(4) == 12);
+    CHECK(ring.Allocate(8) == 0);
+    CHECK(ring.Allocate(1) == DescriptorRing::INVALID_OFFSET);
+    ring.EndFrame(4);
+
+    ring.Reclaim(10);
+    CHECK(ring.GetUsed() == 0);
+    CHECK(ring.GetOldestFenceValue() == 0);
+}
+
+void TestResetWhenEmpty()
+{
+    // 全部回收之后从偏移 0 开始，不留在旧的写位置
+    DescriptorRing ring(CAPACITY);
+    CHECK(ring.Allocate(10) == 0);
+    ring.EndFrame(1);
+    ring.Reclaim(1);
+    CHECK(ring.Allocate(4) == 0);
+    CHECK(ring.Allocate(12) == 4);
+    CHECK(ring.GetUsed() == CAPACITY);
+
+    ring.EndFrame(2);
+    ring.Reclaim(2);
+    CHECK(ring.Allocate(6) == 0);
+    ring.EndFrame(3);
+
+    // 还有帧没回收时接着写位置分配，不回到 0
+    CHECK(ring.Allocate(2) == 6);
+    ring.EndFrame(4);
+    ring.Reclaim(3);
+    CHECK(ring.GetUsed() == 2);
+    CHECK(ring.Allocate(2) == 8);
+}
+
+void TestInvalidCapacity()
+{
+    bool threw = false;
+    try {
+        DescriptorRing ring(0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+}
+
+int main()
+{
+    RUN_TEST(TestWrapSkipsTail);
+    RUN_TEST(TestFullReturnsInvalid);
+    RUN_TEST(TestPartialReclaim);
+    RUN_TEST(TestResetWhenEmpty);
+    RUN_TEST(TestInvalidCapacity);
+    return FinishTests();
+}
@@ -0,0 +1,186 @@
+#pragma once
+#include <d3d12.h>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+// 基于 d3d12stub 的模拟 D3D12 对象，给无 GPU 的测试和基准用。
+// FakeUnknown 只实现引用计数，计数归零时删除自己；QueryInterface 不看 IID，总是返回自己。
+template <typename Interface>
+class FakeUnknown : public Interface {
+public:
+    virtual ~FakeUnknown() = default;
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID, void** object) override
+    {
+        AddRef();
+        *object = static_cast<Interface*>(this);
+        return S_OK;
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override { return ++m_refCount; }
+
+    ULONG STDMETHODCALLTYPE Release() override
+    {
+        const ULONG count = --m_refCount;
+        if (count == 0) {
+            delete this;
+        }
+        return count;
+    }
+
+private:
+    std::atomic<ULONG> m_refCount{ 1 };
+};
+
+// D3D12 对象在 FakeUnknown 之上保存私有数据接口，和运行时一样在对象销毁时释放它们
+template <typename Interface>
+class FakeObject : public FakeUnknown<Interface> {
+public:
+    ~FakeObject() override
+    {
+        for (std::pair<GUID, IUnknown*>& entry : m_privateData) {
+            entry.second->Release();
+        }
+    }
+
+    // 同一个 GUID 再次设置时替换并释放旧的接口，data 为空时只删除
+    HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID guid, const IUnknown* data) override
+    {
+        IUnknown* added = const_cast<IUnknown*>(data);
+        if (added) {
+            added->AddRef();
+        }
+        for (size_t i = 0; i < m_privateData.size(); i++) {
+            if (m_privateData[i].first == guid) {
+                IUnknown* previous = m_privateData[i].second;
+                m_privateData.erase(m_privateData.begin() + i);
+                previous->Release();
+                break;
+            }
+        }
+        if (added) {
+            m_privateData.emplace_back(guid, added);
+        }
+        return S_OK;
+    }
+
+private:
+    std::vector<std::pair<GUID, IUnknown*>> m_privateData;
+};
+
+// 不碰 GPU 的 PSO 对象，只有引用计数
+class FakePipelineState final : public FakeObject<ID3D12PipelineState> {
+};
+
+class FakeCommandAllocator final : public FakeObject<ID3D12CommandAllocator> {
+public:
+    HRESULT STDMETHODCALLTYPE Reset() override { return S_OK; }
+};
+
+// 没有内存的资源和堆，只用作屏障、跟踪表里的键和显存记账的对象
+class FakeResource final : public FakeObject<ID3D12Resource> {
+};
+
+class FakeHeap final : public FakeObject<ID3D12Heap> {
+};
+
+// 只把命令记到自己的数组里的命令列表；Reset 清空数组但保留容量，和驱动复用命令内存一样。
+// 屏障按 ResourceBarrier 调用分批另外保存，测试逐批比较
+class FakeGraphicsCommandList final : public FakeObject<ID3D12GraphicsCommandList> {
+public:
+    explicit FakeGraphicsCommandList(D3D12_COMMAND_LIST_TYPE type) : m_type(type) {}
+
+    D3D12_COMMAND_LIST_TYPE STDMETHODCALLTYPE GetType() override { return m_type; }
+    HRESULT STDMETHODCALLTYPE Close() override { return S_OK; }
+
+    HRESULT STDMETHODCALLTYPE Reset(ID3D12CommandAllocator*, ID3D12PipelineState*) override
+    {
+        m_commands.clear();
+        m_barrierBatches.clear();
+        return S_OK;
+    }
+
+    void STDMETHODCALLTYPE DrawInstanced(UINT vertexCount, UINT instanceCount, UINT startVertex, UINT startInstance) override
+    {
+        m_commands.insert(m_commands.end(), { 1u, vertexCount, instanceCount, startVertex, startInstance });
+    }
+
+    void STDMETHODCALLTYPE SetGraphicsRoot32BitConstants(UINT rootIndex, UINT count, const void* values, UINT destOffset) override
+    {
+        m_commands.insert(m_commands.end(), { 2u, rootIndex, count, destOffset });
+        const UINT* words = static_cast<const UINT*>(values);
+        m_commands.insert(m_commands.end(), words, words + count);
+    }
+
+    void STDMETHODCALLTYPE ResourceBarrier(UINT count, const D3D12_RESOURCE_BARRIER* barriers) override
+    {
+        m_barrierBatches.emplace_back(barriers, barriers + count);
+    }
+
+    const std::vector<UINT>& GetCommands() const { return m_commands; }
+    const std::vector<std::vector<D3D12_RESOURCE_BARRIER>>& GetBarrierBatches() const { return m_barrierBatches; }
+
+private:
+    D3D12_COMMAND_LIST_TYPE m_type;
+    std::vector<UINT> m_commands;
+    std::vector<std::vector<D3D12_RESOURCE_BARRIER>> m_barrierBatches;
+};
+
+// 创建上面这些模拟对象的设备，不能创建 PSO。
+// 资源的分配大小：缓冲区按宽度，纹理按每个像素 4 字节，对齐到 64KB
+class FakeDevice final : public FakeObject<ID3D12Device> {
+public:
+    HRESULT STDMETHODCALLTYPE CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE, REFIID, void** commandAllocator) override
+    {
+        *commandAllocator = static_cast<ID3D12CommandAllocator*>(new FakeCommandAllocator());
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE CreateCommandList(UINT, D3D12_COMMAND_LIST_TYPE type,
+        ID3D12CommandAllocator*, ID3D12PipelineState*, REFIID, void** commandList) override
+    {
+        *commandList = static_cast<ID3D12GraphicsCommandList*>(new FakeGraphicsCommandList(type));
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE CreateGraphicsPipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC*, REFIID, void** pipelineState) override
+    {
+        *pipelineState = nullptr;
+        return E_NOTIMPL;
+    }
+
+    D3D12_RESOURCE_ALLOCATION_INFO STDMETHODCALLTYPE GetResourceAllocationInfo(
+        UINT, UINT numResourceDescs, const D3D12_RESOURCE_DESC* resourceDescs) override
+    {
+        D3D12_RESOURCE_ALLOCATION_INFO info = { 0, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT };
+        for (UINT i = 0; i < numResourceDescs; i++) {
+            const D3D12_RESOURCE_DESC& desc = resourceDescs[i];
+            const UINT64 bytes = desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER
+                ? desc.Width
+                : desc.Width * desc.Height * desc.DepthOrArraySize * 4;
+            info.SizeInBytes += (bytes + info.Alignment - 1) / info.Alignment * info.Alignment;
+        }
+        return info;
+    }
+
+    HRESULT STDMETHODCALLTYPE CreateCommittedResource(const D3D12_HEAP_PROPERTIES*, D3D12_HEAP_FLAGS,
+        const D3D12_RESOURCE_DESC*, D3D12_RESOURCE_STATES, const D3D12_CLEAR_VALUE*, REFIID, void** resource) override
+    {
+        *resource = static_cast<ID3D12Resource*>(new FakeResource());
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE CreateHeap(const D3D12_HEAP_DESC*, REFIID, void** heap) override
+    {
+        *heap = static_cast<ID3D12Heap*>(new FakeHeap());
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE CreatePlacedResource(ID3D12Heap*, UINT64,
+        const D3D12_RESOURCE_DESC*, D3D12_RESOURCE_STATES, const D3D12_CLEAR_VALUE*, REFIID, void** resource) override
+    {
+        *resource = static_cast<ID3D12Resource*>(new FakeResource());
+        return S_OK;
+    }
+};
@@ -0,0 +1,148 @@
+// FrameArenaTest.cpp
+#include "FrameArena.h"
+#include <atomic>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include "TestCommon.h"
+
+// 替换全局 operator new，统计测试期间的堆分配次数
+namespace {
+std::atomic<uint64_t> g_globalAllocations{ 0 };
+}
+
+void* operator new(size_t size)
+{
+    g_globalAllocations++;
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace {
+// 统计分配次数的上游，代替 new_delete_resource
+class CountingResource : public std::pmr::memory_resource {
+public:
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t liveBytes = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        allocations++;
+        liveBytes += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* memory, size_t bytes, size_t alignment) override
+    {
+        deallocations++;
+        liveBytes -= bytes;
+        std::pmr::new_delete_resource()->deallocate(memory, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+// 模拟一帧的 CPU 数据：每帧的数量随帧号变化，周期为 5
+uint64_t BuildFrame(FrameArena& arena, uint64_t frame)
+{
+    const size_t drawCount = 64 + (frame % 5) * 200;
+    FrameVector<uint64_t> draws(&arena);
+    for (size_t i = 0; i < drawCount; i++) {
+        draws.push_back(i * frame);
+    }
+
+    FrameVector<FrameVector<uint32_t>> batches(&arena);
+    for (size_t i = 0; i < drawCount / 32; i++) {
+        batches.emplace_back();
+        batches.back().resize(16 + i, static_cast<uint32_t>(i));
+    }
+
+    std::pmr::string name("frame data that does not fit the small string buffer", &arena);
+    return draws.size() + batches.size() + name.size();
+}
+
+void TestNoHeapAllocationsAfterWarmUp()
+{
+    CountingResource upstream;
+    {
+        // 初始分区故意开小，先溢出，再长到峰值
+        FrameArena arena(1024, 3, &upstream);
+        uint64_t frame = 0;
+        for (; frame < 30; frame++) {
+            arena.BeginFrame();
+            BuildFrame(arena, frame);
+        }
+        CHECK(arena.GetStats().overflowCount > 0);
+        CHECK(arena.GetStats().growCount > 0);
+
+        const FrameArena::Stats warmStats = arena.GetStats();
+        const uint64_t upstreamBefore = upstream.allocations;
+        const uint64_t globalBefore = g_globalAllocations.load();
+        for (; frame < 330; frame++) {
+            arena.BeginFrame();
+            BuildFrame(arena, frame);
+            CHECK(upstream.allocations == upstreamBefore);
+            CHECK(g_globalAllocations.load() == globalBefore);
+        }
+        CHECK(arena.GetStats().overflowCount == warmStats.overflowCount);
+        CHECK(arena.GetStats().growCount == warmStats.growCount);
+    }
+    // 析构时把分区和溢出块都还给上游
+    CHECK(upstream.allocations == upstream.deallocations);
+    CHECK(upstream.liveBytes == 0);
+}
+
+void TestOverflowGrowsPartition()
+{
+    CountingResource upstream;
+    FrameArena arena(256, 1, &upstream);
+    void* small = arena.allocate(128, 8);
+    void* large = arena.allocate(4096, 8);
+    CHECK(small != nullptr && large != nullptr);
+    CHECK(arena.GetStats().overflowCount == 1);
+    CHECK(arena.GetFrameUsage() == 128 + 4096);
+
+    // 同一个分区下次用时扩大到上次的用量，同样的请求不再溢出
+    arena.BeginFrame();
+    CHECK(arena.GetStats().growCount == 1);
+    CHECK(arena.allocate(128, 8) != nullptr);
+    CHECK(arena.allocate(4096, 8) != nullptr);
+    CHECK(arena.GetStats().overflowCount == 1);
+}
+
+void TestAlignment()
+{
+    FrameArena arena(4096, 2);
+    const size_t alignments[] = { 1, 4, 16, 64, 256 };
+    for (size_t alignment : alignments) {
+        void* memory = arena.allocate(3, alignment);
+        CHECK(reinterpret_cast<uintptr_t>(memory) % alignment == 0);
+    }
+    // 溢出块同样要对齐
+    void* overflow = arena.allocate(8192, 256);
+    CHECK(reinterpret_cast<uintptr_t>(overflow) % 256 == 0);
+}
+}
+
+int main()
+{
+    RUN_TEST(TestNoHeapAllocationsAfterWarmUp);
+    RUN_TEST(TestOverflowGrowsPartition);
+    RUN_TEST(TestAlignment);
+    return FinishTests();
+}
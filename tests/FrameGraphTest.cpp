@@ -0,0 +1,340 @@
+// FrameGraphTest.cpp
+#include "FrameGraph.h"
+#include <stdexcept>
+#include <vector>
+#include "TestCommon.h"
+
+namespace {
+const uint64_t KB = 1024;
+const uint64_t MB = 1024 * KB;
+
+// 与 D3D12_RESOURCE_STATES 相同的取值，图本身只把它们当作不透明的整数
+const uint32_t STATE_PRESENT = 0x0;
+const uint32_t STATE_RENDER_TARGET = 0x4;
+const uint32_t STATE_NON_PIXEL_SHADER_RESOURCE = 0x40;
+const uint32_t STATE_PIXEL_SHADER_RESOURCE = 0x80;
+
+// gbuffer -> lighting -> tonemap -> composite（写后台缓冲区）这条链，
+// 加上几个应该被剔除或保留的 Pass
+struct TestGraph {
+    FrameGraph graph;
+    FrameGraphResource backBuffer;
+    FrameGraphResource gbuffer;
+    FrameGraphResource lit;
+    FrameGraphResource tonemapped;
+    FrameGraphResource debugOutput;
+    FrameGraphResource chainA;
+    FrameGraphResource chainB;
+    uint32_t gbufferPass, lightingPass, tonemapPass, compositePass;
+    uint32_t debugPass, emptyPass, timestampPass, chainPassA, chainPassB;
+    std::vector<uint32_t> executed;
+
+    TestGraph()
+    {
+        backBuffer = graph.Import("backbuffer", STATE_PRESENT, 0xB0);
+        gbuffer = graph.CreateTransient("gbuffer", 2 * MB, 64 * KB, 1);
+        lit = graph.CreateTransient("lit", 2 * MB, 64 * KB, 2);
+        tonemapped = graph.CreateTransient("tonemapped", 1 * MB, 64 * KB, 3);
+        debugOutput = graph.CreateTransient("debug", 4 * MB, 64 * KB);
+        chainA = graph.CreateTransient("chainA", 1 * MB, 64 * KB);
+        chainB = graph.CreateTransient("chainB", 1 * MB, 64 * KB);
+
+        gbufferPass = AddPass("gbuffer", [&](FrameGraph::PassBuilder& builder) {
+            builder.Write(gbuffer, STATE_RENDER_TARGET);
+        });
+        // 输出没人读：剔除，gbuffer 的生命周期也不因为它延长
+        debugPass = AddPass("debug", [&](FrameGraph::PassBuilder& builder) {
+            builder.Read(gbuffer, STATE_PIXEL_SHADER_RESOURCE);
+            builder.Write(debugOutput, STATE_RENDER_TARGET);
+        });
+        // 同一个 Pass 对 gbuffer 的两次读取合成一个状态
+        lightingPass = AddPass("lighting", [&](FrameGraph::PassBuilder& builder) {
+            builder.Read(gbuffer, STATE_PIXEL_SHADER_RESOURCE);
+            builder.Read(gbuffer, STATE_NON_PIXEL_SHADER_RESOURCE);
+            builder.Write(lit, STATE_RENDER_TARGET);
+        });
+        // 什么也不写又没有副作用：剔除
+        emptyPass = AddPass("empty", [&](FrameGraph::PassBuilder& builder) {
+            builder.Read(lit, STATE_PIXEL_SHADER_RESOURCE);
+        });
+        // 两个 Pass 的链，最终输出没人读：整条链剔除
+        chainPassA = AddPass("chainA", [&](FrameGraph::PassBuilder& builder) {
+            builder.Write(chainA, STATE_RENDER_TARGET);
+        });
+        chainPassB = AddPass("chainB", [&](FrameGraph::PassBuilder& builder) {
+            builder.Read(chainA, STATE_PIXEL_SHADER_RESOURCE);
+            builder.Write(chainB, STATE_RENDER_TARGET);
+        });
+        tonemapPass = AddPass("tonemap", [&](FrameGraph::PassBuilder& builder) {
+            builder.Read(lit, STATE_PIXEL_SHADER_RESOURCE);
+            builder.Write(tonemapped, STATE_RENDER_TARGET);
+        });
+        compositePass = AddPass("composite", [&](FrameGraph::PassBuilder& builder) {
+            builder.Read(tonemapped, STATE_PIXEL_SHADER_RESOURCE);
+            builder.Write(backBuffer, STATE_RENDER_TARGET);
+        });
+        // 不写资源，但有副作用（比如时间戳查询）：保留
+        timestampPass = AddPass("timestamp", [&](FrameGraph::PassBuilder& builder) {
+            builder.SetSideEffect();
+        });
+    }
+
+    uint32_t AddPass(const char* name, const FrameGraph::SetupFn& setup)
+    {
+        const uint32_t index = graph.GetPassCount();
+        return graph.AddPass(name, setup, [this, index]() { executed.push_back(index); });
+    }
+};
+
+void TestCulling()
+{
+    TestGraph test;
+    test.graph.Compile();
+    FrameGraph& graph = test.graph;
+
+    CHECK(!graph.IsPassCulled(test.gbufferPass));
+    CHECK(!graph.IsPassCulled(test.lightingPass));
+    CHECK(!graph.IsPassCulled(test.tonemapPass));
+    CHECK(!graph.IsPassCulled(test.compositePass));
+    CHECK(!graph.IsPassCulled(test.timestampPass));
+    CHECK(graph.IsPassCulled(test.debugPass));
+    CHECK(graph.IsPassCulled(test.emptyPass));
+    CHECK(graph.IsPassCulled(test.chainPassA));
+    CHECK(graph.IsPassCulled(test.chainPassB));
+
+    const std::vector<uint32_t> expectedOrder = {
+        test.gbufferPass, test.lightingPass, test.tonemapPass, test.compositePass, test.timestampPass
+    };
+    CHECK(graph.GetExecutionOrder() == expectedOrder);
+
+    // 只有没被剔除的 Pass 执行，按声明顺序
+    test.graph.Execute(nullptr);
+    CHECK(test.executed == expectedOrder);
+}
+
+void TestLifetimes()
+{
+    TestGraph test;
+    test.graph.Compile();
+    FrameGraph& graph = test.graph;
+
+    // 位置是执行顺序里的下标：gbuffer 0, lighting 1, tonemap 2, composite 3
+    CHECK(graph.GetFirstUse(test.gbuffer) == 0 && graph.GetLastUse(test.gbuffer) == 1);
+    CHECK(graph.GetFirstUse(test.lit) == 1 && graph.GetLastUse(test.lit) == 2);
+    CHECK(graph.GetFirstUse(test.tonemapped) == 2 && graph.GetLastUse(test.tonemapped) == 3);
+    CHECK(graph.GetFirstUse(test.backBuffer) == 3 && graph.GetLastUse(test.backBuffer) == 3);
+
+    // 只被剔除的 Pass 用到的资源不算用到，也不分配内存
+    CHECK(!graph.IsResourceUsed(test.debugOutput));
+    CHECK(!graph.IsResourceUsed(test.chainA));
+    CHECK(!graph.IsResourceUsed(test.chainB));
+
+    CHECK(!graph.IsTransient(test.backBuffer));
+    CHECK(graph.IsTransient(test.gbuffer));
+    CHECK(graph.GetUserData(test.lit) == 2);
+    CHECK(graph.GetPhysical(test.backBuffer) == 0xB0);
+}
+
+void TestAliasing()
+{
+    TestGraph test;
+    test.graph.Compile();
+    FrameGraph& graph = test.graph;
+
+    // gbuffer 和 lit 同时存活，地址不能重叠；tonemapped 在 gbuffer 结束之后才开始，放回 gbuffer 的位置
+    CHECK(graph.GetHeapOffset(test.gbuffer) == 0);
+    CHECK(graph.GetHeapOffset(test.lit) == 2 * MB);
+    CHECK(graph.GetHeapOffset(test.tonemapped) == 0);
+    CHECK(graph.GetTransientHeapSize() == 4 * MB);
+    CHECK(graph.GetTransientHeapSize(0) == 4 * MB);
+    CHECK(graph.GetTransientHeapSize(1) == 0);
+    CHECK(graph.GetUnaliasedTransientSize() == 5 * MB);
+    CHECK(graph.GetPeakLiveTransientSize() == 4 * MB);
+
+    // tonemapped 的地址范围整个落在 gbuffer 里，别名屏障的 before 是 gbuffer
+    CHECK(graph.GetAliasPredecessor(test.tonemapped) == test.gbuffer);
+    CHECK(graph.GetAliasPredecessor(test.gbuffer) == FrameGraph::INVALID_RESOURCE);
+    CHECK(graph.GetAliasPredecessor(test.lit) == FrameGraph::INVALID_RESOURCE);
+}
+
+void TestAliasingPlanner()
+{
+    // 不同组不共用内存；对齐要求在每组里单独满足
+    std::vector<AliasingRequest> requests(4);
+    requests[0] = { 3 * KB, 1, 0, 0, 0 };
+    requests[1] = { 1 * KB, 64 * KB, 0, 1, 0 }; // 和 0 同时存活，要放到下一个 64KB 边界
+    requests[2] = { 1 * KB, 4 * KB, 1, 1, 0 };  // 0 已经结束，可以复用 0 的地址
+    requests[3] = { 8 * KB, 1, 0, 1, 1 };       // 另一组，从 0 开始
+    const AliasingPlan plan = PlanAliasing(requests);
+
+    CHECK(plan.offsets[0] == 0);
+    CHECK(plan.offsets[1] == 64 * KB);
+    CHECK(plan.offsets[2] == 0);
+    CHECK(plan.offsets[3] == 0);
+    CHECK(plan.groupSizes.size() == 2);
+    CHECK(plan.groupSizes[0] == 65 * KB);
+    CHECK(plan.groupSizes[1] == 8 * KB);
+    CHECK(plan.heapSize == 73 * KB);
+
+    // 2 整个落在 0 的范围里；1 前面没有同地址的资源；3 在另一组，不以 0 组的资源为前驱
+    CHECK(plan.predecessors[2] == 0);
+    CHECK(plan.predecessors[1] == AliasingPlan::NO_PREDECESSOR);
+    CHECK(plan.predecessors[3] == AliasingPlan::NO_PREDECESSOR);
+}
+
+void TestTransitions()
+{
+    TestGraph test;
+    test.graph.Compile();
+    FrameGraph& graph = test.graph;
+
+    // 后台缓冲区到 composite 才用到，转换从第一个 Pass 开始拆分，Begin 排在 Pass 自己的转换前面
+    size_t count = 0;
+    const FrameGraph::Transition* transitions = graph.GetPassTransitions(test.gbufferPass, count);
+    CHECK(count == 2);
+    CHECK(transitions[0].resource == test.backBuffer);
+    CHECK(transitions[0].split == FrameGraph::Split::Begin);
+    CHECK(transitions[0].before == STATE_PRESENT);
+    CHECK(transitions[0].after == STATE_RENDER_TARGET);
+    CHECK(transitions[1].resource == test.gbuffer);
+    CHECK(transitions[1].before == FrameGraph::STATE_UNDEFINED);
+    CHECK(transitions[1].after == STATE_RENDER_TARGET);
+    CHECK(transitions[1].split == FrameGraph::Split::None);
+
+    // 合成后的读取状态，一个转换
+    transitions = graph.GetPassTransitions(test.lightingPass, count);
+    CHECK(count == 2);
+    CHECK(transitions[0].resource == test.gbuffer);
+    CHECK(transitions[0].before == STATE_RENDER_TARGET);
+    CHECK(transitions[0].after == (STATE_PIXEL_SHADER_RESOURCE | STATE_NON_PIXEL_SHADER_RESOURCE));
+    CHECK(transitions[0].split == FrameGraph::Split::None);
+    CHECK(transitions[1].resource == test.lit);
+    CHECK(transitions[1].before == FrameGraph::STATE_UNDEFINED);
+
+    // 导入资源从它的初始状态开始，在这里结束拆分
+    transitions = graph.GetPassTransitions(test.compositePass, count);
+    CHECK(count == 2);
+    CHECK(transitions[0].resource == test.tonemapped);
+    CHECK(transitions[0].split == FrameGraph::Split::None);
+    CHECK(transitions[1].resource == test.backBuffer);
+    CHECK(transitions[1].before == STATE_PRESENT);
+    CHECK(transitions[1].after == STATE_RENDER_TARGET);
+    CHECK(transitions[1].split == FrameGraph::Split::End);
+
+    // 被剔除的 Pass 和不访问资源的 Pass 没有转换
+    CHECK(graph.GetPassTransitions(test.debugPass, count) == nullptr && count == 0);
+    CHECK(graph.GetPassTransitions(test.timestampPass, count) == nullptr && count == 0);
+
+    // Execute 把同样的转换按执行顺序交给回调
+    std::vector<uint32_t> passes;
+    size_t total = 0;
+    graph.Execute([&](uint32_t pass, const FrameGraph::Transition*, size_t passCount) {
+        passes.push_back(pass);
+        total += passCount;
+    });
+    CHECK(passes == graph.GetExecutionOrder());
+    CHECK(total == 8);
+}
+
+void TestSplitTransitions()
+{
+    // shadow 在第 0 个 Pass 写入，第 3 个 Pass 才读：RENDER_TARGET -> SHADER_RESOURCE 从第 1 个 Pass 开始拆分。
+    // 相邻 Pass 之间的转换不拆
+    FrameGraph graph;
+    const FrameGraphResource output = graph.Import("output", STATE_RENDER_TARGET, 1);
+    const FrameGraphResource shadow = graph.CreateTransient("shadow", 1 * MB, 64 * KB);
+    const FrameGraphResource scratch = graph.CreateTransient("scratch", 1 * MB, 64 * KB);
+    const uint32_t shadowPass = graph.AddPass("shadow", [&](FrameGraph::PassBuilder& builder) {
+        builder.Write(shadow, STATE_RENDER_TARGET);
+    }, nullptr);
+    const uint32_t scratchWrite = graph.AddPass("scratch write", [&](FrameGraph::PassBuilder& builder) {
+        builder.Write(scratch, STATE_RENDER_TARGET);
+    }, nullptr);
+    const uint32_t scratchRead = graph.AddPass("scratch read", [&](FrameGraph::PassBuilder& builder) {
+        builder.Read(scratch, STATE_PIXEL_SHADER_RESOURCE);
+        builder.Write(output, STATE_RENDER_TARGET);
+    }, nullptr);
+    const uint32_t lighting = graph.AddPass("lighting", [&](FrameGraph::PassBuilder& builder) {
+        builder.Read(shadow, STATE_PIXEL_SHADER_RESOURCE);
+        builder.Write(output, STATE_RENDER_TARGET);
+    }, nullptr);
+    graph.Compile();
+
+    size_t count = 0;
+    const FrameGraph::Transition* transitions = graph.GetPassTransitions(shadowPass, count);
+    CHECK(count == 1 && transitions[0].split == FrameGraph::Split::None);
+
+    transitions = graph.GetPassTransitions(scratchWrite, count);
+    CHECK(count == 2);
+    CHECK(transitions[0].resource == shadow);
+    CHECK(transitions[0].split == FrameGraph::Split::Begin);
+    CHECK(transitions[0].before == STATE_RENDER_TARGET);
+    CHECK(transitions[0].after == STATE_PIXEL_SHADER_RESOURCE);
+    CHECK(transitions[1].resource == scratch && transitions[1].split == FrameGraph::Split::None);
+
+    transitions = graph.GetPassTransitions(scratchRead, count);
+    CHECK(count == 1);
+    CHECK(transitions[0].resource == scratch && transitions[0].split == FrameGraph::Split::None);
+
+    transitions = graph.GetPassTransitions(lighting, count);
+    CHECK(count == 1);
+    CHECK(transitions[0].resource == shadow);
+    CHECK(transitions[0].split == FrameGraph::Split::End);
+    CHECK(transitions[0].before == STATE_RENDER_TARGET);
+    CHECK(transitions[0].after == STATE_PIXEL_SHADER_RESOURCE);
+}
+
+void TestResetAndErrors()
+{
+    FrameGraph graph;
+    bool threw = false;
+    try {
+        graph.Execute(nullptr);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    threw = false;
+    try {
+        graph.AddPass("bad", [](FrameGraph::PassBuilder& builder) { builder.Read(5, 0); }, nullptr);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    graph.Reset();
+    const FrameGraphResource output = graph.Import("output", STATE_PRESENT, 1);
+    graph.AddPass("draw", [&](FrameGraph::PassBuilder& builder) { builder.Write(output, STATE_RENDER_TARGET); }, nullptr);
+    graph.Compile();
+    CHECK(graph.GetExecutionOrder().size() == 1);
+    CHECK(graph.GetTransientHeapSize() == 0);
+
+    threw = false;
+    try {
+        graph.AddPass("late", [](FrameGraph::PassBuilder&) {}, nullptr);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    // Reset 之后可以重新建图
+    graph.Reset();
+    CHECK(graph.GetPassCount() == 0 && graph.GetResourceCount() == 0);
+    graph.AddPass("side effect", [](FrameGraph::PassBuilder& builder) { builder.SetSideEffect(); }, nullptr);
+    graph.Compile();
+    CHECK(graph.GetExecutionOrder().size() == 1);
+}
+}
+
+int main()
+{
+    RUN_TEST(TestCulling);
+    RUN_TEST(TestLifetimes);
+    RUN_TEST(TestAliasing);
+    RUN_TEST(TestAliasingPlanner);
+    RUN_TEST(TestTransitions);
+    RUN_TEST(TestSplitTransitions);
+    RUN_TEST(TestResetAndErrors);
+    return FinishTests();
+}
@@ -0,0 +1,104 @@
+// FrameRingTest.cpp
+#include "FrameRing.h"
+#include <stdexcept>
+#include "MockGpuTimeline.h"
+#include "TestCommon.h"
+
+namespace {
+void TestNoWaitWhenGpuKeepsUp()
+{
+    MockGpuTimeline timeline(true);
+    FrameRing ring(timeline, 3);
+    for (uint32_t frame = 0; frame < 100; frame++) {
+        CHECK(ring.BeginFrame() == frame % 3);
+        CHECK(ring.EndFrame() == frame + 1);
+    }
+    CHECK(ring.GetFrameNumber() == 100);
+    CHECK(ring.GetStallCount() == 0);
+    CHECK(timeline.GetWaitCount() == 0);
+}
+
+void TestWaitOnlyWhenSlotIsBusy()
+{
+    // GPU 一帧都没执行完：前 3 帧用的是空闲的帧槽，不等待
+    MockGpuTimeline timeline;
+    FrameRing ring(timeline, 3);
+    for (uint32_t frame = 0; frame < 3; frame++) {
+        CHECK(ring.BeginFrame() == frame);
+        ring.EndFrame();
+    }
+    CHECK(timeline.GetWaitCount() == 0);
+
+    // 回到帧槽 0 时它的第 1 帧还没完成，要等到值 1
+    CHECK(ring.BeginFrame() == 0);
+    CHECK(ring.GetStallCount() == 1);
+    CHECK(timeline.GetWaitCount() == 1);
+    CHECK(timeline.GetLastWaitValue() == 1);
+    ring.EndFrame();
+
+    // GPU 执行到帧槽 1 的 fence（值 2），回到帧槽 1 时不用等
+    timeline.Complete(2);
+    CHECK(ring.BeginFrame() == 1);
+    CHECK(timeline.GetWaitCount() == 1);
+    ring.EndFrame();
+
+    // 帧槽 2 的值 3 还没完成，只等它，不等更新的帧
+    CHECK(ring.BeginFrame() == 2);
+    CHECK(timeline.GetWaitCount() == 2);
+    CHECK(timeline.GetLastWaitValue() == 3);
+    ring.EndFrame();
+    CHECK(ring.GetStallCount() == 2);
+}
+
+void TestGpuOneFrameBehind()
+{
+    // GPU 总是落后 CPU 一帧：只有一个帧槽时每帧都要等，两个帧槽时 CPU 和 GPU 完全重叠
+    for (uint32_t frameCount = 1; frameCount <= 2; frameCount++) {
+        MockGpuTimeline timeline;
+        FrameRing ring(timeline, frameCount);
+        for (uint32_t frame = 0; frame < 50; frame++) {
+            ring.BeginFrame();
+            const uint64_t value = ring.EndFrame();
+            timeline.Complete(value - 1);
+        }
+        const uint64_t expectedWaits = frameCount == 1 ? 49 : 0;
+        CHECK(timeline.GetWaitCount() == expectedWaits);
+        CHECK(ring.GetStallCount() == expectedWaits);
+    }
+}
+
+void TestWaitForIdle()
+{
+    MockGpuTimeline timeline;
+    FrameRing ring(timeline, 3);
+    for (uint32_t frame = 0; frame < 3; frame++) {
+        ring.BeginFrame();
+        ring.EndFrame();
+    }
+    ring.WaitForIdle();
+    CHECK(timeline.GetCompletedValue() == timeline.GetLastSignaledValue());
+    CHECK(timeline.GetLastWaitValue() == 3);
+}
+
+void TestInvalidFrameCount()
+{
+    MockGpuTimeline timeline;
+    bool threw = false;
+    try {
+        FrameRing ring(timeline, 0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+}
+
+int main()
+{
+    RUN_TEST(TestNoWaitWhenGpuKeepsUp);
+    RUN_TEST(TestWaitOnlyWhenSlotIsBusy);
+    RUN_TEST(TestGpuOneFrameBehind);
+    RUN_TEST(TestWaitForIdle);
+    RUN_TEST(TestInvalidFrameCount);
+    return FinishTests();
+}
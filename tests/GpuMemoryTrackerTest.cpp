@@ -0,0 +1,186 @@
+// GpuMemoryTrackerTest.cpp
+#include "GpuMemoryTracker.h"
+#include "FakeD3D12.h"
+#include "TestCommon.h"
+
+using Microsoft::WRL::ComPtr;
+
+namespace {
+const uint64_t KB = 1024;
+const uint64_t MB = 1024 * KB;
+
+// 预算和占用由测试设定的适配器
+class FakeAdapter final : public FakeUnknown<IDXGIAdapter3> {
+public:
+    uint64_t budget = 0;
+    uint64_t currentUsage = 0;
+
+    HRESULT STDMETHODCALLTYPE QueryVideoMemoryInfo(UINT, DXGI_MEMORY_SEGMENT_GROUP group, DXGI_QUERY_VIDEO_MEMORY_INFO* info) override
+    {
+        if (group != DXGI_MEMORY_SEGMENT_GROUP_LOCAL) {
+            return E_FAIL;
+        }
+        *info = {};
+        info->Budget = budget;
+        info->CurrentUsage = currentUsage;
+        return S_OK;
+    }
+};
+
+ComPtr<ID3D12Device> CreateFakeDevice()
+{
+    ComPtr<ID3D12Device> device;
+    device.Attach(new FakeDevice());
+    return device;
+}
+
+D3D12_RESOURCE_DESC BufferDesc(uint64_t size)
+{
+    D3D12_RESOURCE_DESC desc = {};
+    desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    desc.Width = size;
+    desc.Height = 1;
+    desc.DepthOrArraySize = 1;
+    desc.MipLevels = 1;
+    desc.SampleDesc.Count = 1;
+    return desc;
+}
+
+D3D12_RESOURCE_DESC TextureDesc(uint64_t width, UINT height)
+{
+    D3D12_RESOURCE_DESC desc = BufferDesc(width);
+    desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    desc.Height = height;
+    desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    return desc;
+}
+
+ComPtr<ID3D12Resource> CreateCommitted(GpuMemoryTracker& tracker, GpuMemoryCategory category, D3D12_HEAP_TYPE heapType, uint64_t size)
+{
+    D3D12_HEAP_PROPERTIES heapProperties = {};
+    heapProperties.Type = heapType;
+    const D3D12_RESOURCE_DESC desc = BufferDesc(size);
+    ComPtr<ID3D12Resource> resource;
+    const HRESULT hr = tracker.CreateCommittedResource(category, &heapProperties, D3D12_HEAP_FLAG_NONE, &desc,
+        D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&resource));
+    CHECK(SUCCEEDED(hr) && resource);
+    return resource;
+}
+
+void TestCategoryStatsFollowLifetime()
+{
+    ComPtr<ID3D12Device> device = CreateFakeDevice();
+    GpuMemoryTracker tracker(device.Get(), nullptr);
+
+    // 提交资源至少按 64KB 记账
+    ComPtr<ID3D12Resource> small = CreateCommitted(tracker, GpuMemoryCategory::Vertex, D3D12_HEAP_TYPE_DEFAULT, 1000);
+    ComPtr<ID3D12Resource> large = CreateCommitted(tracker, GpuMemoryCategory::Vertex, D3D12_HEAP_TYPE_DEFAULT, 100 * KB);
+    ComPtr<ID3D12Resource> upload = CreateCommitted(tracker, GpuMemoryCategory::Upload, D3D12_HEAP_TYPE_UPLOAD, 64 * KB);
+
+    GpuMemoryTracker::CategoryStats vertex = tracker.GetStats(GpuMemoryCategory::Vertex);
+    CHECK(vertex.liveBytes == 192 * KB && vertex.peakBytes == 192 * KB);
+    CHECK(vertex.liveCount == 2 && vertex.allocations == 2);
+    CHECK(tracker.GetStats(GpuMemoryCategory::Upload).liveBytes == 64 * KB);
+    CHECK(tracker.GetStats(GpuMemoryCategory::Index).liveCount == 0);
+    CHECK(tracker.GetTrackedBytes() == 256 * KB);
+
+    // 释放最后一个引用时对象上的令牌跟着释放，记账扣除；峰值和累计分配次数不回落
+    small.Reset();
+    vertex = tracker.GetStats(GpuMemoryCategory::Vertex);
+    CHECK(vertex.liveBytes == 128 * KB && vertex.peakBytes == 192 * KB);
+    CHECK(vertex.liveCount == 1 && vertex.allocations == 2);
+    CHECK(tracker.GetTrackedBytes() == 192 * KB);
+
+    // 还有别的引用时不扣除
+    ComPtr<ID3D12Resource> alias = large;
+    large.Reset();
+    CHECK(tracker.GetStats(GpuMemoryCategory::Vertex).liveCount == 1);
+    alias.Reset();
+    upload.Reset();
+
+    vertex = tracker.GetStats(GpuMemoryCategory::Vertex);
+    CHECK(vertex.liveBytes == 0 && vertex.liveCount == 0 && vertex.peakBytes == 192 * KB);
+    CHECK(tracker.GetStats(GpuMemoryCategory::Upload).liveBytes == 0);
+    CHECK(tracker.GetTrackedBytes() == 0);
+    CHECK(tracker.GetPeakTrackedBytes() == 256 * KB);
+}
+
+void TestPlacedResourcesNotInTotal()
+{
+    ComPtr<ID3D12Device> device = CreateFakeDevice();
+    GpuMemoryTracker tracker(device.Get(), nullptr);
+
+    D3D12_HEAP_DESC heapDesc = {};
+    heapDesc.SizeInBytes = 4 * MB;
+    heapDesc.Properties.Type = D3D12_HEAP_TYPE_DEFAULT;
+    ComPtr<ID3D12Heap> heap;
+    CHECK(SUCCEEDED(tracker.CreateHeap(&heapDesc, IID_PPV_ARGS(&heap))));
+    CHECK(tracker.GetStats(GpuMemoryCategory::Heap).liveBytes == 4 * MB);
+    CHECK(tracker.GetTrackedBytes() == 4 * MB);
+
+    // 放置资源计入自己的类别，但它的内存已经算在堆里，总量不变
+    const D3D12_RESOURCE_DESC textureDesc = TextureDesc(256, 256);
+    ComPtr<ID3D12Resource> texture;
+    CHECK(SUCCEEDED(tracker.CreatePlacedResource(GpuMemoryCategory::Texture, heap.Get(), 0, &textureDesc,
+        D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&texture))));
+    GpuMemoryTracker::CategoryStats textures = tracker.GetStats(GpuMemoryCategory::Texture);
+    CHECK(textures.liveBytes == 256 * KB && textures.liveCount == 1);
+    CHECK(tracker.GetTrackedBytes() == 4 * MB);
+    CHECK(tracker.GetPeakTrackedBytes() == 4 * MB);
+
+    texture.Reset();
+    textures = tracker.GetStats(GpuMemoryCategory::Texture);
+    CHECK(textures.liveBytes == 0 && textures.liveCount == 0 && textures.peakBytes == 256 * KB);
+    CHECK(tracker.GetTrackedBytes() == 4 * MB);
+
+    heap.Reset();
+    CHECK(tracker.GetStats(GpuMemoryCategory::Heap).liveCount == 0);
+    CHECK(tracker.GetTrackedBytes() == 0);
+}
+
+void TestObjectsOutliveTracker()
+{
+    // 记账数据和令牌共享，跟踪器先销毁时对象仍然可以安全释放
+    ComPtr<ID3D12Device> device = CreateFakeDevice();
+    ComPtr<ID3D12Resource> resource;
+    {
+        GpuMemoryTracker tracker(device.Get(), nullptr);
+        resource = CreateCommitted(tracker, GpuMemoryCategory::Buffer, D3D12_HEAP_TYPE_DEFAULT, 64 * KB);
+        CHECK(tracker.GetTrackedBytes() == 64 * KB);
+    }
+    resource.Reset();
+}
+
+void TestBudget()
+{
+    ComPtr<ID3D12Device> device = CreateFakeDevice();
+
+    // 没有适配器时拿不到预算，总是允许分配
+    GpuMemoryTracker noBudget(device.Get(), nullptr);
+    CHECK(noBudget.QueryBudget().budget == 0);
+    CHECK(noBudget.CanAllocate(UINT64_MAX));
+
+    ComPtr<FakeAdapter> adapter;
+    adapter.Attach(new FakeAdapter());
+    adapter->budget = 1024 * MB;
+    adapter->currentUsage = 900 * MB;
+    GpuMemoryTracker tracker(device.Get(), adapter.Get());
+    ComPtr<ID3D12Resource> resource = CreateCommitted(tracker, GpuMemoryCategory::Buffer, D3D12_HEAP_TYPE_DEFAULT, 64 * KB);
+
+    const GpuMemoryBudget budget = tracker.QueryBudget();
+    CHECK(budget.budget == 1024 * MB && budget.currentUsage == 900 * MB);
+    CHECK(budget.GetAvailable() == 124 * MB);
+    CHECK(budget.trackedBytes == 64 * KB);
+    CHECK(tracker.CanAllocate(124 * MB));
+    CHECK(!tracker.CanAllocate(124 * MB + 1));
+}
+}
+
+int main()
+{
+    RUN_TEST(TestCategoryStatsFollowLifetime);
+    RUN_TEST(TestPlacedResourcesNotInTotal);
+    RUN_TEST(TestObjectsOutliveTracker);
+    RUN_TEST(TestBudget);
+    return FinishTests();
+}
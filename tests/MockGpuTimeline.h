@@ -0,0 +1,88 @@
+#pragma once
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "GpuTimeline.h"
+
+// 不需要 GPU 的时间线：Signal 只记下值，完成值由测试用 Complete 推进，或者打开 autoComplete 让 GPU 永远跟得上。
+// WaitForValue 模拟 CPU 阻塞：记一次等待，然后把完成值推进到 value（相当于 GPU 追了上来）。
+// OnCompleted 的回调在完成值推进时（Signal、Complete、WaitForValue）在调用线程上执行，
+// 和 FenceTimeline 一样不会在 OnCompleted 里同步执行；存放回调的数组只增不减，稳定后不再分配内存。
+class MockGpuTimeline : public IGpuTimeline {
+public:
+    explicit MockGpuTimeline(bool autoComplete = false) : m_autoComplete(autoComplete) {}
+
+    uint64_t Signal() override
+    {
+        m_lastSignaled++;
+        if (m_autoComplete) {
+            m_completed = m_lastSignaled;
+        }
+        DispatchCompleted();
+        return m_lastSignaled;
+    }
+
+    uint64_t GetLastSignaledValue() const override { return m_lastSignaled; }
+    uint64_t GetCompletedValue() override { return m_completed; }
+
+    void WaitForValue(uint64_t value) override
+    {
+        m_waitCount++;
+        m_lastWaitValue = value;
+        m_completed = std::max(m_completed, value);
+        DispatchCompleted();
+    }
+
+    void OnCompleted(uint64_t value, std::function<void()> callback) override
+    {
+        m_callbacks.emplace_back(value, std::move(callback));
+    }
+
+    // GPU 执行到 value
+    void Complete(uint64_t value)
+    {
+        m_completed = std::max(m_completed, std::min(value, m_lastSignaled));
+        DispatchCompleted();
+    }
+
+    uint64_t GetWaitCount() const { return m_waitCount; }
+    uint64_t GetLastWaitValue() const { return m_lastWaitValue; }
+    size_t GetPendingCallbackCount() const { return m_callbacks.size(); }
+
+private:
+    // 先摘下已经完成的回调再执行，回调里可以再注册新的回调；回调里推进完成值时由外层循环接着处理
+    void DispatchCompleted()
+    {
+        if (m_dispatching) {
+            return;
+        }
+        m_dispatching = true;
+        while (true) {
+            m_ready.clear();
+            for (auto& entry : m_callbacks) {
+                if (entry.first <= m_completed) {
+                    m_ready.push_back(std::move(entry.second));
+                }
+            }
+            if (m_ready.empty()) {
+                break;
+            }
+            m_callbacks.erase(std::remove_if(m_callbacks.begin(), m_callbacks.end(),
+                [this](const std::pair<uint64_t, std::function<void()>>& entry) { return entry.first <= m_completed; }),
+                m_callbacks.end());
+            for (auto& callback : m_ready) {
+                callback();
+            }
+        }
+        m_dispatching = false;
+    }
+
+    bool m_autoComplete;
+    uint64_t m_lastSignaled = 0;
+    uint64_t m_completed = 0;
+    uint64_t m_waitCount = 0;
+    uint64_t m_lastWaitValue = 0;
+    std::vector<std::pair<uint64_t, std::function<void()>>> m_callbacks;
+    std::vector<std::function<void()>> m_ready;
+    bool m_dispatching = false;
+};
@@ -0,0 +1,137 @@
+// ParallelCommandRecorderTest.cpp
+#include "ParallelCommandRecorder.h"
+#include <atomic>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include "FakeD3D12.h"
+#include "MockGpuTimeline.h"
+#include "TestCommon.h"
+
+// 替换全局 operator new，统计测试期间的堆分配次数
+namespace {
+std::atomic<uint64_t> g_globalAllocations{ 0 };
+}
+
+void* operator new(size_t size)
+{
+    g_globalAllocations++;
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace {
+const size_t DRAW_COUNT = 1000;
+const size_t MIN_DRAWS_PER_CHUNK = 100;
+const unsigned WORKER_THREADS = 3;
+
+Microsoft::WRL::ComPtr<ID3D12Device> CreateFakeDevice()
+{
+    Microsoft::WRL::ComPtr<ID3D12Device> device;
+    device.Attach(new FakeDevice());
+    return device;
+}
+
+void TestChunksInDrawOrder()
+{
+    Microsoft::WRL::ComPtr<ID3D12Device> device = CreateFakeDevice();
+    MockGpuTimeline timeline(true);
+    CommandListPool pool(device.Get());
+    pool.SetTimeline(D3D12_COMMAND_LIST_TYPE_DIRECT, &timeline);
+    WorkerPool workers(WORKER_THREADS);
+    ParallelCommandRecorder recorder(pool, workers);
+
+    // 4 个线程（含调用线程），每块至少 100 个绘制：切成 4 块，每块 250 个
+    CHECK(recorder.GetChunkCount(DRAW_COUNT, MIN_DRAWS_PER_CHUNK) == 4);
+    CHECK(recorder.GetChunkCount(MIN_DRAWS_PER_CHUNK, MIN_DRAWS_PER_CHUNK) == 1);
+    CHECK(recorder.GetChunkCount(0, MIN_DRAWS_PER_CHUNK) == 0);
+
+    std::pmr::vector<CommandContext> contexts = recorder.Record(
+        DRAW_COUNT, MIN_DRAWS_PER_CHUNK, nullptr,
+        [](ID3D12GraphicsCommandList* list, size_t, size_t first, size_t count) {
+            for (size_t i = 0; i < count; i++) {
+                list->DrawInstanced(3, 1, 0, static_cast<UINT>(first + i));
+            }
+        });
+    CHECK(contexts.size() == 4);
+    CHECK(recorder.GetLastChunkCount() == 4);
+
+    // 返回的列表按块的顺序排列，和哪个线程录制的无关；每条 DrawInstanced 记成 5 个字
+    for (size_t chunk = 0; chunk < contexts.size(); chunk++) {
+        const std::vector<UINT>& commands = static_cast<FakeGraphicsCommandList*>(contexts[chunk].list.Get())->GetCommands();
+        CHECK(commands.size() == 250 * 5);
+        CHECK(commands[4] == chunk * 250);
+        CHECK(commands[commands.size() - 1] == chunk * 250 + 249);
+    }
+
+    const uint64_t fenceValue = timeline.Signal();
+    for (CommandContext& context : contexts) {
+        pool.Release(context, fenceValue);
+    }
+}
+
+void TestNoAllocationsAfterWarmUp()
+{
+    // Renderer::Render 的录制回调按引用捕获多个局部变量，放不进 std::function 的内联缓冲；
+    // 回调和 ParallelFor 的任务都只被引用，预热之后每帧录制不再分配内存
+    Microsoft::WRL::ComPtr<ID3D12Device> device = CreateFakeDevice();
+    MockGpuTimeline timeline(true);
+    CommandListPool pool(device.Get());
+    pool.SetTimeline(D3D12_COMMAND_LIST_TYPE_DIRECT, &timeline);
+    WorkerPool workers(WORKER_THREADS);
+    ParallelCommandRecorder recorder(pool, workers);
+
+    const UINT rootIndex = 1;
+    const UINT drawDataIndex = 7;
+    const UINT vertexCount = 3;
+    std::atomic<size_t> recordedDraws{ 0 };
+    auto runFrame = [&]() {
+        alignas(std::max_align_t) unsigned char buffer[1024];
+        std::pmr::monotonic_buffer_resource memory(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+        std::pmr::vector<CommandContext> contexts = recorder.Record(
+            DRAW_COUNT, MIN_DRAWS_PER_CHUNK, nullptr,
+            [&](ID3D12GraphicsCommandList* list, size_t, size_t first, size_t count) {
+                for (size_t i = 0; i < count; i++) {
+                    const UINT rootConstants[2] = { drawDataIndex, static_cast<UINT>(first + i) };
+                    list->SetGraphicsRoot32BitConstants(rootIndex, 2, rootConstants, 0);
+                    list->DrawInstanced(vertexCount, 1, 0, 0);
+                }
+                recordedDraws += count;
+            },
+            &memory);
+        const uint64_t fenceValue = timeline.Signal();
+        for (CommandContext& context : contexts) {
+            pool.Release(context, fenceValue);
+        }
+    };
+
+    for (int frame = 0; frame < 10; frame++) {
+        runFrame();
+    }
+    const uint64_t before = g_globalAllocations.load();
+    for (int frame = 0; frame < 100; frame++) {
+        runFrame();
+    }
+    CHECK(g_globalAllocations.load() == before);
+    CHECK(recordedDraws.load() == DRAW_COUNT * 110);
+}
+}
+
+int main()
+{
+    RUN_TEST(TestChunksInDrawOrder);
+    RUN_TEST(TestNoAllocationsAfterWarmUp);
+    return FinishTests();
+}
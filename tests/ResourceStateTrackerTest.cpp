@@ -0,0 +1,244 @@
+// ResourceStateTrackerTest.cpp
+#include "ResourceStateTracker.h"
+#include <initializer_list>
+#include <vector>
+#include "FakeD3D12.h"
+#include "TestCommon.h"
+
+namespace {
+D3D12_RESOURCE_BARRIER Transition(
+    ID3D12Resource* resource, UINT subresource,
+    D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after,
+    D3D12_RESOURCE_BARRIER_FLAGS flags = D3D12_RESOURCE_BARRIER_FLAG_NONE)
+{
+    D3D12_RESOURCE_BARRIER barrier = {};
+    barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    barrier.Flags = flags;
+    barrier.Transition.pResource = resource;
+    barrier.Transition.Subresource = subresource;
+    barrier.Transition.StateBefore = before;
+    barrier.Transition.StateAfter = after;
+    return barrier;
+}
+
+D3D12_RESOURCE_BARRIER Aliasing(ID3D12Resource* before, ID3D12Resource* after)
+{
+    D3D12_RESOURCE_BARRIER barrier = {};
+    barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+    barrier.Aliasing.pResourceBefore = before;
+    barrier.Aliasing.pResourceAfter = after;
+    return barrier;
+}
+
+bool SameBarrier(const D3D12_RESOURCE_BARRIER& a, const D3D12_RESOURCE_BARRIER& b)
+{
+    if (a.Type != b.Type || a.Flags != b.Flags) {
+        return false;
+    }
+    if (a.Type == D3D12_RESOURCE_BARRIER_TYPE_ALIASING) {
+        return a.Aliasing.pResourceBefore == b.Aliasing.pResourceBefore && a.Aliasing.pResourceAfter == b.Aliasing.pResourceAfter;
+    }
+    return a.Transition.pResource == b.Transition.pResource &&
+        a.Transition.Subresource == b.Transition.Subresource &&
+        a.Transition.StateBefore == b.Transition.StateBefore &&
+        a.Transition.StateAfter == b.Transition.StateAfter;
+}
+
+// 命令列表上第 batch 次 ResourceBarrier 调用的屏障数组和 expected 逐个相同
+bool BatchIs(const FakeGraphicsCommandList& list, size_t batch, std::initializer_list<D3D12_RESOURCE_BARRIER> expected)
+{
+    const std::vector<std::vector<D3D12_RESOURCE_BARRIER>>& batches = list.GetBarrierBatches();
+    if (batch >= batches.size() || batches[batch].size() != expected.size()) {
+        return false;
+    }
+    size_t i = 0;
+    for (const D3D12_RESOURCE_BARRIER& barrier : expected) {
+        if (!SameBarrier(batches[batch][i++], barrier)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const UINT ALL = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+
+void TestMergeAndCancel()
+{
+    FakeGraphicsCommandList list(D3D12_COMMAND_LIST_TYPE_DIRECT);
+    FakeResource buffer;
+    FakeResource texture;
+    ResourceStateTracker tracker;
+    tracker.Register(&buffer, D3D12_RESOURCE_STATE_COMMON);
+    tracker.Register(&texture, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+    // 同一刷新点内 A->B 再 B->C 合成一个 A->C；其他资源的屏障保持声明的顺序
+    tracker.Require(&buffer, D3D12_RESOURCE_STATE_COPY_DEST);
+    tracker.Require(&texture, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    tracker.Require(&buffer, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+    CHECK(tracker.Flush(&list) == 2);
+    CHECK(BatchIs(list, 0, {
+        Transition(&buffer, ALL, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER),
+        Transition(&texture, ALL, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET),
+    }));
+    CHECK(tracker.GetStats().merged == 1);
+
+    // A->B 再 B->A 直接抵消，Flush 不调用 ResourceBarrier
+    tracker.Require(&texture, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    tracker.Require(&texture, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    CHECK(!tracker.HasPendingBarriers());
+    CHECK(tracker.Flush(&list) == 0);
+    CHECK(list.GetBarrierBatches().size() == 1);
+    CHECK(tracker.GetStats().merged == 2);
+    CHECK(tracker.GetState(&texture) == D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    // 已经在要求的只读状态组合里时不需要屏障；别名屏障排在后面声明的转换前面
+    tracker.Register(&buffer, D3D12_RESOURCE_STATE_GENERIC_READ);
+    tracker.Require(&buffer, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    tracker.Alias(nullptr, &texture);
+    tracker.Require(&texture, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    CHECK(tracker.Flush(&list) == 2);
+    CHECK(BatchIs(list, 1, {
+        Aliasing(nullptr, &texture),
+        Transition(&texture, ALL, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE),
+    }));
+    CHECK(tracker.GetStats().barrierCalls == 2);
+    CHECK(tracker.GetStats().barriers == 4);
+}
+
+void TestSplitPromotedWhenNotStarted()
+{
+    FakeGraphicsCommandList list(D3D12_COMMAND_LIST_TYPE_DIRECT);
+    FakeResource texture;
+    ResourceStateTracker tracker;
+    tracker.Register(&texture, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    // BEGIN_ONLY 还没 Flush 就要用：没有空隙可利用，换成一个普通转换，不发 END_ONLY
+    tracker.BeginTransition(&texture, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    tracker.Require(&texture, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    CHECK(tracker.Flush(&list) == 1);
+    CHECK(BatchIs(list, 0, {
+        Transition(&texture, ALL, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE),
+    }));
+    CHECK(tracker.GetStats().splitBarriers == 0);
+
+    // 要求的状态和拆分的目标不同时，普通转换后面再接一个
+    tracker.BeginTransition(&texture, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    tracker.Require(&texture, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    CHECK(tracker.Flush(&list) == 1);
+    CHECK(BatchIs(list, 1, {
+        Transition(&texture, ALL, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_COPY_SOURCE),
+    }));
+    CHECK(tracker.GetState(&texture) == D3D12_RESOURCE_STATE_COPY_SOURCE);
+}
+
+void TestSplitAcrossFlush()
+{
+    FakeGraphicsCommandList list(D3D12_COMMAND_LIST_TYPE_DIRECT);
+    FakeResource texture;
+    FakeResource other;
+    ResourceStateTracker tracker;
+    tracker.Register(&texture, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    tracker.Register(&other, D3D12_RESOURCE_STATE_COMMON);
+
+    // 中间隔着一次 Flush：前半段随那次 Flush 发出，Require 时发后半段
+    tracker.BeginTransition(&texture, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    CHECK(tracker.Flush(&list) == 1);
+    tracker.Require(&other, D3D12_RESOURCE_STATE_COPY_DEST);
+    CHECK(tracker.Flush(&list) == 1);
+    tracker.Require(&texture, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    CHECK(tracker.Flush(&list) == 1);
+    CHECK(BatchIs(list, 0, {
+        Transition(&texture, ALL, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY),
+    }));
+    CHECK(BatchIs(list, 1, {
+        Transition(&other, ALL, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST),
+    }));
+    CHECK(BatchIs(list, 2, {
+        Transition(&texture, ALL, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_BARRIER_FLAG_END_ONLY),
+    }));
+    CHECK(tracker.GetStats().splitBarriers == 1);
+
+    // 关闭列表前的 Flush 结束所有还没结束的拆分，拆分不跨命令列表
+    tracker.BeginTransition(&texture, D3D12_RESOURCE_STATE_RENDER_TARGET);
+    CHECK(tracker.Flush(&list) == 1);
+    CHECK(tracker.Flush(&list, true) == 1);
+    CHECK(BatchIs(list, 4, {
+        Transition(&texture, ALL, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_BARRIER_FLAG_END_ONLY),
+    }));
+    CHECK(tracker.Flush(&list) == 0);
+}
+
+void TestSubresourceCollapse()
+{
+    FakeGraphicsCommandList list(D3D12_COMMAND_LIST_TYPE_DIRECT);
+    FakeResource texture;
+    ResourceStateTracker tracker;
+    tracker.Register(&texture, D3D12_RESOURCE_STATE_COMMON, 3);
+
+    tracker.Require(&texture, D3D12_RESOURCE_STATE_RENDER_TARGET, 1);
+    CHECK(tracker.Flush(&list) == 1);
+    CHECK(BatchIs(list, 0, {
+        Transition(&texture, 1, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET),
+    }));
+
+    // 子资源状态不一致时整个资源的要求按子资源逐个转换，已经在目标状态的子资源不发屏障
+    tracker.Require(&texture, D3D12_RESOURCE_STATE_COPY_DEST, 2);
+    tracker.Flush(&list);
+    tracker.Require(&texture, D3D12_RESOURCE_STATE_COPY_DEST);
+    CHECK(tracker.Flush(&list) == 2);
+    CHECK(BatchIs(list, 2, {
+        Transition(&texture, 0, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST),
+        Transition(&texture, 1, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COPY_DEST),
+    }));
+
+    // 之后重新按整个资源跟踪：一个 ALL_SUBRESOURCES 屏障
+    tracker.Require(&texture, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    CHECK(tracker.Flush(&list) == 1);
+    CHECK(BatchIs(list, 3, {
+        Transition(&texture, ALL, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE),
+    }));
+    for (UINT i = 0; i < 3; i++) {
+        CHECK(tracker.GetState(&texture, i) == D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    }
+
+    // 每个子资源分别转换到同一个状态之后，整个资源的要求同样只发一个屏障
+    for (UINT i = 0; i < 3; i++) {
+        tracker.Require(&texture, D3D12_RESOURCE_STATE_RENDER_TARGET, i);
+    }
+    CHECK(tracker.Flush(&list) == 3);
+    tracker.Require(&texture, D3D12_RESOURCE_STATE_COPY_SOURCE);
+    CHECK(tracker.Flush(&list) == 1);
+    CHECK(BatchIs(list, 5, {
+        Transition(&texture, ALL, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COPY_SOURCE),
+    }));
+}
+
+void TestUnregisterDropsPending()
+{
+    FakeGraphicsCommandList list(D3D12_COMMAND_LIST_TYPE_DIRECT);
+    FakeResource released;
+    FakeResource kept;
+    ResourceStateTracker tracker;
+    tracker.Register(&released, D3D12_RESOURCE_STATE_COMMON);
+    tracker.Register(&kept, D3D12_RESOURCE_STATE_COMMON);
+
+    tracker.Require(&released, D3D12_RESOURCE_STATE_COPY_DEST);
+    tracker.Alias(&released, &kept);
+    tracker.Require(&kept, D3D12_RESOURCE_STATE_COPY_DEST);
+    tracker.Unregister(&released);
+    CHECK(tracker.Flush(&list) == 1);
+    CHECK(BatchIs(list, 0, {
+        Transition(&kept, ALL, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST),
+    }));
+}
+}
+
+int main()
+{
+    RUN_TEST(TestMergeAndCancel);
+    RUN_TEST(TestSplitPromotedWhenNotStarted);
+    RUN_TEST(TestSplitAcrossFlush);
+    RUN_TEST(TestSubresourceCollapse);
+    RUN_TEST(TestUnregisterDropsPending);
+    return FinishTests();
+}
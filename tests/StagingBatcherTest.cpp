@@ -0,0 +1,182 @@
+// StagingBatcherTest.cpp
+#include "StagingBatcher.h"
+#include <cstring>
+#include <vector>
+#include "TestCommon.h"
+
+namespace {
+// CPU 内存里的暂存页，按顺序分配，页放不下时换下一页
+class TestAllocator : public IStagingAllocator {
+public:
+    explicit TestAllocator(uint64_t pageSize) : m_pageSize(pageSize) {}
+
+    StagingSpan Allocate(uint64_t size) override
+    {
+        if (m_pages.empty() || m_offset + size > m_pageSize) {
+            m_pages.emplace_back(m_pageSize);
+            m_offset = 0;
+        }
+        StagingSpan span;
+        span.page = static_cast<uint32_t>(m_pages.size() - 1);
+        span.offset = m_offset;
+        span.cpuAddress = m_pages.back().data() + m_offset;
+        m_offset += size;
+        return span;
+    }
+
+    // 按复制列表把暂存数据写进目标，模拟 GPU 按顺序执行复制
+    void Execute(const std::vector<StagingCopy>& copies, std::vector<uint8_t>& target, uint64_t destination) const
+    {
+        for (const StagingCopy& copy : copies) {
+            if (copy.destination == destination) {
+                std::memcpy(target.data() + copy.destinationOffset,
+                    m_pages[copy.stagingPage].data() + copy.stagingOffset, static_cast<size_t>(copy.size));
+            }
+        }
+    }
+
+private:
+    uint64_t m_pageSize;
+    std::vector<std::vector<uint8_t>> m_pages;
+    uint64_t m_offset = 0;
+};
+
+const uint64_t BUFFER_A = 0x1000;
+const uint64_t BUFFER_B = 0x2000;
+
+std::vector<uint8_t> Fill(uint8_t value, size_t size)
+{
+    return std::vector<uint8_t>(size, value);
+}
+
+void TestContiguousWritesMerge()
+{
+    // 乱序提交的 8 段首尾相接的写入：排序后按目标顺序写进暂存页，合并成一次复制
+    StagingBatcher batcher;
+    TestAllocator allocator(4096);
+    const uint32_t order[8] = { 5, 2, 7, 0, 3, 6, 1, 4 };
+    for (uint32_t index : order) {
+        const std::vector<uint8_t> data = Fill(static_cast<uint8_t>(index + 1), 16);
+        batcher.Add(BUFFER_A, index * 16ull, data.data(), data.size());
+    }
+    CHECK(batcher.GetPendingCount() == 8);
+    CHECK(batcher.GetPendingBytes() == 128);
+
+    const std::vector<StagingCopy>& copies = batcher.Build(allocator);
+    CHECK(copies.size() == 1);
+    CHECK(copies[0].destination == BUFFER_A && copies[0].destinationOffset == 0 && copies[0].size == 128);
+
+    std::vector<uint8_t> target(128, 0);
+    allocator.Execute(copies, target, BUFFER_A);
+    for (uint32_t i = 0; i < 8; i++) {
+        CHECK(target[i * 16] == i + 1 && target[i * 16 + 15] == i + 1);
+    }
+    CHECK(batcher.GetStats().requested == 8 && batcher.GetStats().emitted == 1);
+
+    // Clear 之后可以开始下一批
+    batcher.Clear();
+    CHECK(batcher.GetPendingCount() == 0 && batcher.GetPendingBytes() == 0);
+}
+
+void TestNoMergeAcrossStagingPages()
+{
+    // 目标连续，但每页只放得下两段：暂存内存在换页处断开，复制也在那里断开
+    StagingBatcher batcher;
+    TestAllocator allocator(32);
+    for (uint32_t i = 0; i < 4; i++) {
+        const std::vector<uint8_t> data = Fill(static_cast<uint8_t>(i + 1), 16);
+        batcher.Add(BUFFER_A, i * 16ull, data.data(), data.size());
+    }
+
+    const std::vector<StagingCopy>& copies = batcher.Build(allocator);
+    CHECK(copies.size() == 2);
+    CHECK(copies[0].stagingPage == 0 && copies[0].destinationOffset == 0 && copies[0].size == 32);
+    CHECK(copies[1].stagingPage == 1 && copies[1].destinationOffset == 32 && copies[1].size == 32);
+
+    std::vector<uint8_t> target(64, 0);
+    allocator.Execute(copies, target, BUFFER_A);
+    CHECK(target[0] == 1 && target[16] == 2 && target[32] == 3 && target[48] == 4);
+}
+
+void TestNoMergeAcrossDestinationGaps()
+{
+    // 同一目标上不相邻的区间各自一次复制
+    StagingBatcher batcher;
+    TestAllocator allocator(4096);
+    const std::vector<uint8_t> data = Fill(1, 16);
+    batcher.Add(BUFFER_A, 0, data.data(), data.size());
+    batcher.Add(BUFFER_A, 32, data.data(), data.size());
+
+    const std::vector<StagingCopy>& copies = batcher.Build(allocator);
+    CHECK(copies.size() == 2);
+    CHECK(copies[0].destinationOffset == 0 && copies[1].destinationOffset == 32);
+}
+
+void TestSeparateDestinations()
+{
+    // 两个缓冲区交替提交：按目标分组，每个缓冲区各合并成一次复制，不会跨目标合并
+    StagingBatcher batcher;
+    TestAllocator allocator(4096);
+    for (uint32_t i = 0; i < 8; i++) {
+        const std::vector<uint8_t> data = Fill(static_cast<uint8_t>(i), 8);
+        batcher.Add(i % 2 == 0 ? BUFFER_B : BUFFER_A, (i / 2) * 8ull, data.data(), data.size());
+    }
+
+    const std::vector<StagingCopy>& copies = batcher.Build(allocator);
+    CHECK(copies.size() == 2);
+    CHECK(copies[0].destination == BUFFER_A && copies[0].size == 32);
+    CHECK(copies[1].destination == BUFFER_B && copies[1].size == 32);
+
+    std::vector<uint8_t> a(32, 0xff);
+    std::vector<uint8_t> b(32, 0xff);
+    allocator.Execute(copies, a, BUFFER_A);
+    allocator.Execute(copies, b, BUFFER_B);
+    for (uint32_t i = 0; i < 4; i++) {
+        CHECK(a[i * 8] == i * 2 + 1);
+        CHECK(b[i * 8] == i * 2);
+    }
+}
+
+void TestOverlappingWritesKeepSubmissionOrder()
+{
+    // 后提交的写入覆盖先提交的，即使它的目标偏移更小
+    StagingBatcher batcher;
+    TestAllocator allocator(4096);
+    const std::vector<uint8_t> first = Fill(1, 32);
+    const std::vector<uint8_t> second = Fill(2, 32);
+    const std::vector<uint8_t> third = Fill(3, 8);
+    batcher.Add(BUFFER_A, 16, first.data(), first.size());
+    batcher.Add(BUFFER_A, 0, second.data(), second.size());
+    batcher.Add(BUFFER_A, 40, third.data(), third.size());
+
+    const std::vector<StagingCopy>& copies = batcher.Build(allocator);
+    CHECK(copies.size() == 3);
+    CHECK(copies[0].destinationOffset == 16 && copies[1].destinationOffset == 0 && copies[2].destinationOffset == 40);
+
+    std::vector<uint8_t> target(48, 0);
+    allocator.Execute(copies, target, BUFFER_A);
+    CHECK(target[0] == 2 && target[31] == 2);  // 第二次写入覆盖了第一次的前半段
+    CHECK(target[32] == 1 && target[39] == 1); // 第一次写入没被覆盖的部分
+    CHECK(target[40] == 3 && target[47] == 3); // 第三次写入覆盖了第一次的末尾
+}
+
+void TestEmptyWritesIgnored()
+{
+    StagingBatcher batcher;
+    TestAllocator allocator(4096);
+    batcher.Add(BUFFER_A, 0, nullptr, 0);
+    CHECK(batcher.GetPendingCount() == 0);
+    CHECK(batcher.Build(allocator).empty());
+}
+}
+
+int main()
+{
+    RUN_TEST(TestContiguousWritesMerge);
+    RUN_TEST(TestNoMergeAcrossStagingPages);
+    RUN_TEST(TestNoMergeAcrossDestinationGaps);
+    RUN_TEST(TestSeparateDestinations);
+    RUN_TEST(TestOverlappingWritesKeepSubmissionOrder);
+    RUN_TEST(TestEmptyWritesIgnored);
+    return FinishTests();
+}
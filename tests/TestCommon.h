@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdio>
+
+// 测试用的最小断言：失败时打印位置并计数，不中断后面的检查。
+// main 里用 FinishTests 的返回值作为进程退出码。
+inline int& TestFailureCount()
+{
+    static int count = 0;
+    return count;
+}
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);     \
+            TestFailureCount()++;                                                         \
+        }                                                                                 \
+    } while (0)
+
+#define RUN_TEST(test)                      \
+    do {                                    \
+        std::printf("[ RUN  ] %s\n", #test); \
+        test();                             \
+    } while (0)
+
+inline int FinishTests()
+{
+    if (TestFailureCount() > 0) {
+        std::printf("%d check(s) failed\n", TestFailureCount());
+        return 1;
+    }
+    std::printf("All checks passed\n");
+    return 0;
+}
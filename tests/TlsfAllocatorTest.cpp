@@ -0,0 +1,197 @@
+// TlsfAllocatorTest.cpp
+#include "TlsfAllocator.h"
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "TestCommon.h"
+
+namespace {
+const uint64_t KB = 1024;
+const uint64_t MB = 1024 * KB;
+
+bool IsAligned(uint64_t offset, uint64_t alignment)
+{
+    return (offset & (alignment - 1)) == 0;
+}
+
+void TestAllocateAndCoalesce()
+{
+    TlsfAllocator allocator(1 * MB);
+    TlsfAllocator::Allocation a = allocator.Allocate(100);
+    TlsfAllocator::Allocation b = allocator.Allocate(200);
+    TlsfAllocator::Allocation c = allocator.Allocate(300);
+    CHECK(a.IsValid() && b.IsValid() && c.IsValid());
+    CHECK(b.offset >= a.offset + a.size);
+    CHECK(c.offset >= b.offset + b.size);
+    CHECK(allocator.GetUsedBytes() == 600);
+
+    // 中间块释放后两边再释放，最后应该合并回一整块
+    allocator.Free(b);
+    allocator.Free(a);
+    allocator.Free(c);
+    const TlsfAllocator::Stats stats = allocator.GetStats();
+    CHECK(allocator.IsEmpty());
+    CHECK(stats.freeBlockCount == 1);
+    CHECK(stats.largestFreeBlock == 1 * MB);
+    CHECK(stats.fragmentation == 0.0);
+}
+
+void TestInvalidArguments()
+{
+    TlsfAllocator allocator(1 * MB);
+    CHECK(!allocator.Allocate(0).IsValid());
+    CHECK(!allocator.Allocate(64, 3).IsValid());
+    CHECK(!allocator.Allocate(2 * MB).IsValid());
+    CHECK(!allocator.Allocate(UINT64_MAX, 64 * KB).IsValid());
+
+    TlsfAllocator::Allocation a = allocator.Allocate(64);
+    allocator.Free(a);
+    bool threw = false;
+    try {
+        allocator.Free(a);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+void TestAlignedHoleReuse()
+{
+    // 释放掉的 64KB 对齐空洞要能放下同样大小、同样对齐的缓冲区
+    TlsfAllocator allocator(1 * MB);
+    std::vector<TlsfAllocator::Allocation> allocations;
+    for (;;) {
+        TlsfAllocator::Allocation allocation = allocator.Allocate(64 * KB, 64 * KB);
+        if (!allocation.IsValid()) {
+            break;
+        }
+        allocations.push_back(allocation);
+    }
+    CHECK(allocations.size() == 16);
+
+    // 只留下中间一个空洞
+    const uint64_t hole = allocations[5].offset;
+    allocator.Free(allocations[5]);
+    TlsfAllocator::Allocation reused = allocator.Allocate(64 * KB, 64 * KB);
+    CHECK(reused.IsValid());
+    CHECK(reused.offset == hole);
+    CHECK(allocator.GetUsedBytes() == allocator.GetCapacity());
+}
+
+void TestAlignedFillUsesWholeHeap()
+{
+    // 64MB 的堆正好放下 1024 个 64KB 对齐的缓冲区
+    TlsfAllocator allocator(64 * MB);
+    std::vector<TlsfAllocator::Allocation> allocations;
+    for (uint32_t i = 0; i < 1024; i++) {
+        TlsfAllocator::Allocation allocation = allocator.Allocate(64 * KB, 64 * KB);
+        CHECK(allocation.IsValid());
+        CHECK(IsAligned(allocation.offset, 64 * KB));
+        allocations.push_back(allocation);
+    }
+    CHECK(!allocator.Allocate(64 * KB, 64 * KB).IsValid());
+    CHECK(allocator.GetUsedBytes() == 64 * MB);
+
+    // 每隔一个释放，再按同样的大小填回去
+    for (size_t i = 0; i < allocations.size(); i += 2) {
+        allocator.Free(allocations[i]);
+    }
+    for (size_t i = 0; i < allocations.size(); i += 2) {
+        allocations[i] = allocator.Allocate(64 * KB, 64 * KB);
+        CHECK(allocations[i].IsValid());
+    }
+    CHECK(allocator.GetUsedBytes() == 64 * MB);
+}
+
+void TestDedicatedHeapFit()
+{
+    // 大资源单独占的堆大小就是向上取整到对齐后的大小，必须能分配成功
+    const uint64_t sizes[] = { 64 * KB, 65 * MB, 100 * MB + 64 * KB, 256 * MB };
+    for (uint64_t size : sizes) {
+        const uint64_t capacity = (size + 64 * KB - 1) / (64 * KB) * (64 * KB);
+        TlsfAllocator allocator(capacity);
+        TlsfAllocator::Allocation allocation = allocator.Allocate(size, 64 * KB);
+        CHECK(allocation.IsValid());
+        CHECK(allocation.offset == 0);
+    }
+
+    TlsfAllocator msaa(8 * MB);
+    CHECK(msaa.Allocate(8 * MB, 4 * MB).IsValid());
+}
+
+void TestUnalignedPrefix()
+{
+    // 开头有一段没对齐的占用时，前面的空隙放回空闲表，后面的对齐块照常可用
+    TlsfAllocator allocator(1 * MB);
+    TlsfAllocator::Allocation small = allocator.Allocate(100);
+    CHECK(small.IsValid());
+    uint32_t count = 0;
+    for (;;) {
+        TlsfAllocator::Allocation allocation = allocator.Allocate(64 * KB, 64 * KB);
+        if (!allocation.IsValid()) {
+            break;
+        }
+        CHECK(IsAligned(allocation.offset, 64 * KB));
+        count++;
+    }
+    CHECK(count == 15);
+    // 第一块里剩下的空隙还能分配小块
+    CHECK(allocator.Allocate(64 * KB - 100).IsValid());
+    CHECK(allocator.GetUsedBytes() == allocator.GetCapacity());
+}
+
+void TestRandomized()
+{
+    // 随机分配和释放，检查对齐、不重叠和字节统计
+    TlsfAllocator allocator(16 * MB);
+    std::mt19937 random(12345);
+    std::vector<TlsfAllocator::Allocation> live;
+    uint64_t usedBytes = 0;
+    for (uint32_t i = 0; i < 20000; i++) {
+        if (live.empty() || random() % 3 != 0) {
+            const uint64_t size = 1 + random() % (256 * KB);
+            const uint64_t alignment = 1ull << (random() % 17);
+            TlsfAllocator::Allocation allocation = allocator.Allocate(size, alignment);
+            if (allocation.IsValid()) {
+                CHECK(IsAligned(allocation.offset, alignment));
+                CHECK(allocation.offset + allocation.size <= allocator.GetCapacity());
+                live.push_back(allocation);
+                usedBytes += size;
+            }
+        } else {
+            const size_t index = random() % live.size();
+            usedBytes -= live[index].size;
+            allocator.Free(live[index]);
+            live[index] = live.back();
+            live.pop_back();
+        }
+        CHECK(allocator.GetUsedBytes() == usedBytes);
+    }
+
+    std::sort(live.begin(), live.end(), [](const TlsfAllocator::Allocation& a, const TlsfAllocator::Allocation& b) {
+        return a.offset < b.offset;
+    });
+    for (size_t i = 1; i < live.size(); i++) {
+        CHECK(live[i - 1].offset + live[i - 1].size <= live[i].offset);
+    }
+
+    for (const TlsfAllocator::Allocation& allocation : live) {
+        allocator.Free(allocation);
+    }
+    CHECK(allocator.IsEmpty());
+    CHECK(allocator.GetStats().largestFreeBlock == allocator.GetCapacity());
+}
+}
+
+int main()
+{
+    RUN_TEST(TestAllocateAndCoalesce);
+    RUN_TEST(TestInvalidArguments);
+    RUN_TEST(TestAlignedHoleReuse);
+    RUN_TEST(TestAlignedFillUsesWholeHeap);
+    RUN_TEST(TestDedicatedHeapFit);
+    RUN_TEST(TestUnalignedPrefix);
+    RUN_TEST(TestRandomized);
+    return FinishTests();
+}
@@ -0,0 +1,486 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// 无 Windows SDK 时给测试和基准用的最小 d3d12.h：只声明无 GPU 目标实际用到的类型、字段和方法，
+// 名字和签名与真正的头文件一致，被测模块的源码不用改。接口都是纯虚的，由测试里的模拟对象实现。
+// 只加到不碰真正设备的目标的包含路径里，在所有平台上都替换系统的 d3d12.h。
+
+typedef int32_t HRESULT;
+typedef uint32_t UINT;
+typedef int32_t INT;
+typedef int32_t BOOL;
+typedef uint8_t UINT8;
+typedef uint16_t UINT16;
+typedef uint64_t UINT64;
+typedef unsigned long ULONG;
+typedef size_t SIZE_T;
+typedef float FLOAT;
+typedef const wchar_t* LPCWSTR;
+
+struct GUID {
+    uint32_t Data1;
+    uint16_t Data2;
+    uint16_t Data3;
+    uint8_t Data4[8];
+};
+typedef GUID IID;
+typedef const IID& REFIID;
+typedef const GUID& REFGUID;
+
+inline bool operator==(REFGUID a, REFGUID b)
+{
+    return a.Data1 == b.Data1 && a.Data2 == b.Data2 && a.Data3 == b.Data3 &&
+        a.Data4[0] == b.Data4[0] && a.Data4[1] == b.Data4[1] && a.Data4[2] == b.Data4[2] && a.Data4[3] == b.Data4[3] &&
+        a.Data4[4] == b.Data4[4] && a.Data4[5] == b.Data4[5] && a.Data4[6] == b.Data4[6] && a.Data4[7] == b.Data4[7];
+}
+inline bool operator!=(REFGUID a, REFGUID b) { return !(a == b); }
+
+#define S_OK ((HRESULT)0L)
+#define E_NOTIMPL ((HRESULT)0x80004001L)
+#define E_NOINTERFACE ((HRESULT)0x80004002L)
+#define E_POINTER ((HRESULT)0x80004003L)
+#define E_FAIL ((HRESULT)0x80004005L)
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
+#define STDMETHODCALLTYPE
+#define TRUE 1
+#define FALSE 0
+
+// 模拟对象不按 IID 区分接口，传一个空 IID
+#define IID_PPV_ARGS(ppType) IID{}, reinterpret_cast<void**>(ppType)
+#define __uuidof(type) IID{}
+
+enum DXGI_FORMAT {
+    DXGI_FORMAT_UNKNOWN = 0,
+    DXGI_FORMAT_R32G32B32A32_FLOAT = 2,
+    DXGI_FORMAT_R32G32B32_FLOAT = 6,
+    DXGI_FORMAT_R8G8B8A8_UNORM = 28,
+    DXGI_FORMAT_D32_FLOAT = 40,
+    DXGI_FORMAT_R32_UINT = 42,
+    DXGI_FORMAT_R16_UINT = 57,
+};
+
+struct DXGI_SAMPLE_DESC {
+    UINT Count;
+    UINT Quality;
+};
+
+#define D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT 8
+
+class IUnknown {
+public:
+    virtual HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) = 0;
+    virtual ULONG STDMETHODCALLTYPE AddRef() = 0;
+    virtual ULONG STDMETHODCALLTYPE Release() = 0;
+
+protected:
+    ~IUnknown() = default;
+};
+
+class ID3D12Object : public IUnknown {
+public:
+    virtual HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID guid, const IUnknown* data) = 0;
+
+protected:
+    ~ID3D12Object() = default;
+};
+
+class ID3D12DeviceChild : public ID3D12Object {
+protected:
+    ~ID3D12DeviceChild() = default;
+};
+
+class ID3D12Pageable : public ID3D12DeviceChild {
+protected:
+    ~ID3D12Pageable() = default;
+};
+
+class ID3D12RootSignature : public ID3D12DeviceChild {
+protected:
+    ~ID3D12RootSignature() = default;
+};
+
+class ID3D12PipelineState : public ID3D12Pageable {
+protected:
+    ~ID3D12PipelineState() = default;
+};
+
+// ---- 图形 PSO 描述 ----
+
+struct D3D12_SHADER_BYTECODE {
+    const void* pShaderBytecode;
+    SIZE_T BytecodeLength;
+};
+
+struct D3D12_SO_DECLARATION_ENTRY {
+    UINT Stream;
+    const char* SemanticName;
+    UINT SemanticIndex;
+    UINT8 StartComponent;
+    UINT8 ComponentCount;
+    UINT8 OutputSlot;
+};
+
+struct D3D12_STREAM_OUTPUT_DESC {
+    const D3D12_SO_DECLARATION_ENTRY* pSODeclaration;
+    UINT NumEntries;
+    const UINT* pBufferStrides;
+    UINT NumStrides;
+    UINT RasterizedStream;
+};
+
+enum D3D12_BLEND { D3D12_BLEND_ZERO = 1, D3D12_BLEND_ONE = 2 };
+enum D3D12_BLEND_OP { D3D12_BLEND_OP_ADD = 1 };
+enum D3D12_LOGIC_OP { D3D12_LOGIC_OP_CLEAR = 0, D3D12_LOGIC_OP_NOOP = 4 };
+
+struct D3D12_RENDER_TARGET_BLEND_DESC {
+    BOOL BlendEnable;
+    BOOL LogicOpEnable;
+    D3D12_BLEND SrcBlend;
+    D3D12_BLEND DestBlend;
+    D3D12_BLEND_OP BlendOp;
+    D3D12_BLEND SrcBlendAlpha;
+    D3D12_BLEND DestBlendAlpha;
+    D3D12_BLEND_OP BlendOpAlpha;
+    D3D12_LOGIC_OP LogicOp;
+    UINT8 RenderTargetWriteMask;
+};
+
+struct D3D12_BLEND_DESC {
+    BOOL AlphaToCoverageEnable;
+    BOOL IndependentBlendEnable;
+    D3D12_RENDER_TARGET_BLEND_DESC RenderTarget[8];
+};
+
+enum D3D12_FILL_MODE { D3D12_FILL_MODE_WIREFRAME = 2, D3D12_FILL_MODE_SOLID = 3 };
+enum D3D12_CULL_MODE { D3D12_CULL_MODE_NONE = 1, D3D12_CULL_MODE_FRONT = 2, D3D12_CULL_MODE_BACK = 3 };
+enum D3D12_CONSERVATIVE_RASTERIZATION_MODE {
+    D3D12_CONSERVATIVE_RASTERIZATION_MODE_OFF = 0,
+    D3D12_CONSERVATIVE_RASTERIZATION_MODE_ON = 1,
+};
+
+struct D3D12_RASTERIZER_DESC {
+    D3D12_FILL_MODE FillMode;
+    D3D12_CULL_MODE CullMode;
+    BOOL FrontCounterClockwise;
+    INT DepthBias;
+    FLOAT DepthBiasClamp;
+    FLOAT SlopeScaledDepthBias;
+    BOOL DepthClipEnable;
+    BOOL MultisampleEnable;
+    BOOL AntialiasedLineEnable;
+    UINT ForcedSampleCount;
+    D3D12_CONSERVATIVE_RASTERIZATION_MODE ConservativeRaster;
+};
+
+enum D3D12_DEPTH_WRITE_MASK { D3D12_DEPTH_WRITE_MASK_ZERO = 0, D3D12_DEPTH_WRITE_MASK_ALL = 1 };
+enum D3D12_COMPARISON_FUNC { D3D12_COMPARISON_FUNC_NEVER = 1, D3D12_COMPARISON_FUNC_LESS = 2, D3D12_COMPARISON_FUNC_ALWAYS = 8 };
+enum D3D12_STENCIL_OP { D3D12_STENCIL_OP_KEEP = 1 };
+
+struct D3D12_DEPTH_STENCILOP_DESC {
+    D3D12_STENCIL_OP StencilFailOp;
+    D3D12_STENCIL_OP StencilDepthFailOp;
+    D3D12_STENCIL_OP StencilPassOp;
+    D3D12_COMPARISON_FUNC StencilFunc;
+};
+
+struct D3D12_DEPTH_STENCIL_DESC {
+    BOOL DepthEnable;
+    D3D12_DEPTH_WRITE_MASK DepthWriteMask;
+    D3D12_COMPARISON_FUNC DepthFunc;
+    BOOL StencilEnable;
+    UINT8 StencilReadMask;
+    UINT8 StencilWriteMask;
+    D3D12_DEPTH_STENCILOP_DESC FrontFace;
+    D3D12_DEPTH_STENCILOP_DESC BackFace;
+};
+
+enum D3D12_INPUT_CLASSIFICATION {
+    D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA = 0,
+    D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA = 1,
+};
+
+struct D3D12_INPUT_ELEMENT_DESC {
+    const char* SemanticName;
+    UINT SemanticIndex;
+    DXGI_FORMAT Format;
+    UINT InputSlot;
+    UINT AlignedByteOffset;
+    D3D12_INPUT_CLASSIFICATION InputSlotClass;
+    UINT InstanceDataStepRate;
+};
+
+struct D3D12_INPUT_LAYOUT_DESC {
+    const D3D12_INPUT_ELEMENT_DESC* pInputElementDescs;
+    UINT NumElements;
+};
+
+enum D3D12_INDEX_BUFFER_STRIP_CUT_VALUE { D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_DISABLED = 0 };
+
+enum D3D12_PRIMITIVE_TOPOLOGY_TYPE {
+    D3D12_PRIMITIVE_TOPOLOGY_TYPE_UNDEFINED = 0,
+    D3D12_PRIMITIVE_TOPOLOGY_TYPE_POINT = 1,
+    D3D12_PRIMITIVE_TOPOLOGY_TYPE_LINE = 2,
+    D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE = 3,
+};
+
+struct D3D12_CACHED_PIPELINE_STATE {
+    const void* pCachedBlob;
+    SIZE_T CachedBlobSizeInBytes;
+};
+
+enum D3D12_PIPELINE_STATE_FLAGS { D3D12_PIPELINE_STATE_FLAG_NONE = 0 };
+
+struct D3D12_GRAPHICS_PIPELINE_STATE_DESC {
+    ID3D12RootSignature* pRootSignature;
+    D3D12_SHADER_BYTECODE VS;
+    D3D12_SHADER_BYTECODE PS;
+    D3D12_SHADER_BYTECODE DS;
+    D3D12_SHADER_BYTECODE HS;
+    D3D12_SHADER_BYTECODE GS;
+    D3D12_STREAM_OUTPUT_DESC StreamOutput;
+    D3D12_BLEND_DESC BlendState;
+    UINT SampleMask;
+    D3D12_RASTERIZER_DESC RasterizerState;
+    D3D12_DEPTH_STENCIL_DESC DepthStencilState;
+    D3D12_INPUT_LAYOUT_DESC InputLayout;
+    D3D12_INDEX_BUFFER_STRIP_CUT_VALUE IBStripCutValue;
+    D3D12_PRIMITIVE_TOPOLOGY_TYPE PrimitiveTopologyType;
+    UINT NumRenderTargets;
+    DXGI_FORMAT RTVFormats[8];
+    DXGI_FORMAT DSVFormat;
+    DXGI_SAMPLE_DESC SampleDesc;
+    UINT NodeMask;
+    D3D12_CACHED_PIPELINE_STATE CachedPSO;
+    D3D12_PIPELINE_STATE_FLAGS Flags;
+};
+
+// ---- 资源和屏障 ----
+
+// 真正的头文件用 DEFINE_ENUM_FLAG_OPERATORS 给标志枚举定义位运算
+#define DEFINE_ENUM_FLAG_OPERATORS(ENUMTYPE)                                                                   \
+    inline constexpr ENUMTYPE operator|(ENUMTYPE a, ENUMTYPE b) { return ENUMTYPE(int(a) | int(b)); }          \
+    inline constexpr ENUMTYPE operator&(ENUMTYPE a, ENUMTYPE b) { return ENUMTYPE(int(a) & int(b)); }          \
+    inline constexpr ENUMTYPE operator^(ENUMTYPE a, ENUMTYPE b) { return ENUMTYPE(int(a) ^ int(b)); }          \
+    inline constexpr ENUMTYPE operator~(ENUMTYPE a) { return ENUMTYPE(~int(a)); }                              \
+    inline ENUMTYPE& operator|=(ENUMTYPE& a, ENUMTYPE b) { return a = a | b; }                                 \
+    inline ENUMTYPE& operator&=(ENUMTYPE& a, ENUMTYPE b) { return a = a & b; }
+
+enum D3D12_RESOURCE_STATES {
+    D3D12_RESOURCE_STATE_COMMON = 0,
+    D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER = 0x1,
+    D3D12_RESOURCE_STATE_INDEX_BUFFER = 0x2,
+    D3D12_RESOURCE_STATE_RENDER_TARGET = 0x4,
+    D3D12_RESOURCE_STATE_UNORDERED_ACCESS = 0x8,
+    D3D12_RESOURCE_STATE_DEPTH_WRITE = 0x10,
+    D3D12_RESOURCE_STATE_DEPTH_READ = 0x20,
+    D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE = 0x40,
+    D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE = 0x80,
+    D3D12_RESOURCE_STATE_STREAM_OUT = 0x100,
+    D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT = 0x200,
+    D3D12_RESOURCE_STATE_COPY_DEST = 0x400,
+    D3D12_RESOURCE_STATE_COPY_SOURCE = 0x800,
+    D3D12_RESOURCE_STATE_GENERIC_READ = 0xac3,
+    D3D12_RESOURCE_STATE_PRESENT = 0,
+};
+DEFINE_ENUM_FLAG_OPERATORS(D3D12_RESOURCE_STATES)
+
+class ID3D12Resource : public ID3D12Pageable {
+protected:
+    ~ID3D12Resource() = default;
+};
+
+class ID3D12Heap : public ID3D12Pageable {
+protected:
+    ~ID3D12Heap() = default;
+};
+
+enum D3D12_HEAP_TYPE {
+    D3D12_HEAP_TYPE_DEFAULT = 1,
+    D3D12_HEAP_TYPE_UPLOAD = 2,
+    D3D12_HEAP_TYPE_READBACK = 3,
+    D3D12_HEAP_TYPE_CUSTOM = 4,
+};
+
+enum D3D12_CPU_PAGE_PROPERTY { D3D12_CPU_PAGE_PROPERTY_UNKNOWN = 0 };
+enum D3D12_MEMORY_POOL { D3D12_MEMORY_POOL_UNKNOWN = 0 };
+
+struct D3D12_HEAP_PROPERTIES {
+    D3D12_HEAP_TYPE Type;
+    D3D12_CPU_PAGE_PROPERTY CPUPageProperty;
+    D3D12_MEMORY_POOL MemoryPoolPreference;
+    UINT CreationNodeMask;
+    UINT VisibleNodeMask;
+};
+
+enum D3D12_HEAP_FLAGS {
+    D3D12_HEAP_FLAG_NONE = 0,
+    D3D12_HEAP_FLAG_DENY_BUFFERS = 0x4,
+    D3D12_HEAP_FLAG_DENY_RT_DS_TEXTURES = 0x40,
+    D3D12_HEAP_FLAG_DENY_NON_RT_DS_TEXTURES = 0x80,
+    D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES = 0,
+    D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS = 0xc0,
+};
+DEFINE_ENUM_FLAG_OPERATORS(D3D12_HEAP_FLAGS)
+
+struct D3D12_HEAP_DESC {
+    UINT64 SizeInBytes;
+    D3D12_HEAP_PROPERTIES Properties;
+    UINT64 Alignment;
+    D3D12_HEAP_FLAGS Flags;
+};
+
+enum D3D12_RESOURCE_DIMENSION {
+    D3D12_RESOURCE_DIMENSION_UNKNOWN = 0,
+    D3D12_RESOURCE_DIMENSION_BUFFER = 1,
+    D3D12_RESOURCE_DIMENSION_TEXTURE1D = 2,
+    D3D12_RESOURCE_DIMENSION_TEXTURE2D = 3,
+    D3D12_RESOURCE_DIMENSION_TEXTURE3D = 4,
+};
+
+enum D3D12_TEXTURE_LAYOUT { D3D12_TEXTURE_LAYOUT_UNKNOWN = 0, D3D12_TEXTURE_LAYOUT_ROW_MAJOR = 1 };
+
+enum D3D12_RESOURCE_FLAGS {
+    D3D12_RESOURCE_FLAG_NONE = 0,
+    D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET = 0x1,
+    D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL = 0x2,
+    D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS = 0x4,
+};
+DEFINE_ENUM_FLAG_OPERATORS(D3D12_RESOURCE_FLAGS)
+
+struct D3D12_RESOURCE_DESC {
+    D3D12_RESOURCE_DIMENSION Dimension;
+    UINT64 Alignment;
+    UINT64 Width;
+    UINT Height;
+    UINT16 DepthOrArraySize;
+    UINT16 MipLevels;
+    DXGI_FORMAT Format;
+    DXGI_SAMPLE_DESC SampleDesc;
+    D3D12_TEXTURE_LAYOUT Layout;
+    D3D12_RESOURCE_FLAGS Flags;
+};
+
+struct D3D12_DEPTH_STENCIL_VALUE {
+    FLOAT Depth;
+    UINT8 Stencil;
+};
+
+struct D3D12_CLEAR_VALUE {
+    DXGI_FORMAT Format;
+    union {
+        FLOAT Color[4];
+        D3D12_DEPTH_STENCIL_VALUE DepthStencil;
+    };
+};
+
+struct D3D12_RESOURCE_ALLOCATION_INFO {
+    UINT64 SizeInBytes;
+    UINT64 Alignment;
+};
+
+#define D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT 65536
+
+enum D3D12_RESOURCE_BARRIER_TYPE {
+    D3D12_RESOURCE_BARRIER_TYPE_TRANSITION = 0,
+    D3D12_RESOURCE_BARRIER_TYPE_ALIASING = 1,
+    D3D12_RESOURCE_BARRIER_TYPE_UAV = 2,
+};
+
+enum D3D12_RESOURCE_BARRIER_FLAGS {
+    D3D12_RESOURCE_BARRIER_FLAG_NONE = 0,
+    D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY = 0x1,
+    D3D12_RESOURCE_BARRIER_FLAG_END_ONLY = 0x2,
+};
+DEFINE_ENUM_FLAG_OPERATORS(D3D12_RESOURCE_BARRIER_FLAGS)
+
+#define D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES 0xffffffff
+
+struct D3D12_RESOURCE_TRANSITION_BARRIER {
+    ID3D12Resource* pResource;
+    UINT Subresource;
+    D3D12_RESOURCE_STATES StateBefore;
+    D3D12_RESOURCE_STATES StateAfter;
+};
+
+struct D3D12_RESOURCE_ALIASING_BARRIER {
+    ID3D12Resource* pResourceBefore;
+    ID3D12Resource* pResourceAfter;
+};
+
+struct D3D12_RESOURCE_UAV_BARRIER {
+    ID3D12Resource* pResource;
+};
+
+struct D3D12_RESOURCE_BARRIER {
+    D3D12_RESOURCE_BARRIER_TYPE Type;
+    D3D12_RESOURCE_BARRIER_FLAGS Flags;
+    union {
+        D3D12_RESOURCE_TRANSITION_BARRIER Transition;
+        D3D12_RESOURCE_ALIASING_BARRIER Aliasing;
+        D3D12_RESOURCE_UAV_BARRIER UAV;
+    };
+};
+
+// ---- 命令列表 ----
+
+enum D3D12_COMMAND_LIST_TYPE {
+    D3D12_COMMAND_LIST_TYPE_DIRECT = 0,
+    D3D12_COMMAND_LIST_TYPE_BUNDLE = 1,
+    D3D12_COMMAND_LIST_TYPE_COMPUTE = 2,
+    D3D12_COMMAND_LIST_TYPE_COPY = 3,
+};
+
+class ID3D12CommandAllocator : public ID3D12Pageable {
+public:
+    virtual HRESULT STDMETHODCALLTYPE Reset() = 0;
+
+protected:
+    ~ID3D12CommandAllocator() = default;
+};
+
+class ID3D12CommandList : public ID3D12DeviceChild {
+public:
+    virtual D3D12_COMMAND_LIST_TYPE STDMETHODCALLTYPE GetType() = 0;
+
+protected:
+    ~ID3D12CommandList() = default;
+};
+
+class ID3D12GraphicsCommandList : public ID3D12CommandList {
+public:
+    virtual HRESULT STDMETHODCALLTYPE Close() = 0;
+    virtual HRESULT STDMETHODCALLTYPE Reset(ID3D12CommandAllocator* allocator, ID3D12PipelineState* initialState) = 0;
+    virtual void STDMETHODCALLTYPE DrawInstanced(
+        UINT vertexCountPerInstance, UINT instanceCount, UINT startVertexLocation, UINT startInstanceLocation) = 0;
+    virtual void STDMETHODCALLTYPE SetGraphicsRoot32BitConstants(
+        UINT rootParameterIndex, UINT num32BitValuesToSet, const void* srcData, UINT destOffsetIn32BitValues) = 0;
+    virtual void STDMETHODCALLTYPE ResourceBarrier(UINT numBarriers, const D3D12_RESOURCE_BARRIER* barriers) = 0;
+
+protected:
+    ~ID3D12GraphicsCommandList() = default;
+};
+
+// ---- 设备 ----
+
+class ID3D12Device : public ID3D12Object {
+public:
+    virtual HRESULT STDMETHODCALLTYPE CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE type, REFIID riid, void** commandAllocator) = 0;
+    virtual HRESULT STDMETHODCALLTYPE CreateCommandList(UINT nodeMask, D3D12_COMMAND_LIST_TYPE type,
+        ID3D12CommandAllocator* commandAllocator, ID3D12PipelineState* initialState, REFIID riid, void** commandList) = 0;
+    virtual HRESULT STDMETHODCALLTYPE CreateGraphicsPipelineState(
+        const D3D12_GRAPHICS_PIPELINE_STATE_DESC* desc, REFIID riid, void** pipelineState) = 0;
+    virtual D3D12_RESOURCE_ALLOCATION_INFO STDMETHODCALLTYPE GetResourceAllocationInfo(
+        UINT visibleMask, UINT numResourceDescs, const D3D12_RESOURCE_DESC* resourceDescs) = 0;
+    virtual HRESULT STDMETHODCALLTYPE CreateCommittedResource(const D3D12_HEAP_PROPERTIES* heapProperties, D3D12_HEAP_FLAGS heapFlags,
+        const D3D12_RESOURCE_DESC* desc, D3D12_RESOURCE_STATES initialState, const D3D12_CLEAR_VALUE* optimizedClearValue,
+        REFIID riid, void** resource) = 0;
+    virtual HRESULT STDMETHODCALLTYPE CreateHeap(const D3D12_HEAP_DESC* desc, REFIID riid, void** heap) = 0;
+    virtual HRESULT STDMETHODCALLTYPE CreatePlacedResource(ID3D12Heap* heap, UINT64 heapOffset,
+        const D3D12_RESOURCE_DESC* desc, D3D12_RESOURCE_STATES initialState, const D3D12_CLEAR_VALUE* optimizedClearValue,
+        REFIID riid, void** resource) = 0;
+
+protected:
+    ~ID3D12Device() = default;
+};
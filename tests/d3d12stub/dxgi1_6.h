@@ -0,0 +1,24 @@
+#pragma once
+#include <d3d12.h>
+
+// 配合 d3d12stub/d3d12.h 的最小 dxgi1_6.h：只有显存预算查询用到的适配器接口
+enum DXGI_MEMORY_SEGMENT_GROUP {
+    DXGI_MEMORY_SEGMENT_GROUP_LOCAL = 0,
+    DXGI_MEMORY_SEGMENT_GROUP_NON_LOCAL = 1,
+};
+
+struct DXGI_QUERY_VIDEO_MEMORY_INFO {
+    UINT64 Budget;
+    UINT64 CurrentUsage;
+    UINT64 AvailableForReservation;
+    UINT64 CurrentReservation;
+};
+
+class IDXGIAdapter3 : public IUnknown {
+public:
+    virtual HRESULT STDMETHODCALLTYPE QueryVideoMemoryInfo(
+        UINT nodeIndex, DXGI_MEMORY_SEGMENT_GROUP memorySegmentGroup, DXGI_QUERY_VIDEO_MEMORY_INFO* videoMemoryInfo) = 0;
+
+protected:
+    ~IDXGIAdapter3() = default;
+};
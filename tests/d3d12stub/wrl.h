@@ -0,0 +1,89 @@
+#pragma once
+#include <utility>
+
+// 配合 d3d12stub/d3d12.h 的最小 ComPtr：只实现被测模块用到的部分，语义与 WRL 相同
+// （赋值和拷贝时 AddRef，析构和覆盖时 Release，operator& 先释放再取地址）
+namespace Microsoft {
+namespace WRL {
+
+template <typename T>
+class ComPtr {
+public:
+    ComPtr() = default;
+    ComPtr(decltype(nullptr)) {}
+    ComPtr(T* pointer) : m_pointer(pointer) { InternalAddRef(); }
+    ComPtr(const ComPtr& other) : m_pointer(other.m_pointer) { InternalAddRef(); }
+    ComPtr(ComPtr&& other) noexcept : m_pointer(other.m_pointer) { other.m_pointer = nullptr; }
+    ~ComPtr() { InternalRelease(); }
+
+    ComPtr& operator=(T* pointer)
+    {
+        ComPtr(pointer).Swap(*this);
+        return *this;
+    }
+
+    ComPtr& operator=(const ComPtr& other)
+    {
+        ComPtr(other).Swap(*this);
+        return *this;
+    }
+
+    ComPtr& operator=(ComPtr&& other) noexcept
+    {
+        ComPtr(std::move(other)).Swap(*this);
+        return *this;
+    }
+
+    T* Get() const { return m_pointer; }
+    T* operator->() const { return m_pointer; }
+    explicit operator bool() const { return m_pointer != nullptr; }
+
+    T** operator&() { return ReleaseAndGetAddressOf(); }
+    T** GetAddressOf() { return &m_pointer; }
+    T* const* GetAddressOf() const { return &m_pointer; }
+
+    T** ReleaseAndGetAddressOf()
+    {
+        InternalRelease();
+        return &m_pointer;
+    }
+
+    void Reset() { InternalRelease(); }
+
+    T* Detach()
+    {
+        T* pointer = m_pointer;
+        m_pointer = nullptr;
+        return pointer;
+    }
+
+    void Attach(T* pointer)
+    {
+        InternalRelease();
+        m_pointer = pointer;
+    }
+
+    void Swap(ComPtr& other) { std::swap(m_pointer, other.m_pointer); }
+
+private:
+    void InternalAddRef()
+    {
+        if (m_pointer) {
+            m_pointer->AddRef();
+        }
+    }
+
+    void InternalRelease()
+    {
+        T* pointer = m_pointer;
+        if (pointer) {
+            m_pointer = nullptr;
+            pointer->Release();
+        }
+    }
+
+    T* m_pointer = nullptr;
+};
+
+}
+}